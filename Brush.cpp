@@ -10,6 +10,7 @@
 
 #include "Common.hpp"
 #include "Brush.hpp"
+#include "GDICache.hpp"
 
 /******************************************************************************
 ** Method:		Constructor.
@@ -26,12 +27,14 @@
 CBrush::CBrush()
 	: m_hBrush(NULL)
 	, m_bOwner(false)
+	, m_bShared(false)
 {
 }
 
 CBrush::CBrush(int iID)
 	: m_hBrush()
 	, m_bOwner()
+	, m_bShared()
 {
 	Create(iID);
 }
@@ -39,6 +42,7 @@ CBrush::CBrush(int iID)
 CBrush::CBrush(COLORREF crClr)
 	: m_hBrush()
 	, m_bOwner()
+	, m_bShared()
 {
 	Create(crClr);
 }
@@ -46,6 +50,7 @@ CBrush::CBrush(COLORREF crClr)
 CBrush::CBrush(HBRUSH hBrush, bool bOwn)
 	: m_hBrush()
 	, m_bOwner()
+	, m_bShared()
 {
 	m_hBrush = hBrush;
 	m_bOwner = bOwn;
@@ -67,13 +72,13 @@ CBrush::CBrush(HBRUSH hBrush, bool bOwn)
 
 CBrush::~CBrush()
 {
-	// Delete if valid and we own it.
-	if ( (m_hBrush) && (m_bOwner) )
-		::DeleteObject(m_hBrush);
+	Release();
 }
 
 void CBrush::Create(int iID)
 {
+	Release();
+
 	m_hBrush = GetStockBrush(iID);
 	m_bOwner = false;
 
@@ -82,8 +87,61 @@ void CBrush::Create(int iID)
 
 void CBrush::Create(COLORREF crClr)
 {
+	Release();
+
 	m_hBrush = ::CreateSolidBrush(crClr);
 	m_bOwner = true;
 
 	ASSERT(m_hBrush != NULL);
 }
+
+/******************************************************************************
+** Method:		CreateShared()
+**
+** Description:	Acquire the brush from the process-wide GDI object cache. Objects
+**				with the same definition share the same handle, which is
+**				released back to the cache.
+**
+** Parameters:	crClr	The brush colour.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CBrush::CreateShared(COLORREF crClr)
+{
+	Release();
+
+	m_hBrush  = WCL::GDICache::instance().acquireBrush(crClr);
+	m_bShared = true;
+
+	ASSERT(m_hBrush != NULL);
+}
+
+/******************************************************************************
+** Method:		Release()
+**
+** Description:	Releases the resources by destroying it, if we're the owner,
+**				or returning it to the cache, if it's shared.
+**
+** Parameters:	None.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CBrush::Release()
+{
+	// Free resource, if the owner.
+	if ( (m_hBrush != NULL) && (m_bOwner) )
+		::DeleteObject(m_hBrush);
+	else if ( (m_hBrush != NULL) && (m_bShared) )
+		WCL::GDICache::instance().release(m_hBrush);
+
+	// Reset state.
+	m_hBrush  = NULL;
+	m_bOwner  = false;
+	m_bShared = false;
+}
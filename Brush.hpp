@@ -37,6 +37,7 @@ public:
 
 	void Create(int iID);
 	void Create(COLORREF crClr);
+	void CreateShared(COLORREF crClr);
 
 	//
 	// Member access.
@@ -49,6 +50,12 @@ protected:
 	//
 	HBRUSH	m_hBrush;
 	bool	m_bOwner;
+	bool	m_bShared;
+
+	//
+	// Internal methods.
+	//
+	void Release();
 
 private:
 	// NotCopyable.
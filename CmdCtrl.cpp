@@ -11,6 +11,8 @@
 #include "Common.hpp"
 #include "CmdCtrl.hpp"
 #include "ICommandWnd.hpp"
+#include <algorithm>
+#include <limits>
 
 #if (__GNUC__ >= 8) // GCC 8+
 // error: cast between incompatible function types
@@ -25,6 +27,8 @@ CCmdControl::CCmdControl(WCL::ICommandWnd& commandWnd)
 	, m_bitmapId(0)
 	, m_CmdBitmap()
 	, m_commandWnd(commandWnd)
+	, m_pIndexedTable(nullptr)
+	, m_vCmdIndex()
 {
 }
 
@@ -36,6 +40,8 @@ CCmdControl::CCmdControl(WCL::ICommandWnd& commandWnd, uint bitmapId)
 	, m_bitmapId(bitmapId)
 	, m_CmdBitmap()
 	, m_commandWnd(commandWnd)
+	, m_pIndexedTable(nullptr)
+	, m_vCmdIndex()
 {
 }
 
@@ -65,15 +71,11 @@ void CCmdControl::InitialiseUI()
 
 void CCmdControl::Execute(uint iCmdID)
 {
-	CMD* pCmd = m_pCmdTable;
-
 	// Find command callback function.
-	while ( (pCmd != nullptr) && (pCmd->m_eType != CmdNone)
-		 && ( (iCmdID < pCmd->m_iFirstID) || (iCmdID > pCmd->m_iLastID) ) )
-	    ++pCmd;
+	const CMD* pCmd = FindCmd(iCmdID);
 
 	// If found, Execute it.
-	if ( (pCmd != nullptr) && (iCmdID >= pCmd->m_iFirstID) && (iCmdID <= pCmd->m_iLastID) )
+	if (pCmd != nullptr)
 	{
 		// Handler for a single command?
 		if (pCmd->m_eType == CmdSingle)
@@ -155,21 +157,127 @@ void CCmdControl::DrawCmd(uint iCmdID, CDC& rDC, const CRect& rDst, bool bEnable
 
 int CCmdControl::CmdBmpIndex(uint iCmdID) const
 {
-	CMD* pCmd = m_pCmdTable;
-
 	// Find command.
-	while ( (pCmd != nullptr) && (pCmd->m_eType != CmdNone)
-		 && ( (iCmdID < pCmd->m_iFirstID) || (iCmdID > pCmd->m_iLastID) ) )
-	    ++pCmd;
+	const CMD* pCmd = FindCmd(iCmdID);
 
 	// If found, return it.
-	if ( (pCmd != nullptr) && (iCmdID >= pCmd->m_iFirstID) && (iCmdID <= pCmd->m_iLastID) )
+	if (pCmd != nullptr)
 		return pCmd->m_iBmpIndex;
 
 	// Not found.
 	return -1;
 }
 
+/******************************************************************************
+** Method:		FindCmd()
+**
+** Description:	Find the first entry in the command table that handles the
+**				command. The table is compiled into a sorted index of disjoint
+**				ranges the first time it is used (or whenever the table is
+**				replaced) so that a lookup is a binary search.
+**
+** Parameters:	iCmdID		The command.
+**
+** Returns:		The table entry or nullptr if the command is not mapped.
+**
+*******************************************************************************
+*/
+
+const CCmdControl::CMD* CCmdControl::FindCmd(uint iCmdID) const
+{
+	if (m_pCmdTable == nullptr)
+		return nullptr;
+
+	if (m_pIndexedTable != m_pCmdTable)
+		BuildCmdIndex();
+
+	// Find the last range that starts at or before the command.
+	size_t nFirst = 0;
+	size_t nLast  = m_vCmdIndex.size();
+
+	while (nFirst != nLast)
+	{
+		size_t nMiddle = nFirst + ((nLast - nFirst) / 2);
+
+		if (m_vCmdIndex[nMiddle].m_iFirstID <= iCmdID)
+			nFirst = nMiddle+1;
+		else
+			nLast = nMiddle;
+	}
+
+	if ( (nFirst != 0) && (iCmdID <= m_vCmdIndex[nFirst-1].m_iLastID) )
+		return m_vCmdIndex[nFirst-1].m_pCmd;
+
+	return nullptr;
+}
+
+/******************************************************************************
+** Method:		BuildCmdIndex()
+**
+** Description:	Compile the command table into a sorted array of disjoint
+**				command ranges. Where ranges overlap the command is mapped to
+**				the earliest table entry to match the original linear search.
+**
+** Parameters:	None.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CCmdControl::BuildCmdIndex() const
+{
+	ASSERT(m_pCmdTable != nullptr);
+
+	typedef std::vector<uint> Bounds;
+
+	Bounds vBounds;
+
+	// Collect the start of every range and the command following it.
+	for (const CMD* pCmd = m_pCmdTable; pCmd->m_eType != CmdNone; ++pCmd)
+	{
+		vBounds.push_back(pCmd->m_iFirstID);
+
+		if (pCmd->m_iLastID != std::numeric_limits<uint>::max())
+			vBounds.push_back(pCmd->m_iLastID+1);
+	}
+
+	std::sort(vBounds.begin(), vBounds.end());
+	vBounds.erase(std::unique(vBounds.begin(), vBounds.end()), vBounds.end());
+
+	m_vCmdIndex.clear();
+
+	// Map each elementary range to the first entry that covers it.
+	for (size_t i = 0; i != vBounds.size(); ++i)
+	{
+		const uint iFirstID = vBounds[i];
+		const uint iLastID  = (i+1 != vBounds.size()) ? vBounds[i+1]-1 : std::numeric_limits<uint>::max();
+		const CMD* pCmd     = m_pCmdTable;
+
+		while ( (pCmd->m_eType != CmdNone)
+			 && ( (iFirstID < pCmd->m_iFirstID) || (iFirstID > pCmd->m_iLastID) ) )
+			++pCmd;
+
+		if (pCmd->m_eType == CmdNone)
+			continue;
+
+		// Extends the previous range?
+		if ( (!m_vCmdIndex.empty()) && (m_vCmdIndex.back().m_pCmd == pCmd)
+		  && (m_vCmdIndex.back().m_iLastID+1 == iFirstID) )
+		{
+			m_vCmdIndex.back().m_iLastID = iLastID;
+		}
+		else
+		{
+			CMDRANGE oRange = { iFirstID, iLastID, pCmd };
+
+			m_vCmdIndex.push_back(oRange);
+		}
+	}
+
+	m_pIndexedTable = m_pCmdTable;
+}
+
 /******************************************************************************
 ** Method:		CmdHintID()
 **
@@ -18,6 +18,7 @@
 
 #include "ICmdController.hpp"
 #include "CmdBmp.hpp"
+#include <vector>
 
 // Forward declarations.
 namespace WCL
@@ -113,6 +114,26 @@ protected:
 	virtual int CmdToolTipID(uint iCmdID) const;
 
 private:
+	// An entry in the command index.
+	struct CMDRANGE
+	{
+		uint			m_iFirstID;			// First command in range.
+		uint			m_iLastID;			// Last command in range.
+		const CMD*		m_pCmd;				// The command table entry.
+	};
+
+	//
+	// Members.
+	//
+	mutable const CMD*				m_pIndexedTable;	//!< The table the index was built from.
+	mutable std::vector<CMDRANGE>	m_vCmdIndex;		//!< Sorted, disjoint command ranges.
+
+	//! Find the command table entry for a command.
+	const CMD* FindCmd(uint iCmdID) const;
+
+	//! Compile the command table into the index.
+	void BuildCmdIndex() const;
+
 	// NotCopyable.
 	CCmdControl(const CCmdControl&);
 	CCmdControl& operator=(const CCmdControl&);
@@ -0,0 +1,236 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ColumnarDataSource.cpp
+//! \brief  The ColumnarDataSource class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "ColumnarDataSource.hpp"
+#include <algorithm>
+
+namespace WCL
+{
+
+namespace
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! The predicate used to sort the rows by the values in a single column.
+
+class RowComparator
+{
+public:
+	//! Constructor.
+	RowComparator(const tchar* text, const size_t* offsets, bool ascending)
+		: m_text(text)
+		, m_offsets(offsets)
+		, m_ascending(ascending)
+	{
+	}
+
+	//! Compare the values of two rows.
+	bool operator()(size_t lhs, size_t rhs) const
+	{
+		const int result = tstricmp(m_text + m_offsets[lhs], m_text + m_offsets[rhs]);
+
+		return (m_ascending) ? (result < 0) : (result > 0);
+	}
+
+private:
+	//
+	// Members.
+	//
+	const tchar*	m_text;			//!< The column values.
+	const size_t*	m_offsets;		//!< The offset of each row's value.
+	bool			m_ascending;	//!< The sort order.
+};
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction with the number of columns.
+
+ColumnarDataSource::ColumnarDataSource(size_t columns)
+	: m_columns(columns)
+	, m_order()
+	, m_images()
+{
+	ASSERT(columns != 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+ColumnarDataSource::~ColumnarDataSource()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Reserve space for a number of rows. The average number of characters in
+//! each cell can also be provided to avoid the column buffers being resized.
+
+void ColumnarDataSource::reserve(size_t rows, size_t charsPerCell)
+{
+	for (Columns::iterator it = m_columns.begin(); it != m_columns.end(); ++it)
+	{
+		it->m_offsets.reserve(rows);
+
+		if (charsPerCell != 0)
+			it->m_text.reserve(rows * (charsPerCell+1));
+	}
+
+	m_order.reserve(rows);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Append a row. The array must contain a value for every column, but a null
+//! value is treated as an empty string. Returns the index of the new row.
+
+size_t ColumnarDataSource::appendRow(const tchar* const* values, size_t image)
+{
+	ASSERT(values != nullptr);
+
+	const size_t row = m_order.size();
+
+	for (size_t i = 0; i != m_columns.size(); ++i)
+	{
+		Column&      column = m_columns[i];
+		const tchar* value  = (values[i] != nullptr) ? values[i] : TXT("");
+
+		column.m_offsets.push_back(column.m_text.size());
+		column.m_text.insert(column.m_text.end(), value, value + tstrlen(value) + 1);
+	}
+
+	// Only store images once one has been set.
+	if ( (image != Core::npos) && (m_images.size() != row) )
+		m_images.resize(row, -1);
+
+	if (!m_images.empty() || (image != Core::npos))
+		m_images.push_back((image != Core::npos) ? static_cast<int>(image) : -1);
+
+	m_order.push_back(row);
+
+	return row;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Remove all rows.
+
+void ColumnarDataSource::clear()
+{
+	for (Columns::iterator it = m_columns.begin(); it != m_columns.end(); ++it)
+	{
+		it->m_text.clear();
+		it->m_offsets.clear();
+	}
+
+	m_order.clear();
+	m_images.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Sort the rows by the values in a column. The comparison ignores case and
+//! rows with equal values retain their current relative order.
+
+void ColumnarDataSource::sort(size_t column, bool ascending)
+{
+	ASSERT(column < m_columns.size());
+
+	const Column& values = m_columns[column];
+
+	if (m_order.empty())
+		return;
+
+	RowComparator comparator(&values.m_text[0], &values.m_offsets[0], ascending);
+
+	std::stable_sort(m_order.begin(), m_order.end(), comparator);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the text for a cell.
+
+const tchar* ColumnarDataSource::cellText(size_t row, size_t column) const
+{
+	ASSERT(row < m_order.size());
+	ASSERT(column < m_columns.size());
+
+	const Column& values = m_columns[column];
+
+	return &values.m_text[values.m_offsets[m_order[row]]];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the image index for a row, or Core::npos if there is none.
+
+size_t ColumnarDataSource::rowImage(size_t row) const
+{
+	ASSERT(row < m_order.size());
+
+	if (m_images.empty())
+		return Core::npos;
+
+	const int image = m_images[m_order[row]];
+
+	return (image != -1) ? static_cast<size_t>(image) : Core::npos;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Prepare the rows that are about to be displayed. The values are already in
+//! memory so there is nothing to do.
+
+void ColumnarDataSource::cacheHint(size_t /*first*/, size_t /*last*/)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Find the first row, starting at the row given, whose first column matches
+//! the text. The comparison ignores case. If wrap is set the search continues
+//! from the first row. Returns Core::npos if there is no match.
+
+size_t ColumnarDataSource::findRow(const tchar* text, bool partial, size_t start, bool wrap) const
+{
+	ASSERT(text != nullptr);
+
+	const size_t count  = m_order.size();
+	const size_t length = tstrlen(text);
+
+	if (start >= count)
+	{
+		if (!wrap)
+			return Core::npos;
+
+		start = 0;
+	}
+
+	for (size_t row = start; row != count; ++row)
+	{
+		if (matches(row, text, length, partial))
+			return row;
+	}
+
+	if (wrap)
+	{
+		for (size_t row = 0; row != start; ++row)
+		{
+			if (matches(row, text, length, partial))
+				return row;
+		}
+	}
+
+	return Core::npos;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Check if a row's first column matches the text.
+
+bool ColumnarDataSource::matches(size_t row, const tchar* text, size_t length, bool partial) const
+{
+	const tchar* value = cellText(row, 0);
+
+	if (partial)
+		return (tstrnicmp(value, text, length) == 0);
+
+	return (tstricmp(value, text) == 0);
+}
+
+//namespace WCL
+}
@@ -0,0 +1,127 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ColumnarDataSource.hpp
+//! \brief  The ColumnarDataSource class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef WCL_COLUMNARDATASOURCE_HPP
+#define WCL_COLUMNARDATASOURCE_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "IListViewDataSource.hpp"
+#include <vector>
+
+namespace WCL
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! An in-memory table of strings for displaying in a virtual ListView. Each
+//! column is stored as a single buffer of null-terminated strings, with an
+//! array of offsets into it, to avoid a heap allocation per cell. The rows are
+//! displayed through an index so that the table can be sorted without moving
+//! the strings.
+
+class ColumnarDataSource : public IListViewDataSource /*, private NotCopyable*/
+{
+public:
+	//! Construction with the number of columns.
+	explicit ColumnarDataSource(size_t columns);
+
+	//! Destructor.
+	virtual ~ColumnarDataSource();
+
+	//
+	// Properties.
+	//
+
+	//! Get the number of columns.
+	size_t columnCount() const;
+
+	//
+	// Methods.
+	//
+
+	//! Reserve space for a number of rows.
+	void reserve(size_t rows, size_t charsPerCell = 0);
+
+	//! Append a row. The array must contain a value for every column.
+	size_t appendRow(const tchar* const* values, size_t image = Core::npos);
+
+	//! Remove all rows.
+	void clear();
+
+	//! Sort the rows by the values in a column.
+	void sort(size_t column, bool ascending = true);
+
+	//
+	// IListViewDataSource methods.
+	//
+
+	//! Get the number of rows.
+	virtual size_t rowCount() const;
+
+	//! Get the text for a cell.
+	virtual const tchar* cellText(size_t row, size_t column) const;
+
+	//! Get the image index for a row, or Core::npos if there is none.
+	virtual size_t rowImage(size_t row) const;
+
+	//! Prepare the rows that are about to be displayed.
+	virtual void cacheHint(size_t first, size_t last);
+
+	//! Find the first row whose first column matches the text.
+	virtual size_t findRow(const tchar* text, bool partial, size_t start, bool wrap) const;
+
+private:
+	//! The storage for a single column.
+	struct Column
+	{
+		std::vector<tchar>	m_text;		//!< The null-terminated values.
+		std::vector<size_t>	m_offsets;	//!< The offset of each row's value.
+	};
+
+	//! The collection of columns.
+	typedef std::vector<Column> Columns;
+	//! The collection of row indices.
+	typedef std::vector<size_t> Rows;
+	//! The collection of row images.
+	typedef std::vector<int> Images;
+
+	//
+	// Members.
+	//
+	Columns		m_columns;		//!< The column values.
+	Rows		m_order;		//!< The display order of the rows.
+	Images		m_images;		//!< The row images, if any were set.
+
+	//! Check if a row's first column matches the text.
+	bool matches(size_t row, const tchar* text, size_t length, bool partial) const;
+
+	// NotCopyable.
+	ColumnarDataSource(const ColumnarDataSource&);
+	ColumnarDataSource& operator=(const ColumnarDataSource&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of columns.
+
+inline size_t ColumnarDataSource::columnCount() const
+{
+	return m_columns.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of rows.
+
+inline size_t ColumnarDataSource::rowCount() const
+{
+	return m_order.size();
+}
+
+//namespace WCL
+}
+
+#endif // WCL_COLUMNARDATASOURCE_HPP
@@ -37,6 +37,10 @@
 const int DAYS_PER_YEAR      = 365;
 const int DAYS_PER_LEAP_YEAR = 366;
 const int DAYS_PER_4_YEARS   = (DAYS_PER_YEAR * 3) + DAYS_PER_LEAP_YEAR;
+const int DAYS_PER_400_YEARS = 146097;
+
+// Days from 1st Mar 0000 to 1st Jan 1970.
+const int DAYS_FROM_0000_TO_1970 = 719468;
 
 // ISO Format string size in characters "dddd-dd-dd".
 const size_t ISO_FMT_MAX_LEN = 10;
@@ -122,22 +126,7 @@ void CDate::Set(int iDay, int iMonth, int  iYear)
 	ASSERT( (iMonth >= MIN_MONTH) && (iMonth <= MAX_MONTH) );
 	ASSERT( (iDay   >= MIN_DAY)   && (iDay   <= DaysInMonth(iMonth, iYear)) );
 
-	tm oTM;
-
-	oTM.tm_mday  = iDay;
-	oTM.tm_mon   = iMonth-1;
-	oTM.tm_year  = iYear - 1900;
-	oTM.tm_hour  = 0;
-	oTM.tm_min   = 0;
-	oTM.tm_sec   = 0;
-	oTM.tm_isdst = 0;
-
-	m_tDate = mktime(&oTM);
-
-	// Do what _mkgmtime() does.
-	m_tDate -= _timezone;
-
-	ASSERT(m_tDate != -1);
+	m_tDate = DaysFromCivil(iDay, iMonth, iYear) * WCL::SECS_PER_DAY;
 }
 
 /******************************************************************************
@@ -154,11 +143,13 @@ void CDate::Set(int iDay, int iMonth, int  iYear)
 
 void CDate::Get(int& iDay, int& iMonth, int& iYear) const
 {
-	tm oTM = *gmtime(&m_tDate);
+	WCL::Seconds tDays = m_tDate / WCL::SECS_PER_DAY;
+
+	// Round towards the earlier day for pre-1970 dates.
+	if ((m_tDate % WCL::SECS_PER_DAY) < 0)
+		--tDays;
 
-	iDay   = oTM.tm_mday;
-	iMonth = oTM.tm_mon + 1;
-	iYear  = oTM.tm_year + 1900;
+	CivilFromDays(tDays, iDay, iMonth, iYear);
 }
 
 /******************************************************************************
@@ -182,6 +173,37 @@ CDate CDate::Current()
 	return Now;
 }
 
+/******************************************************************************
+** Method:		Decompose()
+**
+** Description:	Converts an array of dates, held as seconds, into their day,
+**				month and year fields. Any time part is ignored.
+**
+** Parameters:	ptDates		The array of dates.
+**				nCount		The number of dates.
+**				pFields		The array to return the fields in.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CDate::Decompose(const WCL::Seconds* ptDates, size_t nCount, Fields* pFields)
+{
+	ASSERT((ptDates != nullptr) || (nCount == 0));
+	ASSERT((pFields != nullptr) || (nCount == 0));
+
+	for (size_t i = 0; i != nCount; ++i)
+	{
+		WCL::Seconds tDays = ptDates[i] / WCL::SECS_PER_DAY;
+
+		if ((ptDates[i] % WCL::SECS_PER_DAY) < 0)
+			--tDays;
+
+		CivilFromDays(tDays, pFields[i].m_iDay, pFields[i].m_iMonth, pFields[i].m_iYear);
+	}
+}
+
 /******************************************************************************
 ** Method:		DateFormatOrder()
 **
@@ -512,3 +534,60 @@ int CDate::DaysInMonth(int iMonth, int iYear) const
 
 	return DaysPerMonth[iIndex][iMonth-1];
 }
+
+/******************************************************************************
+** Method:		DaysFromCivil()
+**
+** Description:	Calculates the number of days since 1st Jan 1970 for the given
+**				date in the proleptic Gregorian calendar. The calculation works
+**				with years that start on 1st March so that the leap day falls
+**				at the end of the year.
+**
+** Parameters:	iDay, iMonth, iYear		The date.
+**
+** Returns:		The number of days, which is negative for earlier dates.
+**
+*******************************************************************************
+*/
+
+WCL::Seconds CDate::DaysFromCivil(int iDay, int iMonth, int iYear)
+{
+	const WCL::Seconds tYear = (iMonth <= 2) ? iYear-1 : iYear;
+
+	const WCL::Seconds tEra       = ((tYear >= 0) ? tYear : tYear-399) / 400;
+	const WCL::Seconds tYearOfEra = tYear - (tEra * 400);
+	const WCL::Seconds tDayOfYear = ((153 * ((iMonth > 2) ? iMonth-3 : iMonth+9)) + 2) / 5 + (iDay-1);
+	const WCL::Seconds tDayOfEra  = (tYearOfEra * 365) + (tYearOfEra / 4) - (tYearOfEra / 100) + tDayOfYear;
+
+	return (tEra * DAYS_PER_400_YEARS) + tDayOfEra - DAYS_FROM_0000_TO_1970;
+}
+
+/******************************************************************************
+** Method:		CivilFromDays()
+**
+** Description:	Calculates the date in the proleptic Gregorian calendar for the
+**				number of days since 1st Jan 1970. This is the inverse of
+**				DaysFromCivil().
+**
+** Parameters:	tDays					The number of days.
+**				iDay, iMonth, iYear		The returned date.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CDate::CivilFromDays(WCL::Seconds tDays, int& iDay, int& iMonth, int& iYear)
+{
+	tDays += DAYS_FROM_0000_TO_1970;
+
+	const WCL::Seconds tEra       = ((tDays >= 0) ? tDays : tDays-(DAYS_PER_400_YEARS-1)) / DAYS_PER_400_YEARS;
+	const WCL::Seconds tDayOfEra  = tDays - (tEra * DAYS_PER_400_YEARS);
+	const WCL::Seconds tYearOfEra = (tDayOfEra - (tDayOfEra / 1460) + (tDayOfEra / 36524) - (tDayOfEra / 146096)) / 365;
+	const WCL::Seconds tDayOfYear = tDayOfEra - ((tYearOfEra * 365) + (tYearOfEra / 4) - (tYearOfEra / 100));
+	const WCL::Seconds tMonthIdx  = ((tDayOfYear * 5) + 2) / 153;
+
+	iDay   = static_cast<int>(tDayOfYear - (((153 * tMonthIdx) + 2) / 5) + 1);
+	iMonth = static_cast<int>((tMonthIdx < 10) ? tMonthIdx+3 : tMonthIdx-9);
+	iYear  = static_cast<int>((tYearOfEra + (tEra * 400)) + ((iMonth <= 2) ? 1 : 0));
+}
@@ -83,6 +83,18 @@ public:
 
 	static CDate Current();
 
+	//
+	// Batch conversion.
+	//
+	struct Fields
+	{
+		int		m_iDay;			// The day of the month.
+		int		m_iMonth;		// The month.
+		int		m_iYear;		// The year.
+	};
+
+	static void Decompose(const WCL::Seconds* ptDates, size_t nCount, Fields* pFields);
+
 	//
 	// Date string ordering (See LOCALE_IDATE).
 	//
@@ -148,6 +160,9 @@ protected:
 	//
 	int DaysInMonth(int iMonth, int iYear) const;
 
+	static WCL::Seconds DaysFromCivil(int iDay, int iMonth, int iYear);
+	static void         CivilFromDays(WCL::Seconds tDays, int& iDay, int& iMonth, int& iYear);
+
 	//
 	// Friends.
 	//
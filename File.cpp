@@ -11,6 +11,7 @@
 #include "Common.hpp"
 #include "File.hpp"
 #include "FileException.hpp"
+#include "MappedFile.hpp"
 #include <io.h>
 #include <shlobj.h>
 #include <Core/AnsiWide.hpp>
@@ -598,33 +599,36 @@ size_t CFile::ReadTextFile(const tchar* pszPath, CString& strContents)
 
 size_t CFile::ReadTextFile(const tchar* pszPath, CString& strContents, TextFormat& eFormat)
 {
-	std::vector<byte> vBuffer;
+	CMappedFile oFile;
+
+	// Map the file rather than copying it into a temporary buffer.
+	oFile.Open(pszPath, GENERIC_READ);
 
-	// Read the file into our temporary buffer.
-	ReadFile(pszPath, vBuffer);
+	const byte* pData = oFile.Data();
+	size_t      nSize = oFile.Size();
 
 	size_t nChars  = 0;
 	size_t nOffset = 0;
 
 	// Contains a Unicode BOM?.
-	if ( (vBuffer.size() >= 2) && (vBuffer[0] == 0xFF) && (vBuffer[1] == 0xFE) )
+	if ( (nSize >= 2) && (pData[0] == 0xFF) && (pData[1] == 0xFE) )
 	{
 		eFormat = UNICODE_TEXT;
-		nChars  = (vBuffer.size() - 2) / sizeof(wchar_t);
+		nChars  = (nSize - 2) / sizeof(wchar_t);
 		nOffset = 1;
 	}
 	// Contains a UTF-8 BOM?
-	else if ( (vBuffer.size() >= 3) && (vBuffer[0] == 0xEF) && (vBuffer[1] == 0xBB) && (vBuffer[2] == 0xBF) )
+	else if ( (nSize >= 3) && (pData[0] == 0xEF) && (pData[1] == 0xBB) && (pData[2] == 0xBF) )
 	{
 		eFormat = ANSI_TEXT;
-		nChars  = vBuffer.size() - 3;
+		nChars  = nSize - 3;
 		nOffset = 3;
 	}
 	// No BOM.
 	else
 	{
 		eFormat = ANSI_TEXT;
-		nChars  = vBuffer.size();
+		nChars  = nSize;
 		nOffset = 0;
 	}
 
@@ -636,7 +640,7 @@ size_t CFile::ReadTextFile(const tchar* pszPath, CString& strContents, TextForma
 		// Copy the contents to the return buffer.
 		if (eFormat == ANSI_TEXT)
 		{
-			const char* pszBegin = reinterpret_cast<const char*>(&vBuffer.front()) + nOffset;
+			const char* pszBegin = reinterpret_cast<const char*>(pData) + nOffset;
 			const char* pszEnd   = pszBegin + nChars;
 
 #ifdef ANSI_BUILD
@@ -647,7 +651,7 @@ size_t CFile::ReadTextFile(const tchar* pszPath, CString& strContents, TextForma
 		}
 		else // (eFormat == UNICODE_TEXT)
 		{
-			const wchar_t* pszBegin = reinterpret_cast<const wchar_t*>(&vBuffer.front()) + nOffset;
+			const wchar_t* pszBegin = reinterpret_cast<const wchar_t*>(pData) + nOffset;
 			const wchar_t* pszEnd   = pszBegin + nChars;
 
 #ifdef ANSI_BUILD
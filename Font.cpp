@@ -10,6 +10,7 @@
 
 #include "Common.hpp"
 #include "Font.hpp"
+#include "GDICache.hpp"
 
 /******************************************************************************
 **
@@ -50,12 +51,14 @@ static FontMapEntry g_aoFontMap[] = {
 CFont::CFont()
 	: m_hFont(NULL)
 	, m_bOwner(false)
+	, m_bShared(false)
 {
 }
 
 CFont::CFont(int iID)
 	: m_hFont()
 	, m_bOwner()
+	, m_bShared()
 {
 	Create(iID);
 }
@@ -63,6 +66,7 @@ CFont::CFont(int iID)
 CFont::CFont(const CLogFont& rLogFont)
 	: m_hFont()
 	, m_bOwner()
+	, m_bShared()
 {
 	Create(rLogFont);
 }
@@ -70,6 +74,7 @@ CFont::CFont(const CLogFont& rLogFont)
 CFont::CFont(HFONT hFont, bool bOwn)
 	: m_hFont()
 	, m_bOwner()
+	, m_bShared()
 {
 	Create(hFont, bOwn);
 }
@@ -78,6 +83,7 @@ CFont::CFont(HFONT hFont, bool bOwn)
 ** Method:		Copy constructor.
 **
 ** Description:	Copy the source font. This ASSERTs if the source is the owner.
+**				A shared font is copied by taking another reference to it.
 **
 ** Parameters:	rhs		The font to copy.
 **
@@ -89,8 +95,12 @@ CFont::CFont(HFONT hFont, bool bOwn)
 CFont::CFont(const CFont& rhs)
 	: m_hFont(rhs.m_hFont)
 	, m_bOwner(false)
+	, m_bShared(rhs.m_bShared)
 {
 	ASSERT(rhs.m_bOwner == false);
+
+	if (m_bShared)
+		WCL::GDICache::instance().addRef(m_hFont);
 }
 
 /******************************************************************************
@@ -114,6 +124,7 @@ CFont::~CFont()
 ** Method:		Assignment operator.
 **
 ** Description:	Copy the source font. This ASSERTs if the source is the owner.
+**				A shared font is copied by taking another reference to it.
 **
 ** Parameters:	rhs		The font to copy.
 **
@@ -133,8 +144,12 @@ CFont& CFont::operator=(const CFont& rhs)
 		Release();
 
 		// Copy source.
-		m_hFont  = rhs.m_hFont;
-		m_bOwner = false;
+		m_hFont   = rhs.m_hFont;
+		m_bOwner  = false;
+		m_bShared = rhs.m_bShared;
+
+		if (m_bShared)
+			WCL::GDICache::instance().addRef(m_hFont);
 	}
 
 	return *this;
@@ -210,6 +225,31 @@ void CFont::Create(HFONT hFont, bool bOwn)
 	m_bOwner = bOwn;
 }
 
+/******************************************************************************
+** Method:		CreateShared()
+**
+** Description:	Acquire the font for the LOGFONT structure from the process-wide
+**				GDI object cache. Fonts with the same definition share the
+**				same handle, which is released back to the cache.
+**
+** Parameters:	rLogFont	The LOGFONT definition.
+**
+** Returns:		true or false.
+**
+*******************************************************************************
+*/
+
+bool CFont::CreateShared(const CLogFont& rLogFont)
+{
+	Release();
+
+	// Acquire font.
+	m_hFont   = WCL::GDICache::instance().acquireFont(rLogFont);
+	m_bShared = (m_hFont != NULL);
+
+	return(m_hFont != NULL);
+}
+
 /******************************************************************************
 ** Method:		Select()
 **
@@ -318,7 +358,8 @@ bool CFont::Parse(const tchar* pszFont, CFont& oFont)
 /******************************************************************************
 ** Method:		Release()
 **
-** Description:	Releases the resources by destroying it, if we're the owner.
+** Description:	Releases the resources by destroying it, if we're the owner,
+**				or returning it to the cache, if it's shared.
 **
 ** Parameters:	None.
 **
@@ -332,8 +373,11 @@ void CFont::Release()
 	// Free resource, if the owner.
 	if ( (m_hFont != NULL) && (m_bOwner) )
 		::DeleteObject(m_hFont);
+	else if ( (m_hFont != NULL) && (m_bShared) )
+		WCL::GDICache::instance().release(m_hFont);
 
 	// Reset state.
-	m_hFont  = NULL;
-	m_bOwner = false;
+	m_hFont   = NULL;
+	m_bOwner  = false;
+	m_bShared = false;
 }
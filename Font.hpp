@@ -51,6 +51,7 @@ public:
 	bool Create(int iID);
 	bool Create(const CLogFont& rLogFont);
 	void Create(HFONT hFont, bool bOwn = false);
+	bool CreateShared(const CLogFont& rLogFont);
 
 	bool Select(const CWnd& rParent);
 
@@ -63,6 +64,7 @@ protected:
 	//
 	HFONT	m_hFont;
 	bool	m_bOwner;
+	bool	m_bShared;
 
 	//
 	// Internal methods.
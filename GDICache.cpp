@@ -0,0 +1,314 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   GDICache.cpp
+//! \brief  The GDICache class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "GDICache.hpp"
+#include "AutoThreadLock.hpp"
+#include <cstddef>
+#include <cstring>
+
+namespace WCL
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Constructor.
+
+GDICache::GDICache(size_t capacity)
+	: m_lock()
+	, m_capacity(capacity)
+	, m_handles()
+	, m_entries()
+	, m_unused()
+	, m_hits(0)
+	, m_misses(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor. Destroys all the objects, whether referenced or not.
+
+GDICache::~GDICache()
+{
+	for (Entries::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+		::DeleteObject(it->first);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the process-wide cache. This is created on first use, which should be
+//! from the main thread.
+//!
+//! Fonts, pens and brushes are often members of global objects, such as the
+//! application, and so can be released during static destruction. The cache
+//! is therefore never destroyed, so that it outlives all of them. The GDI
+//! objects it still holds are freed by the system when the process exits.
+
+GDICache& GDICache::instance()
+{
+	static GDICache* s_cache = new GDICache;
+
+	return *s_cache;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the maximum number of objects kept in the cache.
+
+size_t GDICache::capacity() const
+{
+	CAutoThreadLock lock(m_lock);
+
+	return m_capacity;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Set the maximum number of objects kept in the cache. Referenced objects are
+//! never destroyed, so the cache may temporarily exceed this.
+
+void GDICache::setCapacity(size_t capacity)
+{
+	CAutoThreadLock lock(m_lock);
+
+	m_capacity = capacity;
+
+	trim(m_capacity);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of objects in the cache.
+
+size_t GDICache::size() const
+{
+	CAutoThreadLock lock(m_lock);
+
+	return m_entries.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of requests satisfied by an existing object.
+
+size_t GDICache::hits() const
+{
+	CAutoThreadLock lock(m_lock);
+
+	return m_hits;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of requests that created a new object.
+
+size_t GDICache::misses() const
+{
+	CAutoThreadLock lock(m_lock);
+
+	return m_misses;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Acquire a font.
+
+HFONT GDICache::acquireFont(const LOGFONT& logFont)
+{
+	Key key = { FONT };
+
+	key.m_font = logFont;
+
+	return static_cast<HFONT>(acquire(key));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Acquire a pen.
+
+HPEN GDICache::acquirePen(int style, int width, COLORREF colour)
+{
+	Key key = { PEN };
+
+	key.m_style  = style;
+	key.m_width  = width;
+	key.m_colour = colour;
+
+	return static_cast<HPEN>(acquire(key));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Acquire a solid brush.
+
+HBRUSH GDICache::acquireBrush(COLORREF colour)
+{
+	Key key = { BRUSH };
+
+	key.m_colour = colour;
+
+	return static_cast<HBRUSH>(acquire(key));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Add a reference to an object acquired from the cache, e.g. when the owner
+//! of the handle is copied.
+
+void GDICache::addRef(HGDIOBJ handle)
+{
+	CAutoThreadLock lock(m_lock);
+
+	Entries::iterator it = m_entries.find(handle);
+
+	ASSERT(it != m_entries.end());
+	ASSERT(it->second.m_refs != 0);
+
+	if (it != m_entries.end())
+		++it->second.m_refs;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Release an object acquired from the cache. When the last reference is
+//! released the object is kept for reuse, subject to the cache capacity.
+
+void GDICache::release(HGDIOBJ handle)
+{
+	CAutoThreadLock lock(m_lock);
+
+	Entries::iterator it = m_entries.find(handle);
+
+	ASSERT(it != m_entries.end());
+	ASSERT(it->second.m_refs != 0);
+
+	if ( (it == m_entries.end()) || (it->second.m_refs == 0) )
+		return;
+
+	if (--it->second.m_refs == 0)
+	{
+		m_unused.push_front(handle);
+		it->second.m_position = m_unused.begin();
+
+		trim(m_capacity);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destroy all the objects that are no longer referenced.
+
+void GDICache::purge()
+{
+	CAutoThreadLock lock(m_lock);
+
+	trim(0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Reset the hit and miss counters.
+
+void GDICache::resetStats()
+{
+	CAutoThreadLock lock(m_lock);
+
+	m_hits   = 0;
+	m_misses = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Find the object for a definition, or create it if not cached.
+
+HGDIOBJ GDICache::acquire(const Key& key)
+{
+	CAutoThreadLock lock(m_lock);
+
+	Handles::const_iterator it = m_handles.find(key);
+
+	if (it != m_handles.end())
+	{
+		Entry& entry = m_entries[it->second];
+
+		if (entry.m_refs++ == 0)
+			m_unused.erase(entry.m_position);
+
+		++m_hits;
+
+		return it->second;
+	}
+
+	HGDIOBJ handle = create(key);
+
+	if (handle == NULL)
+		return NULL;
+
+	// Make room for the new object.
+	if (m_capacity != 0)
+		trim(m_capacity-1);
+
+	Entry entry = { key, 1, m_unused.end() };
+
+	m_handles.insert(std::make_pair(key, handle));
+	m_entries.insert(std::make_pair(handle, entry));
+
+	++m_misses;
+
+	return handle;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Create a GDI object from its definition.
+
+HGDIOBJ GDICache::create(const Key& key)
+{
+	switch (key.m_type)
+	{
+		case FONT:	return ::CreateFontIndirect(&key.m_font);
+		case PEN:	return ::CreatePen(key.m_style, key.m_width, key.m_colour);
+		case BRUSH:	return ::CreateSolidBrush(key.m_colour);
+		default:	ASSERT_FALSE();	break;
+	}
+
+	return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destroy the least recently released objects until the cache holds no more
+//! than the number of objects specified, or there are no unreferenced objects.
+
+void GDICache::trim(size_t capacity)
+{
+	while ( (m_entries.size() > capacity) && (!m_unused.empty()) )
+	{
+		HGDIOBJ           handle = m_unused.back();
+		Entries::iterator it     = m_entries.find(handle);
+
+		ASSERT(it != m_entries.end());
+
+		m_unused.pop_back();
+		m_handles.erase(it->second.m_key);
+		m_entries.erase(it);
+
+		::DeleteObject(handle);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Compare two keys. Only the fields relevant to the type of object are
+//! compared.
+
+bool GDICache::Key::operator<(const Key& rhs) const
+{
+	if (m_type != rhs.m_type)
+		return (m_type < rhs.m_type);
+
+	if (m_type == FONT)
+	{
+		const int result = memcmp(&m_font, &rhs.m_font, offsetof(LOGFONT, lfFaceName));
+
+		if (result != 0)
+			return (result < 0);
+
+		return (tstrncmp(m_font.lfFaceName, rhs.m_font.lfFaceName, LF_FACESIZE) < 0);
+	}
+
+	if (m_style != rhs.m_style)
+		return (m_style < rhs.m_style);
+
+	if (m_width != rhs.m_width)
+		return (m_width < rhs.m_width);
+
+	return (m_colour < rhs.m_colour);
+}
+
+//namespace WCL
+}
@@ -0,0 +1,160 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   GDICache.hpp
+//! \brief  The GDICache class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef WCL_GDICACHE_HPP
+#define WCL_GDICACHE_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "CriticalSection.hpp"
+#include <map>
+#include <list>
+
+namespace WCL
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A cache of shared fonts, pens and brushes. The objects are keyed on their
+//! definition and reference counted, so that painting code which repeatedly
+//! asks for the same font, pen or brush gets the same handle back instead of
+//! creating a new GDI object each time. Objects that are no longer referenced
+//! are kept for reuse until the cache grows beyond its capacity, at which
+//! point the least recently released ones are destroyed.
+//!
+//! Every acquire must be matched by a call to release().
+
+class GDICache /*: private NotCopyable*/
+{
+public:
+	//! The default maximum number of objects kept in the cache.
+	static const size_t DEFAULT_CAPACITY = 128;
+
+	//! Constructor.
+	explicit GDICache(size_t capacity = DEFAULT_CAPACITY);
+
+	//! Destructor.
+	~GDICache();
+
+	//! Get the process-wide cache.
+	static GDICache& instance();
+
+	//
+	// Properties.
+	//
+
+	//! Get the maximum number of objects kept in the cache.
+	size_t capacity() const;
+
+	//! Set the maximum number of objects kept in the cache.
+	void setCapacity(size_t capacity);
+
+	//! Get the number of objects in the cache.
+	size_t size() const;
+
+	//! Get the number of requests satisfied by an existing object.
+	size_t hits() const;
+
+	//! Get the number of requests that created a new object.
+	size_t misses() const;
+
+	//
+	// Methods.
+	//
+
+	//! Acquire a font.
+	HFONT acquireFont(const LOGFONT& logFont);
+
+	//! Acquire a pen.
+	HPEN acquirePen(int style, int width, COLORREF colour);
+
+	//! Acquire a solid brush.
+	HBRUSH acquireBrush(COLORREF colour);
+
+	//! Add a reference to an object acquired from the cache.
+	void addRef(HGDIOBJ handle);
+
+	//! Release an object acquired from the cache.
+	void release(HGDIOBJ handle);
+
+	//! Destroy all the objects that are no longer referenced.
+	void purge();
+
+	//! Reset the hit and miss counters.
+	void resetStats();
+
+private:
+	//! The type of GDI object.
+	enum ObjectType
+	{
+		FONT,
+		PEN,
+		BRUSH,
+	};
+
+	//! The definition of a cached object.
+	struct Key
+	{
+		ObjectType	m_type;		//!< The type of object.
+		int			m_style;	//!< The pen style.
+		int			m_width;	//!< The pen width.
+		COLORREF	m_colour;	//!< The pen or brush colour.
+		LOGFONT		m_font;		//!< The font definition.
+
+		//! Compare two keys.
+		bool operator<(const Key& rhs) const;
+	};
+
+	//! The collection of unreferenced objects, most recently released first.
+	typedef std::list<HGDIOBJ> Unused;
+
+	//! The state of a cached object.
+	struct Entry
+	{
+		Key					m_key;		//!< The definition.
+		size_t				m_refs;		//!< The reference count.
+		Unused::iterator	m_position;	//!< The position in the unused list.
+	};
+
+	//! The map of definition to handle.
+	typedef std::map<Key, HGDIOBJ> Handles;
+	//! The map of handle to cached object.
+	typedef std::map<HGDIOBJ, Entry> Entries;
+
+	//
+	// Members.
+	//
+	mutable CCriticalSection	m_lock;		//!< The lock guarding the cache.
+	size_t						m_capacity;	//!< The maximum number of objects.
+	Handles						m_handles;	//!< The handles by definition.
+	Entries						m_entries;	//!< The objects by handle.
+	Unused						m_unused;	//!< The unreferenced objects.
+	size_t						m_hits;		//!< The number of cache hits.
+	size_t						m_misses;	//!< The number of cache misses.
+
+	//
+	// Internal methods.
+	//
+
+	//! Find or create the object for a definition.
+	HGDIOBJ acquire(const Key& key);
+
+	//! Create a GDI object from its definition.
+	static HGDIOBJ create(const Key& key);
+
+	//! Destroy the least recently released objects until within capacity.
+	void trim(size_t capacity);
+
+	// NotCopyable.
+	GDICache(const GDICache&);
+	GDICache& operator=(const GDICache&);
+};
+
+//namespace WCL
+}
+
+#endif // WCL_GDICACHE_HPP
@@ -11,6 +11,7 @@
 #include "Common.hpp"
 #include "HintBar.hpp"
 #include "StatusBarPanel.hpp"
+#include "StatusBar.hpp"
 #include "DC.hpp"
 #include "App.hpp"
 
@@ -38,6 +39,7 @@ const int INNER_BORDER_SIZE = CStatusBarPanel::BORDER_SIZE;
 
 CHintBar::CHintBar()
 	: m_strHint()
+	, m_pStatusBar(nullptr)
 {
 }
 
@@ -124,8 +126,15 @@ void CHintBar::Hint(const tchar* pszHint)
 
 	m_strHint = pszHint;
 
+	// Ignore, if not created.
+	if (m_hWnd == NULL)
+		return;
+
 	// Redraw.
-	Invalidate();
+	if (m_pStatusBar != nullptr)
+		m_pStatusBar->PanelChanged(*this);
+	else
+		Invalidate();
 }
 
 /******************************************************************************
@@ -18,6 +18,9 @@
 
 #include "CtrlWnd.hpp"
 
+// Forward declarations.
+class CStatusBar;
+
 /******************************************************************************
 ** 
 ** This is a child window used to display hints.
@@ -43,7 +46,8 @@ protected:
 	//
 	// Members.
 	//
-	CString m_strHint;
+	CString		m_strHint;		// The hint text.
+	CStatusBar*	m_pStatusBar;	// The owning status bar, if any.
 	
 	//
 	// Window creation template methods.
@@ -55,6 +59,9 @@ protected:
 	// Message processors.
 	//
 	virtual	void OnPaint(CDC& rDC);
+
+	// Friends.
+	friend class CStatusBar;
 };
 
 /******************************************************************************
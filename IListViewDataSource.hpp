@@ -0,0 +1,48 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   IListViewDataSource.hpp
+//! \brief  The IListViewDataSource interface declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef WCL_ILISTVIEWDATASOURCE_HPP
+#define WCL_ILISTVIEWDATASOURCE_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+namespace WCL
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! The source of the rows displayed by a ListView in virtual (owner-data) mode.
+//! The control only asks for the rows that are visible, so the data is never
+//! copied into the control.
+
+class IListViewDataSource
+{
+public:
+	//! Destructor.
+	virtual ~IListViewDataSource() {};
+
+	//! Get the number of rows.
+	virtual size_t rowCount() const = 0;
+
+	//! Get the text for a cell. The string must remain valid until the next call.
+	virtual const tchar* cellText(size_t row, size_t column) const = 0;
+
+	//! Get the image index for a row, or Core::npos if there is none.
+	virtual size_t rowImage(size_t row) const = 0;
+
+	//! Prepare the rows that are about to be displayed.
+	virtual void cacheHint(size_t first, size_t last) = 0;
+
+	//! Find the first row, starting at the row given, whose first column
+	//! matches the text. Returns Core::npos if there is no match.
+	virtual size_t findRow(const tchar* text, bool partial, size_t start, bool wrap) const = 0;
+};
+
+//namespace WCL
+}
+
+#endif // WCL_ILISTVIEWDATASOURCE_HPP
@@ -0,0 +1,57 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ITreeDataProvider.hpp
+//! \brief  The ITreeDataProvider interface declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef WCL_ITREEDATAPROVIDER_HPP
+#define WCL_ITREEDATAPROVIDER_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include <vector>
+
+namespace WCL
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! The source of the nodes displayed by a LazyTreeView. The children of a node
+//! are only requested when the node is first expanded.
+//!
+//! \note When the tree is populated asynchronously getChildren() is invoked on
+//! a worker thread.
+
+class ITreeDataProvider
+{
+public:
+	//! The type used to identify a node.
+	typedef LPARAM NodeId;
+
+	//! The identifier used to request the top-level nodes.
+	static const NodeId ROOT_NODE = -1;
+
+	//! The details of a single node.
+	struct Node
+	{
+		NodeId	m_id;			//!< The node identifier.
+		tstring	m_text;			//!< The node label.
+		bool	m_hasChildren;	//!< Can the node be expanded?
+		int		m_image;		//!< The image index or -1 for none.
+	};
+
+	//! A collection of nodes.
+	typedef std::vector<Node> Nodes;
+
+	//! Destructor.
+	virtual ~ITreeDataProvider() {};
+
+	//! Get the children of a node.
+	virtual void getChildren(NodeId parent, Nodes& children) = 0;
+};
+
+//namespace WCL
+}
+
+#endif // WCL_ITREEDATAPROVIDER_HPP
@@ -0,0 +1,417 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   IniDocument.cpp
+//! \brief  The IniDocument class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "IniDocument.hpp"
+
+namespace
+{
+
+//! The line terminator used when formatting the document.
+const tchar* EOL = TXT("\r\n");
+
+////////////////////////////////////////////////////////////////////////////////
+//! Remove the leading and trailing whitespace from a string.
+
+tstring trim(const tstring& str)
+{
+	const tchar* whitespace = TXT(" \t");
+
+	size_t first = str.find_first_not_of(whitespace);
+
+	if (first == tstring::npos)
+		return tstring();
+
+	size_t last = str.find_last_not_of(whitespace);
+
+	return str.substr(first, last-first+1);
+}
+
+//namespace
+}
+
+namespace WCL
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Compare two names ignoring case.
+
+bool IniDocument::NameLess::operator()(const tstring& lhs, const tstring& rhs) const
+{
+	return (tstricmp(lhs.c_str(), rhs.c_str()) < 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor.
+
+IniDocument::IniDocument()
+	: m_preamble()
+	, m_sections()
+	, m_index()
+	, m_modified(false)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+IniDocument::~IniDocument()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Replace the document with the parsed text. Lines may be terminated by either
+//! CR/LF or a lone LF.
+
+void IniDocument::parse(const tstring& text)
+{
+	clear();
+
+	Section* current = nullptr;
+	size_t   begin = 0;
+
+	while (begin < text.length())
+	{
+		size_t end = text.find(TXT('\n'), begin);
+
+		if (end == tstring::npos)
+			end = text.length();
+
+		size_t length = end - begin;
+
+		if ( (length != 0) && (text[begin+length-1] == TXT('\r')) )
+			--length;
+
+		tstring line = text.substr(begin, length);
+		tstring trimmed = trim(line);
+
+		begin = end + 1;
+
+		// Start of a new section?
+		if ( (!trimmed.empty()) && (trimmed[0] == TXT('[')) )
+		{
+			size_t close = trimmed.find(TXT(']'));
+
+			if (close == tstring::npos)
+				close = trimmed.length();
+
+			Section section;
+
+			section.m_line = line;
+			section.m_name = trim(trimmed.substr(1, close-1));
+
+			m_sections.push_back(section);
+			current = &m_sections.back();
+			continue;
+		}
+
+		// Before the first section?
+		if (current == nullptr)
+		{
+			m_preamble.push_back(line);
+			continue;
+		}
+
+		Entry entry;
+
+		entry.m_line = line;
+		entry.m_isEntry = false;
+
+		size_t separator = trimmed.find(TXT('='));
+
+		// A key/value pair rather than a comment or blank line?
+		if ( (!trimmed.empty()) && (trimmed[0] != TXT(';')) && (separator != tstring::npos) && (separator != 0) )
+		{
+			entry.m_key = trim(trimmed.substr(0, separator));
+			entry.m_value = unquote(trimmed.substr(separator+1));
+			entry.m_isEntry = true;
+		}
+
+		current->m_entries.push_back(entry);
+	}
+
+	for (Sections::iterator it = m_sections.begin(); it != m_sections.end(); ++it)
+		indexEntries(*it);
+
+	indexSections();
+	m_modified = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Format the document as text. Unmodified lines are written exactly as they
+//! were parsed.
+
+tstring IniDocument::format() const
+{
+	tstring text;
+
+	for (Strings::const_iterator it = m_preamble.begin(); it != m_preamble.end(); ++it)
+	{
+		text += *it;
+		text += EOL;
+	}
+
+	for (Sections::const_iterator section = m_sections.begin(); section != m_sections.end(); ++section)
+	{
+		text += section->m_line;
+		text += EOL;
+
+		for (Entries::const_iterator entry = section->m_entries.begin(); entry != section->m_entries.end(); ++entry)
+		{
+			text += entry->m_line;
+			text += EOL;
+		}
+	}
+
+	return text;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Remove all sections.
+
+void IniDocument::clear()
+{
+	m_modified = (m_modified || !m_preamble.empty() || !m_sections.empty());
+
+	m_preamble.clear();
+	m_sections.clear();
+	m_index.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read the value for a key, if it exists. Where a section or key is duplicated
+//! the first occurrence is used.
+
+bool IniDocument::readString(const tstring& section, const tstring& key, tstring& value) const
+{
+	const Section* found = findSection(section);
+
+	if (found == nullptr)
+		return false;
+
+	KeyIndex::const_iterator it = found->m_index.find(key);
+
+	if (it == found->m_index.end())
+		return false;
+
+	value = found->m_entries[it->second].m_value;
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Write the value for a key, creating the section and key as necessary. A new
+//! key is added after the last non-blank line of the section and a new section
+//! is added to the end of the document.
+
+void IniDocument::writeString(const tstring& section, const tstring& key, const tstring& value)
+{
+	ASSERT(!trim(section).empty());
+	ASSERT(!trim(key).empty());
+
+	Section* found = findSection(section);
+
+	if (found == nullptr)
+	{
+		Section created;
+
+		created.m_line = TXT("[") + section + TXT("]");
+		created.m_name = section;
+
+		m_sections.push_back(created);
+		m_index.insert(SectionIndex::value_type(section, m_sections.size()-1));
+
+		found = &m_sections.back();
+	}
+
+	Entry entry;
+
+	entry.m_line = key + TXT("=") + value;
+	entry.m_key = key;
+	entry.m_value = unquote(value);
+	entry.m_isEntry = true;
+
+	KeyIndex::const_iterator it = found->m_index.find(key);
+
+	// Replace an existing entry?
+	if (it != found->m_index.end())
+	{
+		Entry& existing = found->m_entries[it->second];
+
+		entry.m_key = existing.m_key;
+		entry.m_line = existing.m_key + TXT("=") + value;
+
+		if (existing.m_line == entry.m_line)
+			return;
+
+		existing = entry;
+	}
+	else
+	{
+		Entries& entries = found->m_entries;
+		size_t   position = entries.size();
+
+		// Keep any trailing blank lines after the new entry.
+		while ( (position != 0) && trim(entries[position-1].m_line).empty() )
+			--position;
+
+		entries.insert(entries.begin()+position, entry);
+
+		if (position == entries.size()-1)
+			found->m_index.insert(KeyIndex::value_type(key, position));
+		else
+			indexEntries(*found);
+	}
+
+	m_modified = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Remove a key from a section.
+
+void IniDocument::deleteEntry(const tstring& section, const tstring& key)
+{
+	Section* found = findSection(section);
+
+	if (found == nullptr)
+		return;
+
+	KeyIndex::iterator it = found->m_index.find(key);
+
+	if (it == found->m_index.end())
+		return;
+
+	found->m_entries.erase(found->m_entries.begin()+it->second);
+	indexEntries(*found);
+
+	m_modified = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Remove a section and all its entries.
+
+void IniDocument::deleteSection(const tstring& section)
+{
+	SectionIndex::iterator it = m_index.find(section);
+
+	if (it == m_index.end())
+		return;
+
+	m_sections.erase(m_sections.begin()+it->second);
+	indexSections();
+
+	m_modified = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read the names of all sections, in the order they appear in the document.
+
+size_t IniDocument::readSectionNames(Strings& names) const
+{
+	for (Sections::const_iterator it = m_sections.begin(); it != m_sections.end(); ++it)
+		names.push_back(it->m_name);
+
+	return names.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read the keys and values of all the entries in a section, in the order they
+//! appear in the document.
+
+size_t IniDocument::readSection(const tstring& section, Strings& keys, Strings& values) const
+{
+	const Section* found = findSection(section);
+
+	if (found != nullptr)
+	{
+		for (Entries::const_iterator it = found->m_entries.begin(); it != found->m_entries.end(); ++it)
+		{
+			if (it->m_isEntry)
+			{
+				keys.push_back(it->m_key);
+				values.push_back(it->m_value);
+			}
+		}
+	}
+
+	ASSERT(keys.size() == values.size());
+
+	return keys.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Find a section by name.
+
+const IniDocument::Section* IniDocument::findSection(const tstring& name) const
+{
+	SectionIndex::const_iterator it = m_index.find(name);
+
+	if (it == m_index.end())
+		return nullptr;
+
+	return &m_sections[it->second];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Find a section by name.
+
+IniDocument::Section* IniDocument::findSection(const tstring& name)
+{
+	SectionIndex::const_iterator it = m_index.find(name);
+
+	if (it == m_index.end())
+		return nullptr;
+
+	return &m_sections[it->second];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Rebuild the index of section names. Only the first of any duplicated
+//! sections is indexed.
+
+void IniDocument::indexSections()
+{
+	m_index.clear();
+
+	for (size_t i = 0; i != m_sections.size(); ++i)
+		m_index.insert(SectionIndex::value_type(m_sections[i].m_name, i));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Rebuild the index of key names for a section. Only the first of any
+//! duplicated keys is indexed.
+
+void IniDocument::indexEntries(Section& section)
+{
+	section.m_index.clear();
+
+	for (size_t i = 0; i != section.m_entries.size(); ++i)
+	{
+		const Entry& entry = section.m_entries[i];
+
+		if (entry.m_isEntry)
+			section.m_index.insert(KeyIndex::value_type(entry.m_key, i));
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Remove the surrounding whitespace and any matching quotes from a value.
+
+tstring IniDocument::unquote(const tstring& value)
+{
+	tstring trimmed = trim(value);
+	size_t  length = trimmed.length();
+
+	if ( (length >= 2) && (trimmed[0] == trimmed[length-1])
+	  && ((trimmed[0] == TXT('"')) || (trimmed[0] == TXT('\''))) )
+	{
+		return trimmed.substr(1, length-2);
+	}
+
+	return trimmed;
+}
+
+//namespace WCL
+}
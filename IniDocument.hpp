@@ -0,0 +1,163 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   IniDocument.hpp
+//! \brief  The IniDocument class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef WCL_INIDOCUMENT_HPP
+#define WCL_INIDOCUMENT_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include <vector>
+#include <map>
+
+namespace WCL
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! An in-memory model of the contents of an .ini file. The text is parsed once
+//! into sections and entries which are indexed by name. Comments, blank lines
+//! and the order of the sections and entries are retained so that the document
+//! can be written back out with only the modified lines changed. Section and
+//! key names are case-insensitive, as with the Win32 profile API.
+
+class IniDocument
+{
+public:
+	//! A collection of names or values.
+	typedef std::vector<tstring> Strings;
+
+public:
+	//! Default constructor.
+	IniDocument();
+
+	//! Destructor.
+	~IniDocument();
+
+	//
+	// Properties.
+	//
+
+	//! Query if the document has been modified since it was parsed.
+	bool isModified() const;
+
+	//! Mark the document as saved.
+	void setUnmodified();
+
+	//
+	// Methods.
+	//
+
+	//! Replace the document with the parsed text.
+	void parse(const tstring& text);
+
+	//! Format the document as text.
+	tstring format() const;
+
+	//! Remove all sections.
+	void clear();
+
+	//! Read the value for a key, if it exists.
+	bool readString(const tstring& section, const tstring& key, tstring& value) const;
+
+	//! Write the value for a key, creating the section and key as necessary.
+	void writeString(const tstring& section, const tstring& key, const tstring& value);
+
+	//! Remove a key from a section.
+	void deleteEntry(const tstring& section, const tstring& key);
+
+	//! Remove a section and all its entries.
+	void deleteSection(const tstring& section);
+
+	//! Read the names of all sections.
+	size_t readSectionNames(Strings& names) const;
+
+	//! Read the keys and values of all the entries in a section.
+	size_t readSection(const tstring& section, Strings& keys, Strings& values) const;
+
+private:
+	//! The case-insensitive ordering used for section and key names.
+	struct NameLess
+	{
+		bool operator()(const tstring& lhs, const tstring& rhs) const;
+	};
+
+	//! A line within a section.
+	struct Entry
+	{
+		tstring	m_line;		//!< The raw line text.
+		tstring	m_key;		//!< The key, if the line is an entry.
+		tstring	m_value;	//!< The value, if the line is an entry.
+		bool	m_isEntry;	//!< Is the line a key/value entry?
+	};
+
+	//! The collection of lines within a section.
+	typedef std::vector<Entry> Entries;
+	//! The index of key names to entries.
+	typedef std::map<tstring, size_t, NameLess> KeyIndex;
+
+	//! A section header and its lines.
+	struct Section
+	{
+		tstring		m_line;		//!< The raw header text.
+		tstring		m_name;		//!< The section name.
+		Entries		m_entries;	//!< The lines within the section.
+		KeyIndex	m_index;	//!< The index of keys to entries.
+	};
+
+	//! The collection of sections.
+	typedef std::vector<Section> Sections;
+	//! The index of section names to sections.
+	typedef std::map<tstring, size_t, NameLess> SectionIndex;
+
+	//
+	// Members.
+	//
+	Strings			m_preamble;		//!< The lines before the first section.
+	Sections		m_sections;		//!< The sections in file order.
+	SectionIndex	m_index;		//!< The index of section names to sections.
+	bool			m_modified;		//!< Modified since being parsed?
+
+	//
+	// Internal methods.
+	//
+
+	//! Find a section by name.
+	const Section* findSection(const tstring& name) const;
+
+	//! Find a section by name.
+	Section* findSection(const tstring& name);
+
+	//! Rebuild the index of section names.
+	void indexSections();
+
+	//! Rebuild the index of key names for a section.
+	static void indexEntries(Section& section);
+
+	//! Remove the surrounding whitespace and any quotes from a value.
+	static tstring unquote(const tstring& value);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if the document has been modified since it was parsed.
+
+inline bool IniDocument::isModified() const
+{
+	return m_modified;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Mark the document as saved.
+
+inline void IniDocument::setUnmodified()
+{
+	m_modified = false;
+}
+
+//namespace WCL
+}
+
+#endif // WCL_INIDOCUMENT_HPP
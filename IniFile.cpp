@@ -17,6 +17,7 @@
 #include "Rect.hpp"
 #include <tchar.h>
 #include "Win32Exception.hpp"
+#include "File.hpp"
 #include <malloc.h>
 
 //! The size of the string buffer in characters.
@@ -37,6 +38,9 @@ const size_t MAX_CHARS = 256;
 
 CIniFile::CIniFile()
 	: m_strPath()
+	, m_oDocument()
+	, m_eFormat(ANSI_TEXT)
+	, m_bLoaded(false)
 {
 	tchar szPath[MAX_PATH+1] = { 0 };
 
@@ -81,6 +85,9 @@ CIniFile::CIniFile()
 
 CIniFile::CIniFile(const tchar* pszPath)
 	: m_strPath(pszPath)
+	, m_oDocument()
+	, m_eFormat(ANSI_TEXT)
+	, m_bLoaded(false)
 {
 }
 
@@ -99,13 +106,17 @@ CIniFile::CIniFile(const tchar* pszPath)
 
 CIniFile::CIniFile(const tchar* pszDir, const tchar* pszFile)
 	: m_strPath(pszDir, pszFile)
+	, m_oDocument()
+	, m_eFormat(ANSI_TEXT)
+	, m_bLoaded(false)
 {
 }
 
 /******************************************************************************
 ** Method:		Destructor.
 **
-** Description:	.
+** Description:	Any changes made after a Load() should have been written
+**				with Flush() by now.
 **
 ** Parameters:	None.
 **
@@ -116,6 +127,7 @@ CIniFile::CIniFile(const tchar* pszDir, const tchar* pszFile)
 
 CIniFile::~CIniFile()
 {
+	ASSERT(!m_oDocument.isModified());
 }
 
 /******************************************************************************
@@ -140,20 +152,12 @@ CString CIniFile::ReadString(const tchar* pszSection, const tchar* pszEntry,
 	ASSERT(pszEntry);
 	ASSERT(pszDefault);
 
-	tchar szBuffer[MAX_CHARS+1] = { 0 };
-
-	::GetPrivateProfileString(pszSection, pszEntry, pszDefault, szBuffer, MAX_CHARS, m_strPath);
-
-	return szBuffer;
+	return ReadValue(pszSection, pszEntry, pszDefault).c_str();
 }
 
 tstring CIniFile::ReadString(const tstring& strSection, const tstring& strEntry, const tstring& strDefault) const
 {
-	tchar szBuffer[MAX_CHARS+1] = { 0 };
-
-	::GetPrivateProfileString(strSection.c_str(), strEntry.c_str(), strDefault.c_str(), szBuffer, MAX_CHARS, m_strPath);
-
-	return szBuffer;
+	return ReadValue(strSection.c_str(), strEntry.c_str(), strDefault.c_str());
 }
 
 void CIniFile::WriteString(const tchar* pszSection, const tchar* pszEntry, const tchar* pszValue)
@@ -162,12 +166,12 @@ void CIniFile::WriteString(const tchar* pszSection, const tchar* pszEntry, const
 	ASSERT(pszEntry);
 	ASSERT(pszValue);
 
-	::WritePrivateProfileString(pszSection, pszEntry, pszValue, m_strPath);
+	WriteValue(pszSection, pszEntry, pszValue);
 }
 
 void CIniFile::WriteString(const tstring& strSection, const tstring& strEntry, const tstring& strValue)
 {
-	::WritePrivateProfileString(strSection.c_str(), strEntry.c_str(), strValue.c_str(), m_strPath);
+	WriteValue(strSection.c_str(), strEntry.c_str(), strValue.c_str());
 }
 
 int CIniFile::ReadInt(const tchar* pszSection, const tchar* pszEntry, int nDefault) const
@@ -175,7 +179,17 @@ int CIniFile::ReadInt(const tchar* pszSection, const tchar* pszEntry, int nDefau
 	ASSERT(pszSection);
 	ASSERT(pszEntry);
 
-	return ::GetPrivateProfileInt(pszSection, pszEntry, nDefault, m_strPath);
+	if (!m_bLoaded)
+		return ::GetPrivateProfileInt(pszSection, pszEntry, nDefault, m_strPath);
+
+	tstring strValue = ReadValue(pszSection, pszEntry, TXT(""));
+
+	// Read anything?
+	if (strValue.empty())
+		return nDefault;
+
+	// Convert leniently, as GetPrivateProfileInt() does.
+	return _ttoi(strValue.c_str());
 }
 
 void CIniFile::WriteInt(const tchar* pszSection, const tchar* pszEntry, int iValue)
@@ -183,7 +197,7 @@ void CIniFile::WriteInt(const tchar* pszSection, const tchar* pszEntry, int iVal
 	ASSERT(pszSection);
 	ASSERT(pszEntry);
 
-	::WritePrivateProfileString(pszSection, pszEntry, CStrCvt::FormatInt(iValue), m_strPath);
+	WriteValue(pszSection, pszEntry, CStrCvt::FormatInt(iValue));
 }
 
 uint CIniFile::ReadUInt(const tchar* pszSection, const tchar* pszEntry, uint nDefault) const
@@ -191,17 +205,15 @@ uint CIniFile::ReadUInt(const tchar* pszSection, const tchar* pszEntry, uint nDe
 	ASSERT(pszSection);
 	ASSERT(pszEntry);
 
-	tchar szValue[MAX_CHARS+1] = { 0 };
-
 	// Read as a string.
-	::GetPrivateProfileString(pszSection, pszEntry, TXT(""), szValue, MAX_CHARS, m_strPath);
+	tstring strValue = ReadValue(pszSection, pszEntry, TXT(""));
 
 	// Read anything?
-	if (szValue[0] == TXT('\0'))
+	if (strValue.empty())
 		return nDefault;
 
 	// Convert to value and return
-	return CStrCvt::ParseUInt(szValue);
+	return CStrCvt::ParseUInt(strValue.c_str());
 }
 
 void CIniFile::WriteUInt(const tchar* pszSection, const tchar* pszEntry, uint nValue)
@@ -209,7 +221,7 @@ void CIniFile::WriteUInt(const tchar* pszSection, const tchar* pszEntry, uint nV
 	ASSERT(pszSection);
 	ASSERT(pszEntry);
 
-	::WritePrivateProfileString(pszSection, pszEntry, CStrCvt::FormatUInt(nValue), m_strPath);
+	WriteValue(pszSection, pszEntry, CStrCvt::FormatUInt(nValue));
 }
 
 long CIniFile::ReadLong(const tchar* pszSection, const tchar* pszEntry, long lDefault) const
@@ -217,17 +229,15 @@ long CIniFile::ReadLong(const tchar* pszSection, const tchar* pszEntry, long lDe
 	ASSERT(pszSection);
 	ASSERT(pszEntry);
 
-	tchar szValue[MAX_CHARS+1] = { 0 };
-
 	// Read as a string.
-	::GetPrivateProfileString(pszSection, pszEntry, TXT(""), szValue, MAX_CHARS, m_strPath);
+	tstring strValue = ReadValue(pszSection, pszEntry, TXT(""));
 
 	// Read anything?
-	if (szValue[0] == TXT('\0'))
+	if (strValue.empty())
 		return lDefault;
 
 	// Convert to value and return
-	return CStrCvt::ParseLong(szValue);
+	return CStrCvt::ParseLong(strValue.c_str());
 }
 
 void CIniFile::WriteLong(const tchar* pszSection, const tchar* pszEntry, long lValue)
@@ -235,7 +245,7 @@ void CIniFile::WriteLong(const tchar* pszSection, const tchar* pszEntry, long lV
 	ASSERT(pszSection);
 	ASSERT(pszEntry);
 
-	::WritePrivateProfileString(pszSection, pszEntry, CStrCvt::FormatLong(lValue), m_strPath);
+	WriteValue(pszSection, pszEntry, CStrCvt::FormatLong(lValue));
 }
 
 bool CIniFile::ReadBool(const tchar* pszSection, const tchar* pszEntry, bool bDefault) const
@@ -243,17 +253,15 @@ bool CIniFile::ReadBool(const tchar* pszSection, const tchar* pszEntry, bool bDe
 	ASSERT(pszSection);
 	ASSERT(pszEntry);
 
-	tchar szValue[MAX_CHARS+1] = { 0 };
-
 	// Read as a string.
-	::GetPrivateProfileString(pszSection, pszEntry, TXT(""), szValue, MAX_CHARS, m_strPath);
+	tstring strValue = ReadValue(pszSection, pszEntry, TXT(""));
 
 	// Read anything?
-	if (szValue[0] == TXT('\0'))
+	if (strValue.empty())
 		return bDefault;
 
 	// Check first character.
-	return ( (szValue[0] == TXT('T')) || (szValue[0] == TXT('t')) );
+	return ( (strValue[0] == TXT('T')) || (strValue[0] == TXT('t')) );
 }
 
 bool CIniFile::ReadBool(const tstring& strSection, const tstring& strEntry, bool bDefault) const
@@ -267,9 +275,9 @@ void CIniFile::WriteBool(const tchar* pszSection, const tchar* pszEntry, bool bV
 	ASSERT(pszEntry);
 
 	if (bValue)
-		::WritePrivateProfileString(pszSection, pszEntry, TXT("True"), m_strPath);
+		WriteValue(pszSection, pszEntry, TXT("True"));
 	else
-		::WritePrivateProfileString(pszSection, pszEntry, TXT("False"), m_strPath);
+		WriteValue(pszSection, pszEntry, TXT("False"));
 }
 
 CRect CIniFile::ReadRect(const tchar* pszSection, const tchar* pszEntry, const CRect& rcDefault) const
@@ -299,7 +307,7 @@ void CIniFile::WriteRect(const tchar* pszSection, const tchar* pszEntry, const C
 
 	str.Format(TXT("%ld,%ld,%ld,%ld"), rcValue.left, rcValue.top, rcValue.right, rcValue.bottom);
 
-	::WritePrivateProfileString(pszSection, pszEntry, str, m_strPath);
+	WriteValue(pszSection, pszEntry, str);
 }
 
 /******************************************************************************
@@ -320,7 +328,7 @@ void CIniFile::DeleteEntry(const tchar* pszSection, const tchar* pszEntry)
 	ASSERT(pszSection);
 	ASSERT(pszEntry);
 
-	::WritePrivateProfileString(pszSection, pszEntry, nullptr, m_strPath);
+	WriteValue(pszSection, pszEntry, nullptr);
 }
 
 /******************************************************************************
@@ -403,6 +411,18 @@ void CIniFile::WriteStrings(const tchar* pszSection, const tchar* pszEntry, tcha
 
 size_t CIniFile::ReadSectionNames(CStrArray& astrNames)
 {
+	if (m_bLoaded)
+	{
+		WCL::IniDocument::Strings vNames;
+
+		m_oDocument.readSectionNames(vNames);
+
+		for (size_t i = 0; i != vNames.size(); ++i)
+			astrNames.Add(vNames[i].c_str());
+
+		return astrNames.Size();
+	}
+
 	// Allocate initial buffer.
 	size_t nChars   = 1024;
 	tchar* pszNames = static_cast<tchar*>(alloca(Core::numBytes<tchar>(nChars+1)));
@@ -442,6 +462,18 @@ size_t CIniFile::ReadSection(const tchar* pszSection, CStrArray& astrEntries)
 {
 	ASSERT(pszSection);
 
+	if (m_bLoaded)
+	{
+		WCL::IniDocument::Strings vKeys, vValues;
+
+		m_oDocument.readSection(pszSection, vKeys, vValues);
+
+		for (size_t i = 0; i != vKeys.size(); ++i)
+			astrEntries.Add((vKeys[i] + TXT("=") + vValues[i]).c_str());
+
+		return astrEntries.Size();
+	}
+
 	// Allocate initial buffer.
 	size_t nChars     = 1024;
 	tchar* pszEntries = static_cast<tchar*>(alloca(Core::numBytes<tchar>(nChars+1)));
@@ -525,5 +557,172 @@ void CIniFile::DeleteSection(const tchar* pszSection)
 {
 	ASSERT(pszSection);
 
-	::WritePrivateProfileString(pszSection, nullptr, nullptr, m_strPath);
+	WriteValue(pszSection, nullptr, nullptr);
+}
+
+/******************************************************************************
+** Method:		Load()
+**
+** Description:	Parses the entire file into memory. Subsequent reads and writes
+**				use the in-memory copy until Unload() is called. A missing
+**				file is treated as empty.
+**
+** Parameters:	None.
+**
+** Returns:		Nothing.
+**
+** Exceptions:	CFileException on error.
+**
+*******************************************************************************
+*/
+
+void CIniFile::Load()
+{
+	tstring strContents;
+
+	m_eFormat = ANSI_TEXT;
+
+	if (m_strPath.Exists())
+	{
+		CString str;
+
+		size_t nChars = CFile::ReadTextFile(m_strPath, str, m_eFormat);
+
+		strContents.assign(str.Buffer(), str.Buffer()+nChars);
+	}
+
+	m_oDocument.parse(strContents);
+	m_bLoaded = true;
+}
+
+/******************************************************************************
+** Method:		Flush()
+**
+** Description:	Writes any changes made to the in-memory copy back to the file.
+**				The contents are written to a temporary file first which then
+**				replaces the original, so that the file is never left partially
+**				written.
+**
+** Parameters:	None.
+**
+** Returns:		Nothing.
+**
+** Exceptions:	CFileException or WCL::Win32Exception on error.
+**
+*******************************************************************************
+*/
+
+void CIniFile::Flush()
+{
+	ASSERT(m_bLoaded);
+
+	if (!m_oDocument.isModified())
+		return;
+
+	CString strTempPath = CString(m_strPath) + TXT(".tmp");
+
+	CFile::WriteTextFile(strTempPath, m_oDocument.format().c_str(), m_eFormat);
+
+	if (!::MoveFileEx(strTempPath, m_strPath, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+	{
+		DWORD dwError = ::GetLastError();
+
+		CFile::Delete(strTempPath);
+
+		throw WCL::Win32Exception(dwError, TXT("Failed to replace the .ini file"));
+	}
+
+	m_oDocument.setUnmodified();
+}
+
+/******************************************************************************
+** Method:		Unload()
+**
+** Description:	Discards the in-memory copy, including any changes which have
+**				not been flushed, and reverts to using the Win32 profile API.
+**
+** Parameters:	None.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CIniFile::Unload()
+{
+	m_oDocument.clear();
+	m_oDocument.setUnmodified();
+	m_bLoaded = false;
+}
+
+/******************************************************************************
+** Method:		ReadValue()
+**
+** Description:	Reads an entry either from the in-memory copy, if loaded, or
+**				from the file.
+**
+** Parameters:	pszSection		The [..] section heading.
+**				pszEntry		The ?= entry name.
+**				pszDefault		The default value.
+**
+** Returns:		The value or the default.
+**
+*******************************************************************************
+*/
+
+tstring CIniFile::ReadValue(const tchar* pszSection, const tchar* pszEntry, const tchar* pszDefault) const
+{
+	ASSERT(pszSection != nullptr);
+	ASSERT(pszEntry   != nullptr);
+	ASSERT(pszDefault != nullptr);
+
+	if (m_bLoaded)
+	{
+		tstring strValue;
+
+		if (!m_oDocument.readString(pszSection, pszEntry, strValue))
+			strValue = pszDefault;
+
+		return strValue;
+	}
+
+	tchar szBuffer[MAX_CHARS+1] = { 0 };
+
+	::GetPrivateProfileString(pszSection, pszEntry, pszDefault, szBuffer, MAX_CHARS, m_strPath);
+
+	return szBuffer;
+}
+
+/******************************************************************************
+** Method:		WriteValue()
+**
+** Description:	Writes an entry either to the in-memory copy, if loaded, or to
+**				the file. As with WritePrivateProfileString() a null value
+**				deletes the entry and a null entry deletes the section.
+**
+** Parameters:	pszSection		The [..] section heading.
+**				pszEntry		The ?= entry name or nullptr.
+**				pszValue		The value or nullptr.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CIniFile::WriteValue(const tchar* pszSection, const tchar* pszEntry, const tchar* pszValue)
+{
+	ASSERT(pszSection != nullptr);
+
+	if (!m_bLoaded)
+	{
+		::WritePrivateProfileString(pszSection, pszEntry, pszValue, m_strPath);
+		return;
+	}
+
+	if (pszEntry == nullptr)
+		m_oDocument.deleteSection(pszSection);
+	else if (pszValue == nullptr)
+		m_oDocument.deleteEntry(pszSection, pszEntry);
+	else
+		m_oDocument.writeString(pszSection, pszEntry, pszValue);
 }
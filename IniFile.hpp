@@ -17,6 +17,7 @@
 #endif
 
 #include "Path.hpp"
+#include "IniDocument.hpp"
 
 // Forward declarations.
 class CRect;
@@ -24,6 +25,9 @@ class CRect;
 /******************************************************************************
 ** 
 ** This class encapsulates the behaviour of accessing a Windows .INI file.
+** By default every read and write goes through the Win32 profile API. After
+** calling Load() the file is parsed once and then read and written in memory
+** until the changes are saved, in one go, with Flush().
 **
 *******************************************************************************
 */
@@ -75,10 +79,34 @@ public:
 	size_t ReadSection(const tchar* pszSection, CStrArray& astrKeys, CStrArray& astrValues);
 	void DeleteSection(const tchar* pszSection);
 
+	//
+	// In-memory access methods.
+	//
+	void Load();
+	void Flush();
+	void Unload();
+
+	bool IsLoaded() const;
+	bool IsModified() const;
+
 	//
 	// Members.
 	//
 	CPath	m_strPath;
+
+private:
+	//
+	// Internal members.
+	//
+	WCL::IniDocument	m_oDocument;	//!< The parsed contents, when loaded.
+	TextFormat			m_eFormat;		//!< The text format of the loaded file.
+	bool				m_bLoaded;		//!< Has the file been loaded?
+
+	//
+	// Internal methods.
+	//
+	tstring ReadValue(const tchar* pszSection, const tchar* pszEntry, const tchar* pszDefault) const;
+	void    WriteValue(const tchar* pszSection, const tchar* pszEntry, const tchar* pszValue);
 };
 
 /******************************************************************************
@@ -88,4 +116,14 @@ public:
 *******************************************************************************
 */
 
+inline bool CIniFile::IsLoaded() const
+{
+	return m_bLoaded;
+}
+
+inline bool CIniFile::IsModified() const
+{
+	return m_oDocument.isModified();
+}
+
 #endif //INIFILE_HPP
@@ -0,0 +1,130 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   JobFuture.cpp
+//! \brief  The JobFuture class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "JobFuture.hpp"
+#include "ThreadPool.hpp"
+#include "MsgThread.hpp"
+
+namespace WCL
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor.
+
+JobFuture::JobFuture()
+	: m_job()
+	, m_pool(nullptr)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from a job and the pool it is queued on. The pool is null for
+//! a job run on a message thread.
+
+JobFuture::JobFuture(const ThreadJobPtr& job, CThreadPool* pool)
+	: m_job(job)
+	, m_pool(pool)
+{
+	ASSERT(m_job.get() != nullptr);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if the job has completed or been cancelled.
+
+bool JobFuture::isFinished() const
+{
+	ASSERT(m_job.get() != nullptr);
+
+	return m_job->IsFinished();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if the job ran to completion.
+
+bool JobFuture::isCompleted() const
+{
+	ASSERT(m_job.get() != nullptr);
+
+	return (m_job->Status() == CThreadJob::COMPLETED);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if the job was cancelled.
+
+bool JobFuture::isCancelled() const
+{
+	ASSERT(m_job.get() != nullptr);
+
+	return (m_job->Status() == CThreadJob::CANCELLED);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Wait for the job to complete or be cancelled. Returns false if the wait
+//! timed out.
+
+bool JobFuture::wait(DWORD timeout) const
+{
+	ASSERT(m_job.get() != nullptr);
+
+	return m_job->Wait(timeout);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Cancel the job, if it has not started running. Any jobs that continue from
+//! it are cancelled too. Returns true if the job is now cancelled.
+
+bool JobFuture::cancel()
+{
+	ASSERT(m_job.get() != nullptr);
+
+	// Remove it from the pending queue, if queued.
+	if (m_pool != nullptr)
+		m_pool->CancelJob(m_job);
+
+	// Still waiting for the job it continues from?
+	m_job->Cancel();
+
+	return isCancelled();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Run another job on the same pool once this one has finished.
+
+JobFuture JobFuture::then(ThreadJobPtr& next) const
+{
+	ASSERT(m_pool != nullptr);
+
+	return then(next, *m_pool);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Run another job on a pool once this one has finished. If this job is
+//! cancelled the next one is cancelled too.
+
+JobFuture JobFuture::then(ThreadJobPtr& next, CThreadPool& pool) const
+{
+	ASSERT(m_job.get() != nullptr);
+
+	m_job->ContinueWith(next, pool);
+
+	return JobFuture(next, &pool);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Run another job on a message thread once this one has finished, e.g. to
+//! display the result. If this job is cancelled the next one is cancelled too.
+
+JobFuture JobFuture::then(ThreadJobPtr& next, CMsgThread& thread) const
+{
+	ASSERT(m_job.get() != nullptr);
+
+	m_job->ContinueWith(next, thread);
+
+	return JobFuture(next, nullptr);
+}
+
+//namespace WCL
+}
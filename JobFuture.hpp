@@ -0,0 +1,88 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   JobFuture.hpp
+//! \brief  The JobFuture class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef WCL_JOBFUTURE_HPP
+#define WCL_JOBFUTURE_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "ThreadJob.hpp"
+
+namespace WCL
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A handle to a job that has been queued on a thread pool. It can be used to
+//! wait for the job to finish, to cancel it, or to queue further jobs that run
+//! once it has finished, without polling the pool's completed queue. Any
+//! result should be stored in the job itself.
+
+class JobFuture
+{
+public:
+	//! Default constructor.
+	JobFuture();
+
+	//! Construction from a job and the pool it is queued on.
+	JobFuture(const ThreadJobPtr& job, CThreadPool* pool);
+
+	//
+	// Properties.
+	//
+
+	//! Get the job.
+	const ThreadJobPtr& job() const;
+
+	//! Query if the job has completed or been cancelled.
+	bool isFinished() const;
+
+	//! Query if the job ran to completion.
+	bool isCompleted() const;
+
+	//! Query if the job was cancelled.
+	bool isCancelled() const;
+
+	//
+	// Methods.
+	//
+
+	//! Wait for the job to complete or be cancelled.
+	bool wait(DWORD timeout = INFINITE) const;
+
+	//! Cancel the job, if it has not started running.
+	bool cancel();
+
+	//! Run another job on the same pool once this one has finished.
+	JobFuture then(ThreadJobPtr& next) const;
+
+	//! Run another job on a pool once this one has finished.
+	JobFuture then(ThreadJobPtr& next, CThreadPool& pool) const;
+
+	//! Run another job on a message thread once this one has finished.
+	JobFuture then(ThreadJobPtr& next, CMsgThread& thread) const;
+
+private:
+	//
+	// Members.
+	//
+	ThreadJobPtr	m_job;		//!< The job.
+	CThreadPool*	m_pool;		//!< The pool it runs on, if any.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the job.
+
+inline const ThreadJobPtr& JobFuture::job() const
+{
+	return m_job;
+}
+
+//namespace WCL
+}
+
+#endif // WCL_JOBFUTURE_HPP
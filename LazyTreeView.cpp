@@ -0,0 +1,495 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   LazyTreeView.cpp
+//! \brief  The LazyTreeView class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "LazyTreeView.hpp"
+#include "ThreadPool.hpp"
+#include <commctrl.h>
+
+#if (__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 2)) // GCC 4.2+
+// missing initializer for member 'X'
+#pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+#endif
+
+namespace WCL
+{
+
+namespace
+{
+
+//! The text shown while the children are being fetched.
+const tchar* PLACEHOLDER_TEXT = TXT("Loading...");
+
+////////////////////////////////////////////////////////////////////////////////
+//! The job used to fetch the children of a node on a worker thread. The tree
+//! is notified by posting it a message when the job has finished.
+
+class FetchChildrenJob : public CThreadJob
+{
+public:
+	//! Constructor.
+	FetchChildrenJob(ITreeDataProvider* provider, ITreeDataProvider::NodeId node, HTREEITEM item,
+					HWND hWnd, uint message, uint request)
+		: m_provider(provider)
+		, m_node(node)
+		, m_item(item)
+		, m_hWnd(hWnd)
+		, m_message(message)
+		, m_request(request)
+		, m_children()
+		, m_failed(false)
+	{
+	}
+
+	//! Fetch the children.
+	virtual void Run()
+	{
+		try
+		{
+			m_provider->getChildren(m_node, m_children);
+		}
+		catch (...)
+		{
+			m_failed = true;
+			::PostMessage(m_hWnd, m_message, m_request, 0);
+			throw;
+		}
+
+		::PostMessage(m_hWnd, m_message, m_request, 0);
+	}
+
+	//
+	// Members.
+	//
+	ITreeDataProvider*			m_provider;	//!< The source of the nodes.
+	ITreeDataProvider::NodeId	m_node;		//!< The node to fetch the children of.
+	HTREEITEM					m_item;		//!< The tree item for the node.
+	HWND						m_hWnd;		//!< The tree to notify.
+	uint						m_message;	//!< The notification message.
+	uint						m_request;	//!< The request identifier.
+	ITreeDataProvider::Nodes	m_children;	//!< The fetched children.
+	bool						m_failed;	//!< Did the fetch throw?
+};
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor.
+
+LazyTreeView::LazyTreeView()
+	: m_provider(nullptr)
+	, m_pool(nullptr)
+	, m_maxNodes(0)
+	, m_items()
+	, m_collapsed()
+	, m_requests()
+	, m_nextRequest(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+LazyTreeView::~LazyTreeView()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Set the source of the nodes. The provider must outlive any fetches that are
+//! still running on the thread pool.
+
+void LazyTreeView::setProvider(ITreeDataProvider* provider)
+{
+	m_provider = provider;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Set the thread pool used to fetch children, or nullptr to fetch them inline.
+//! The completed jobs are left in the pool's completed queue.
+
+void LazyTreeView::setThreadPool(CThreadPool* pool)
+{
+	m_pool = pool;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Set the maximum number of nodes to keep in the control, or 0 for no limit.
+//! The budget is enforced when more children are about to be inserted.
+
+void LazyTreeView::setNodeBudget(size_t maxNodes)
+{
+	m_maxNodes = maxNodes;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of nodes in the control.
+
+size_t LazyTreeView::nodeCount() const
+{
+	ASSERT(m_hWnd != NULL);
+
+	return TreeView_GetCount(m_hWnd);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the identifier of the node for a tree item.
+
+ITreeDataProvider::NodeId LazyTreeView::nodeId(HTREEITEM item) const
+{
+	ASSERT(m_hWnd != NULL);
+	ASSERT(item != NULL);
+
+	TVITEM oItem = { 0 };
+
+	oItem.mask  = TVIF_PARAM;
+	oItem.hItem = item;
+
+	(void)TreeView_GetItem(m_hWnd, &oItem);
+
+	return oItem.lParam;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Replace the contents of the tree with the top-level nodes. These are always
+//! fetched inline.
+
+void LazyTreeView::populate()
+{
+	ASSERT(m_hWnd != NULL);
+	ASSERT(m_provider != nullptr);
+
+	Clear();
+
+	m_requests.clear();
+
+	ITreeDataProvider::Nodes roots;
+
+	m_provider->getChildren(ITreeDataProvider::ROOT_NODE, roots);
+
+	insertChildren(TVI_ROOT, roots);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Window procedure. Handles the message posted when a fetch has completed.
+
+LRESULT LazyTreeView::WndProc(HWND hWnd, UINT iMsg, WPARAM wParam, LPARAM lParam)
+{
+	if (iMsg == fetchedMsg())
+	{
+		onChildrenFetched(static_cast<uint>(wParam));
+
+		MsgHandled(true);
+		MsgResult (0);
+		return 0;
+	}
+
+	return TreeView::WndProc(hWnd, iMsg, wParam, lParam);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Handle the reflected tree notifications.
+
+bool LazyTreeView::OnReflectedNfyMsg(NMHDR& rMsgHdr, LRESULT& lResult)
+{
+	if (m_provider != nullptr)
+	{
+		switch (rMsgHdr.code)
+		{
+			case TVN_ITEMEXPANDING:
+				onItemExpanding(reinterpret_cast<NMTREEVIEW&>(rMsgHdr));
+				break;
+
+			case TVN_ITEMEXPANDED:
+				onItemExpanded(reinterpret_cast<NMTREEVIEW&>(rMsgHdr));
+				break;
+
+			case TVN_DELETEITEM:
+				onDeleteItem(reinterpret_cast<NMTREEVIEW&>(rMsgHdr));
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	return TreeView::OnReflectedNfyMsg(rMsgHdr, lResult);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Handle an item about to be expanded. The children are fetched the first
+//! time the item is expanded.
+
+void LazyTreeView::onItemExpanding(const NMTREEVIEW& message)
+{
+	if ((message.action & TVE_EXPAND) == 0)
+		return;
+
+	Items::iterator it = m_items.find(message.itemNew.hItem);
+
+	if (it == m_items.end())
+		return;
+
+	ItemState& state = it->second;
+
+	removeCollapsed(state);
+
+	if ( (!state.m_populated) && (state.m_request == 0) )
+		fetchChildren(it->first, state);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Handle an item that has been expanded or collapsed. Collapsed items with
+//! children become candidates for eviction.
+
+void LazyTreeView::onItemExpanded(const NMTREEVIEW& message)
+{
+	Items::iterator it = m_items.find(message.itemNew.hItem);
+
+	if (it == m_items.end())
+		return;
+
+	ItemState& state = it->second;
+
+	removeCollapsed(state);
+
+	if ( (message.action & TVE_COLLAPSE) && (state.m_populated || (state.m_request != 0)) )
+	{
+		m_collapsed.push_front(it->first);
+
+		state.m_collapsed = true;
+		state.m_position  = m_collapsed.begin();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Handle an item being deleted. Any pending fetch for it is abandoned.
+
+void LazyTreeView::onDeleteItem(const NMTREEVIEW& message)
+{
+	Items::iterator it = m_items.find(message.itemOld.hItem);
+
+	if (it == m_items.end())
+		return;
+
+	ItemState& state = it->second;
+
+	removeCollapsed(state);
+
+	if (state.m_request != 0)
+		m_requests.erase(state.m_request);
+
+	m_items.erase(it);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Handle the children fetched on a worker thread. The result is ignored if
+//! the item has since been deleted or its children evicted.
+
+void LazyTreeView::onChildrenFetched(uint request)
+{
+	Requests::iterator requestIter = m_requests.find(request);
+
+	if (requestIter == m_requests.end())
+		return;
+
+	ThreadJobPtr job = requestIter->second;
+
+	m_requests.erase(requestIter);
+
+	FetchChildrenJob* fetch = static_cast<FetchChildrenJob*>(job.get());
+
+	// Make room first as it may remove the item itself.
+	if (!fetch->m_failed)
+		enforceBudget(fetch->m_children.size());
+
+	Items::iterator it = m_items.find(fetch->m_item);
+
+	if ( (it == m_items.end()) || (it->second.m_request != request) )
+		return;
+
+	ItemState& state = it->second;
+
+	if (state.m_placeholder != NULL)
+		(void)TreeView_DeleteItem(m_hWnd, state.m_placeholder);
+
+	state.m_request     = 0;
+	state.m_placeholder = NULL;
+
+	if (fetch->m_failed)
+	{
+		// Allow the user to try again.
+		(void)TreeView_Expand(m_hWnd, fetch->m_item, TVE_COLLAPSE | TVE_COLLAPSERESET);
+		setHasChildren(fetch->m_item, true);
+		return;
+	}
+
+	insertChildren(fetch->m_item, fetch->m_children);
+
+	state.m_populated = true;
+
+	if (fetch->m_children.empty())
+		setHasChildren(fetch->m_item, false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Fetch the children of an item, either inline or on the thread pool.
+
+void LazyTreeView::fetchChildren(HTREEITEM item, ItemState& state)
+{
+	ASSERT(!state.m_populated);
+	ASSERT(state.m_request == 0);
+
+	if (m_pool == nullptr)
+	{
+		ITreeDataProvider::Nodes children;
+
+		m_provider->getChildren(nodeId(item), children);
+
+		enforceBudget(children.size());
+		insertChildren(item, children);
+
+		state.m_populated = true;
+
+		if (children.empty())
+			setHasChildren(item, false);
+
+		return;
+	}
+
+	if (++m_nextRequest == 0)
+		++m_nextRequest;
+
+	const uint request = m_nextRequest;
+
+	state.m_placeholder = InsertItem(item, TVI_LAST, PLACEHOLDER_TEXT);
+	state.m_request     = request;
+
+	ThreadJobPtr job(new FetchChildrenJob(m_provider, nodeId(item), item, m_hWnd, fetchedMsg(), request));
+
+	m_requests[request] = job;
+	m_pool->AddJob(job);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Insert the children of an item. Redrawing is disabled while the items are
+//! inserted so that the control is only repainted once.
+
+void LazyTreeView::insertChildren(HTREEITEM parent, const ITreeDataProvider::Nodes& children)
+{
+	typedef ITreeDataProvider::Nodes::const_iterator NodeIter;
+
+	if (children.empty())
+		return;
+
+	Redraw(false);
+
+	for (NodeIter it = children.begin(); it != children.end(); ++it)
+	{
+		TVINSERTSTRUCT oItem = { 0 };
+
+		oItem.hParent        = parent;
+		oItem.hInsertAfter   = TVI_LAST;
+		oItem.item.mask      = TVIF_TEXT | TVIF_CHILDREN | TVIF_PARAM;
+		oItem.item.pszText   = const_cast<tchar*>(it->m_text.c_str());
+		oItem.item.cChildren = it->m_hasChildren ? 1 : 0;
+		oItem.item.lParam    = it->m_id;
+
+		if (it->m_image != -1)
+		{
+			oItem.item.mask          |= TVIF_IMAGE | TVIF_SELECTEDIMAGE;
+			oItem.item.iImage         = it->m_image;
+			oItem.item.iSelectedImage = it->m_image;
+		}
+
+		HTREEITEM item = TreeView_InsertItem(m_hWnd, &oItem);
+
+		if ( (item != NULL) && (it->m_hasChildren) )
+		{
+			ItemState state = { false, 0, NULL, false, m_collapsed.end() };
+
+			m_items[item] = state;
+		}
+	}
+
+	Redraw(true);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Mark whether an item can be expanded.
+
+void LazyTreeView::setHasChildren(HTREEITEM item, bool hasChildren)
+{
+	TVITEM oItem = { 0 };
+
+	oItem.mask      = TVIF_CHILDREN;
+	oItem.hItem     = item;
+	oItem.cChildren = hasChildren ? 1 : 0;
+
+	(void)TreeView_SetItem(m_hWnd, &oItem);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Remove an item from the collapsed list.
+
+void LazyTreeView::removeCollapsed(ItemState& state)
+{
+	if (state.m_collapsed)
+	{
+		m_collapsed.erase(state.m_position);
+
+		state.m_collapsed = false;
+		state.m_position  = m_collapsed.end();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Remove the children of the least recently collapsed items until there is
+//! room for the additional nodes, or there is nothing left to remove. The
+//! evicted items are fetched again when next expanded.
+
+void LazyTreeView::enforceBudget(size_t additionalNodes)
+{
+	if (m_maxNodes == 0)
+		return;
+
+	while ( (!m_collapsed.empty()) && ((nodeCount() + additionalNodes) > m_maxNodes) )
+	{
+		HTREEITEM       victim = m_collapsed.back();
+		Items::iterator it     = m_items.find(victim);
+
+		ASSERT(it != m_items.end());
+
+		removeCollapsed(it->second);
+
+		// Abandon any pending fetch.
+		if (it->second.m_request != 0)
+		{
+			m_requests.erase(it->second.m_request);
+
+			it->second.m_request     = 0;
+			it->second.m_placeholder = NULL;
+		}
+
+		it->second.m_populated = false;
+
+		// Deletes the children, which are then removed from the item map.
+		(void)TreeView_Expand(m_hWnd, victim, TVE_COLLAPSE | TVE_COLLAPSERESET);
+
+		setHasChildren(victim, true);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the message used to signal a completed fetch.
+
+uint LazyTreeView::fetchedMsg()
+{
+	static uint s_message = ::RegisterWindowMessage(TXT("WCL::LazyTreeView::ChildrenFetched"));
+
+	return s_message;
+}
+
+//namespace WCL
+}
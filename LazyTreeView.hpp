@@ -0,0 +1,150 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   LazyTreeView.hpp
+//! \brief  The LazyTreeView class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef WCL_LAZYTREEVIEW_HPP
+#define WCL_LAZYTREEVIEW_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "TreeView.hpp"
+#include "ITreeDataProvider.hpp"
+#include "ThreadJob.hpp"
+#include <map>
+#include <list>
+
+// Forward declarations.
+class CThreadPool;
+
+namespace WCL
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A TreeView whose nodes are supplied by a data provider and only inserted
+//! when their parent is first expanded. The children can be fetched on a thread
+//! pool, in which case a placeholder is shown until they arrive. A budget can
+//! be set on the number of nodes in the control, in which case the children of
+//! the least recently collapsed nodes are removed to stay within it.
+//!
+//! \note The expansion notifications are reflected by the parent window, so the
+//! parent must be a CMsgWnd.
+
+class LazyTreeView : public TreeView
+{
+public:
+	//! Default constructor.
+	LazyTreeView();
+
+	//! Destructor.
+	virtual	~LazyTreeView();
+
+	//
+	// Properties.
+	//
+
+	//! Set the source of the nodes.
+	void setProvider(ITreeDataProvider* provider);
+
+	//! Set the thread pool used to fetch children, or nullptr to fetch them inline.
+	void setThreadPool(CThreadPool* pool);
+
+	//! Set the maximum number of nodes to keep in the control, or 0 for no limit.
+	void setNodeBudget(size_t maxNodes);
+
+	//! Get the number of nodes in the control.
+	size_t nodeCount() const;
+
+	//! Get the identifier of the node for a tree item.
+	ITreeDataProvider::NodeId nodeId(HTREEITEM item) const;
+
+	//
+	// Methods.
+	//
+
+	//! Replace the contents of the tree with the top-level nodes.
+	void populate();
+
+protected:
+	//
+	// Message handlers.
+	//
+
+	//! Window procedure.
+	virtual LRESULT WndProc(HWND hWnd, UINT iMsg, WPARAM wParam, LPARAM lParam);
+
+	//! Handle the reflected tree notifications.
+	virtual bool OnReflectedNfyMsg(NMHDR& rMsgHdr, LRESULT& lResult);
+
+private:
+	//! The collection of collapsed items, most recently collapsed first.
+	typedef std::list<HTREEITEM> Collapsed;
+
+	//! The state of an item that can be expanded.
+	struct ItemState
+	{
+		bool				m_populated;	//!< Have the children been inserted?
+		uint				m_request;		//!< The pending fetch, if any.
+		HTREEITEM			m_placeholder;	//!< The placeholder shown during a fetch.
+		bool				m_collapsed;	//!< Is the item in the collapsed list?
+		Collapsed::iterator	m_position;		//!< The position in the collapsed list.
+	};
+
+	//! The collection of expandable items.
+	typedef std::map<HTREEITEM, ItemState> Items;
+	//! The collection of pending fetches.
+	typedef std::map<uint, ThreadJobPtr> Requests;
+
+	//
+	// Members.
+	//
+	ITreeDataProvider*	m_provider;		//!< The source of the nodes.
+	CThreadPool*		m_pool;			//!< The pool for fetching children.
+	size_t				m_maxNodes;		//!< The node budget.
+	Items				m_items;		//!< The expandable items.
+	Collapsed			m_collapsed;	//!< The collapsed items that have children.
+	Requests			m_requests;		//!< The pending fetches.
+	uint				m_nextRequest;	//!< The identifier for the next fetch.
+
+	//
+	// Internal methods.
+	//
+
+	//! Handle an item about to be expanded or collapsed.
+	void onItemExpanding(const NMTREEVIEW& message);
+
+	//! Handle an item that has been expanded or collapsed.
+	void onItemExpanded(const NMTREEVIEW& message);
+
+	//! Handle an item being deleted.
+	void onDeleteItem(const NMTREEVIEW& message);
+
+	//! Handle the children fetched on a worker thread.
+	void onChildrenFetched(uint request);
+
+	//! Fetch the children of an item.
+	void fetchChildren(HTREEITEM item, ItemState& state);
+
+	//! Insert the children of an item.
+	void insertChildren(HTREEITEM parent, const ITreeDataProvider::Nodes& children);
+
+	//! Mark whether an item can be expanded.
+	void setHasChildren(HTREEITEM item, bool hasChildren);
+
+	//! Remove an item from the collapsed list.
+	void removeCollapsed(ItemState& state);
+
+	//! Remove the children of the least recently collapsed items.
+	void enforceBudget(size_t additionalNodes);
+
+	//! Get the message used to signal a completed fetch.
+	static uint fetchedMsg();
+};
+
+//namespace WCL
+}
+
+#endif // WCL_LAZYTREEVIEW_HPP
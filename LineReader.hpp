@@ -0,0 +1,288 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   LineReader.hpp
+//! \brief  The LineReader class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef WCL_LINEREADER_HPP
+#define WCL_LINEREADER_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "IInputStream.hpp"
+#include <Core/AnsiWide.hpp>
+#include <vector>
+#include <algorithm>
+#include <string.h>
+#include <wchar.h>
+
+namespace WCL
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A buffered reader for the lines of text in a stream of ANSI (char) or
+//! Unicode (wchar_t) characters. The stream is read in large blocks and each
+//! block is scanned for the line terminators, which may be CR, LF or CR/LF.
+//! The lines can be read as views onto the internal buffer, which avoids any
+//! copying, or converted to the build's string type.
+//!
+//! Unlike CStream::ReadLine() the reader consumes the stream ahead of the
+//! lines returned. The stream must also support seeking as it is used to
+//! determine the number of bytes remaining when the reader is created.
+
+template<typename CharT>
+class LineReader
+{
+public:
+	//! The default size of the blocks read from the stream, in characters.
+	static const size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+public:
+	//! Constructor.
+	LineReader(IInputStream& stream, size_t blockSize = DEFAULT_BLOCK_SIZE);
+
+	//
+	// Properties.
+	//
+
+	//! Query if there are no more lines to read.
+	bool isEOF() const;
+
+	//
+	// Methods.
+	//
+
+	//! Read the next line as a view onto the internal buffer.
+	bool readLine(const CharT*& begin, const CharT*& end);
+
+	//! Read the next line converted to the build's character type.
+	bool readLine(tstring& line);
+
+private:
+	//
+	// Members.
+	//
+	IInputStream&		m_stream;		//!< The underlying stream.
+	StreamPos			m_remaining;	//!< The number of bytes left in the stream.
+	std::vector<CharT>	m_buffer;		//!< The block buffer.
+	size_t				m_next;			//!< The start of the unread characters.
+	size_t				m_end;			//!< The end of the unread characters.
+
+	//
+	// Internal methods.
+	//
+
+	//! Read the next block from the stream.
+	void readBlock();
+
+	//! Find the next line terminator in the unread characters.
+	const CharT* findTerminator(const CharT* begin, const CharT* end) const;
+
+	// NotCopyable.
+	LineReader(const LineReader&);
+	LineReader& operator=(const LineReader&);
+};
+
+//! The reader for ANSI text.
+typedef LineReader<char> AnsiLineReader;
+//! The reader for Unicode text.
+typedef LineReader<wchar_t> UnicodeLineReader;
+
+namespace Detail
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Find a character in a range of ANSI characters.
+
+inline const char* findChar(const char* begin, const char* end, char c)
+{
+	const void* found = memchr(begin, c, end - begin);
+
+	return (found != nullptr) ? static_cast<const char*>(found) : end;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Find a character in a range of Unicode characters.
+
+inline const wchar_t* findChar(const wchar_t* begin, const wchar_t* end, wchar_t c)
+{
+	const wchar_t* found = wmemchr(begin, c, end - begin);
+
+	return (found != nullptr) ? found : end;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Convert a range of ANSI characters to the build's string type.
+
+inline void convertLine(const char* begin, const char* end, tstring& line)
+{
+#ifdef ANSI_BUILD
+	line.assign(begin, end);
+#else
+	line = Core::ansiToWide(begin, end);
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Convert a range of Unicode characters to the build's string type.
+
+inline void convertLine(const wchar_t* begin, const wchar_t* end, tstring& line)
+{
+#ifdef ANSI_BUILD
+	line = Core::wideToAnsi(begin, end);
+#else
+	line.assign(begin, end);
+#endif
+}
+
+//namespace Detail
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Constructor.
+
+template<typename CharT>
+inline LineReader<CharT>::LineReader(IInputStream& stream, size_t blockSize)
+	: m_stream(stream)
+	, m_remaining(0)
+	, m_buffer(std::max<size_t>(blockSize, 2))
+	, m_next(0)
+	, m_end(0)
+{
+	StreamPos current = m_stream.Seek(0, IStreamBase::CURRENT);
+	StreamPos end = m_stream.Seek(0, IStreamBase::END);
+
+	m_stream.Seek(current, IStreamBase::BEGIN);
+
+	m_remaining = end - current;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if there are no more lines to read.
+
+template<typename CharT>
+inline bool LineReader<CharT>::isEOF() const
+{
+	return (m_next == m_end) && (m_remaining < sizeof(CharT));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read the next line as a view onto the internal buffer. The view excludes
+//! the line terminator and is only valid until the next line is read. It
+//! returns false when there are no more lines.
+
+template<typename CharT>
+bool LineReader<CharT>::readLine(const CharT*& begin, const CharT*& end)
+{
+	for (;;)
+	{
+		const CharT* first = &m_buffer[0] + m_next;
+		const CharT* last = &m_buffer[0] + m_end;
+		const CharT* terminator = findTerminator(first, last);
+
+		const bool endOfStream = (m_remaining < sizeof(CharT));
+
+		// Found a complete line? A CR at the end of the block may be the first
+		// half of a CR/LF that straddles the next block.
+		if ( (terminator != last) && ((terminator+1 != last) || (*terminator == '\n') || endOfStream) )
+		{
+			begin = first;
+			end = terminator;
+
+			m_next = (terminator - &m_buffer[0]) + 1;
+
+			if ( (*terminator == '\r') && (m_next != m_end) && (m_buffer[m_next] == '\n') )
+				++m_next;
+
+			return true;
+		}
+
+		// Unterminated final line?
+		if (endOfStream)
+		{
+			if (first == last)
+				return false;
+
+			begin = first;
+			end = last;
+
+			m_next = m_end;
+
+			return true;
+		}
+
+		readBlock();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read the next line converted to the build's character type. The line
+//! excludes the terminator. It returns false when there are no more lines.
+
+template<typename CharT>
+bool LineReader<CharT>::readLine(tstring& line)
+{
+	const CharT* begin = nullptr;
+	const CharT* end = nullptr;
+
+	if (!readLine(begin, end))
+		return false;
+
+	Detail::convertLine(begin, end, line);
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read the next block from the stream. Any unread characters are moved to the
+//! start of the buffer first and the buffer is grown if a single line is
+//! longer than the block size.
+
+template<typename CharT>
+void LineReader<CharT>::readBlock()
+{
+	if (m_next != 0)
+	{
+		std::copy(m_buffer.begin()+m_next, m_buffer.begin()+m_end, m_buffer.begin());
+
+		m_end -= m_next;
+		m_next = 0;
+	}
+
+	if (m_end == m_buffer.size())
+		m_buffer.resize(m_buffer.size() * 2);
+
+	StreamPos available = m_remaining / sizeof(CharT);
+	size_t    chars = m_buffer.size() - m_end;
+
+	if (available < chars)
+		chars = static_cast<size_t>(available);
+
+	m_stream.Read(&m_buffer[m_end], Core::numBytes<CharT>(chars));
+
+	m_end += chars;
+	m_remaining -= Core::numBytes<CharT>(chars);
+
+	// Discard any trailing partial character.
+	if (m_remaining < sizeof(CharT))
+		m_remaining = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Find the next line terminator in the unread characters. It returns the
+//! position of the first CR or LF, or the end if there is neither.
+
+template<typename CharT>
+inline const CharT* LineReader<CharT>::findTerminator(const CharT* begin, const CharT* end) const
+{
+	const CharT* lf = Detail::findChar(begin, end, CharT('\n'));
+
+	return Detail::findChar(begin, lf, CharT('\r'));
+}
+
+//namespace WCL
+}
+
+#endif // WCL_LINEREADER_HPP
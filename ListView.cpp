@@ -20,7 +20,7 @@
 /******************************************************************************
 ** Method:		Default constructor.
 **
-** Description:	Does nothing.
+** Description:	Initialise members.
 **
 ** Parameters:	None.
 **
@@ -30,6 +30,10 @@
 */
 
 CListView::CListView()
+	: m_pDataSource(nullptr)
+	, m_bCacheSel(false)
+	, m_bSelCacheValid(false)
+	, m_oSelCache()
 {
 }
 
@@ -54,6 +58,10 @@ void CListView::GetCreateParams(WNDCREATE& rParams)
 	rParams.pszClassName = WC_LISTVIEW;
 	rParams.dwExStyle   |= WS_EX_CLIENTEDGE;
 	rParams.dwStyle     |= WS_BORDER | LVS_REPORT | LVS_SINGLESEL | LVS_SHOWSELALWAYS;
+
+	// Virtual list?
+	if (m_pDataSource != nullptr)
+		rParams.dwStyle |= LVS_OWNERDATA;
 }
 
 /******************************************************************************
@@ -72,6 +80,8 @@ void CListView::GetCreateParams(WNDCREATE& rParams)
 
 size_t CListView::InsertItem(size_t nItem, const tchar* pszText, size_t nImage)
 {
+	ASSERT(!IsVirtual());
+
 	LVITEM lvItem = { 0 };
 
 	// Initialise item structure.
@@ -246,7 +256,8 @@ LPARAM CListView::ItemData(size_t nItem) const
 /******************************************************************************
 ** Method:		Selections()
 **
-** Description:	Gets the indexes of all selected items.
+** Description:	Gets the indexes of all selected items. Only the selected items
+**				are visited, not every item in the list.
 **
 ** Parameters:	vItems		The return array.
 **
@@ -259,16 +270,220 @@ size_t CListView::Selections(Items& vItems) const
 {
 	ASSERT(vItems.size() == 0);
 
-	// For all items...
-	for (size_t i = 0; i < ItemCount(); ++i)
+	if (m_bCacheSel)
 	{
-		if (IsSelected(i))
-			vItems.push_back(i);
+		UpdateSelCache();
+
+		vItems.assign(m_oSelCache.begin(), m_oSelCache.end());
+
+		return vItems.size();
 	}
 
+	vItems.reserve(SelectionCount());
+
+	// For all selected items...
+	for (size_t nItem = NextSelection(); nItem != Core::npos; nItem = NextSelection(nItem))
+		vItems.push_back(nItem);
+
 	return vItems.size();
 }
 
+/******************************************************************************
+** Method:		NextSelection()
+**
+** Description:	Gets the next selected item after the one given. This allows
+**				the selection to be iterated without visiting every item:
+**
+**				for (n = NextSelection(); n != Core::npos; n = NextSelection(n))
+**
+** Parameters:	nItem		The item to start after, or npos for the first.
+**
+** Returns:		The next selected item or npos if there are no more.
+**
+*******************************************************************************
+*/
+
+size_t CListView::NextSelection(size_t nItem) const
+{
+	if (m_bCacheSel)
+	{
+		UpdateSelCache();
+
+		std::set<size_t>::const_iterator it = (nItem == Core::npos) ? m_oSelCache.begin()
+																	: m_oSelCache.upper_bound(nItem);
+
+		return (it != m_oSelCache.end()) ? *it : Core::npos;
+	}
+
+	int nNext = ListView_GetNextItem(m_hWnd, static_cast<int>(nItem), LVNI_SELECTED);
+
+	return (nNext != -1) ? static_cast<size_t>(nNext) : Core::npos;
+}
+
+/******************************************************************************
+** Method:		CacheSelection()
+**
+** Description:	Enables or disables the selection cache. When enabled the
+**				selection is tracked from the LVN_ITEMCHANGED and
+**				LVN_ODSTATECHANGED notifications so that querying it does not
+**				require any messages to be sent to the control.
+**				NB: The notifications are only seen when the parent window is
+**				a CMsgWnd, which reflects them back to the control.
+**
+** Parameters:	bEnable		Enable or disable the cache.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CListView::CacheSelection(bool bEnable)
+{
+	m_bCacheSel = bEnable;
+
+	InvalidateSelCache();
+}
+
+/******************************************************************************
+** Method:		UpdateSelCache()
+**
+** Description:	Rebuilds the selection cache from the control if it has been
+**				invalidated, e.g. by items being inserted or deleted.
+**
+** Parameters:	None.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CListView::UpdateSelCache() const
+{
+	ASSERT(m_bCacheSel);
+
+	if (m_bSelCacheValid)
+		return;
+
+	m_oSelCache.clear();
+
+	for (int nItem = ListView_GetNextItem(m_hWnd, -1, LVNI_SELECTED); nItem != -1;
+			 nItem = ListView_GetNextItem(m_hWnd, nItem, LVNI_SELECTED))
+	{
+		m_oSelCache.insert(m_oSelCache.end(), static_cast<size_t>(nItem));
+	}
+
+	m_bSelCacheValid = true;
+}
+
+/******************************************************************************
+** Method:		OnItemChanged()
+**
+** Description:	Updates the selection cache when an item's state changes.
+**
+** Parameters:	oInfo		The change details.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CListView::OnItemChanged(const NMLISTVIEW& oInfo)
+{
+	if ( (!m_bSelCacheValid) || ((oInfo.uChanged & LVIF_STATE) == 0) )
+		return;
+
+	// Selection unchanged?
+	if (((oInfo.uNewState ^ oInfo.uOldState) & LVIS_SELECTED) == 0)
+		return;
+
+	// All items changed?
+	if (oInfo.iItem == -1)
+	{
+		InvalidateSelCache();
+		return;
+	}
+
+	if (oInfo.uNewState & LVIS_SELECTED)
+		m_oSelCache.insert(static_cast<size_t>(oInfo.iItem));
+	else
+		m_oSelCache.erase(static_cast<size_t>(oInfo.iItem));
+}
+
+/******************************************************************************
+** Method:		OnItemInserted()
+**
+** Description:	Updates the selection cache when an item is inserted or
+**				deleted as the index of every item after it changes.
+**
+** Parameters:	nItem		The item inserted or deleted.
+**				bInserted	Was the item inserted (true) or deleted (false)?
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CListView::OnItemInserted(int nItem, bool bInserted)
+{
+	if ( (!m_bSelCacheValid) || (nItem < 0) )
+		return;
+
+	const size_t nFirst = static_cast<size_t>(nItem);
+
+	std::set<size_t> oSelection;
+
+	for (std::set<size_t>::const_iterator it = m_oSelCache.begin(); it != m_oSelCache.end(); ++it)
+	{
+		if (*it < nFirst)
+			oSelection.insert(oSelection.end(), *it);
+		else if (bInserted)
+			oSelection.insert(oSelection.end(), *it + 1);
+		else if (*it > nFirst)
+			oSelection.insert(oSelection.end(), *it - 1);
+	}
+
+	m_oSelCache.swap(oSelection);
+}
+
+/******************************************************************************
+** Method:		OnODStateChanged()
+**
+** Description:	Updates the selection cache when the state of a range of items
+**				in a virtual list changes.
+**
+** Parameters:	oInfo		The change details.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CListView::OnODStateChanged(const NMLVODSTATECHANGE& oInfo)
+{
+	if (!m_bSelCacheValid)
+		return;
+
+	// Selection unchanged?
+	if (((oInfo.uNewState ^ oInfo.uOldState) & LVIS_SELECTED) == 0)
+		return;
+
+	if ( (oInfo.iFrom < 0) || (oInfo.iTo < oInfo.iFrom) )
+	{
+		InvalidateSelCache();
+		return;
+	}
+
+	const bool bSelected = ((oInfo.uNewState & LVIS_SELECTED) != 0);
+
+	for (int nItem = oInfo.iFrom; nItem <= oInfo.iTo; ++nItem)
+	{
+		if (bSelected)
+			m_oSelCache.insert(static_cast<size_t>(nItem));
+		else
+			m_oSelCache.erase(static_cast<size_t>(nItem));
+	}
+}
+
 /******************************************************************************
 ** Method:		InsertColumn()
 **
@@ -517,3 +732,224 @@ CPoint CListView::calcMsgMousePos(const NMITEMACTIVATE& message) const
 
 	return position;
 }
+
+/******************************************************************************
+** Method:		DataSource()
+**
+** Description:	Sets the source of the rows for a virtual (owner-data) list.
+**				If set before the control is created the LVS_OWNERDATA style
+**				is added automatically, otherwise the control must have been
+**				created with it, e.g. from a dialog template.
+**
+** Parameters:	pDataSource		The data source or nullptr to detach it.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CListView::DataSource(WCL::IListViewDataSource* pDataSource)
+{
+	ASSERT((m_hWnd == NULL) || (pDataSource == nullptr) || (WindowStyle() & LVS_OWNERDATA));
+
+	m_pDataSource = pDataSource;
+
+	if ( (m_hWnd != NULL) && (m_pDataSource != nullptr) )
+		DataChanged();
+}
+
+/******************************************************************************
+** Method:		DataChanged()
+**
+** Description:	Updates a virtual list after the data source has changed, e.g.
+**				rows have been added or it has been sorted. Only the item count
+**				is sent to the control, the visible rows are then requested
+**				again through LVN_GETDISPINFO.
+**
+** Parameters:	None.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CListView::DataChanged()
+{
+	ASSERT(IsVirtual());
+
+	ListView_SetItemCountEx(m_hWnd, static_cast<int>(m_pDataSource->rowCount()), LVSICF_NOSCROLL);
+	InvalidateSelCache();
+	Invalidate();
+}
+
+/******************************************************************************
+** Method:		OnReflectedNfyMsg()
+**
+** Description:	Handles the notifications used to display a virtual list and
+**				keep the selection cache up to date.
+**
+** Parameters:	rMsgHdr		The message.
+**				lResult		The result to return, if handled.
+**
+** Returns:		true if the message was handled, false if not.
+**
+*******************************************************************************
+*/
+
+bool CListView::OnReflectedNfyMsg(NMHDR& rMsgHdr, LRESULT& lResult)
+{
+	if (m_bCacheSel)
+	{
+		// Decode message.
+		switch(rMsgHdr.code)
+		{
+			// Item state changed.
+			case LVN_ITEMCHANGED:
+				OnItemChanged(reinterpret_cast<NMLISTVIEW&>(rMsgHdr));
+				break;
+
+			// Virtual item range state changed.
+			case LVN_ODSTATECHANGED:
+				OnODStateChanged(reinterpret_cast<NMLVODSTATECHANGE&>(rMsgHdr));
+				break;
+
+			// Item inserted.
+			case LVN_INSERTITEM:
+				OnItemInserted(reinterpret_cast<NMLISTVIEW&>(rMsgHdr).iItem, true);
+				break;
+
+			// Item about to be deleted.
+			case LVN_DELETEITEM:
+				OnItemInserted(reinterpret_cast<NMLISTVIEW&>(rMsgHdr).iItem, false);
+				break;
+
+			// All items about to be deleted.
+			case LVN_DELETEALLITEMS:
+				m_oSelCache.clear();
+				break;
+
+			// Unknown.
+			default:
+				break;
+		}
+	}
+
+	if (m_pDataSource != nullptr)
+	{
+		// Decode message.
+		switch(rMsgHdr.code)
+		{
+			// Item text or image required.
+			case LVN_GETDISPINFO:
+				OnGetDispInfo(reinterpret_cast<NMLVDISPINFO&>(rMsgHdr));
+				return true;
+
+			// Range of items about to be displayed.
+			case LVN_ODCACHEHINT:
+				OnCacheHint(reinterpret_cast<NMLVCACHEHINT&>(rMsgHdr));
+				return true;
+
+			// Item search, e.g. keyboard type-ahead.
+			case LVN_ODFINDITEM:
+				lResult = OnFindItem(reinterpret_cast<NMLVFINDITEM&>(rMsgHdr));
+				return true;
+
+			// Unknown.
+			default:
+				break;
+		}
+	}
+
+	return CStdWnd::OnReflectedNfyMsg(rMsgHdr, lResult);
+}
+
+/******************************************************************************
+** Method:		OnGetDispInfo()
+**
+** Description:	Fills in the text and image for a virtual list item.
+**
+** Parameters:	oInfo		The item request.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CListView::OnGetDispInfo(NMLVDISPINFO& oInfo)
+{
+	LVITEM& lvItem = oInfo.item;
+	size_t  nRow   = static_cast<size_t>(lvItem.iItem);
+
+	if (nRow >= m_pDataSource->rowCount())
+		return;
+
+	// Text required?
+	if ( (lvItem.mask & LVIF_TEXT) && (lvItem.pszText != nullptr) && (lvItem.cchTextMax > 0) )
+	{
+		const tchar* pszText = m_pDataSource->cellText(nRow, lvItem.iSubItem);
+
+		tstrncpy(lvItem.pszText, pszText, lvItem.cchTextMax-1);
+		lvItem.pszText[lvItem.cchTextMax-1] = TXT('\0');
+	}
+
+	// Image required?
+	if (lvItem.mask & LVIF_IMAGE)
+	{
+		size_t nImage = m_pDataSource->rowImage(nRow);
+
+		if (nImage != Core::npos)
+			lvItem.iImage = static_cast<int>(nImage);
+	}
+}
+
+/******************************************************************************
+** Method:		OnCacheHint()
+**
+** Description:	Passes on the range of rows about to be displayed so that the
+**				data source can fetch them ahead of the LVN_GETDISPINFO
+**				requests.
+**
+** Parameters:	oInfo		The range of rows.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CListView::OnCacheHint(const NMLVCACHEHINT& oInfo)
+{
+	if ( (oInfo.iFrom < 0) || (oInfo.iTo < oInfo.iFrom) )
+		return;
+
+	m_pDataSource->cacheHint(oInfo.iFrom, oInfo.iTo);
+}
+
+/******************************************************************************
+** Method:		OnFindItem()
+**
+** Description:	Searches the data source for an item on behalf of the control,
+**				e.g. for keyboard type-ahead or ListView_FindItem().
+**
+** Parameters:	oInfo		The search criteria.
+**
+** Returns:		The index of the item or -1 if not found.
+**
+*******************************************************************************
+*/
+
+LRESULT CListView::OnFindItem(const NMLVFINDITEM& oInfo)
+{
+	const LVFINDINFO& oFind = oInfo.lvfi;
+
+	// Only text searches are supported.
+	if ( ((oFind.flags & (LVFI_STRING | LVFI_PARTIAL)) == 0) || (oFind.psz == nullptr) )
+		return -1;
+
+	bool   bPartial = ((oFind.flags & LVFI_PARTIAL) != 0);
+	bool   bWrap    = ((oFind.flags & LVFI_WRAP) != 0);
+	size_t nStart   = (oInfo.iStart >= 0) ? oInfo.iStart : 0;
+
+	size_t nRow = m_pDataSource->findRow(oFind.psz, bPartial, nStart, bWrap);
+
+	return (nRow != Core::npos) ? static_cast<LRESULT>(nRow) : -1;
+}
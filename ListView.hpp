@@ -18,7 +18,9 @@
 
 #include "StdWnd.hpp"
 #include "ImageList.hpp"
+#include "IListViewDataSource.hpp"
 #include <vector>
+#include <set>
 #include <commctrl.h>
 
 /******************************************************************************
@@ -93,7 +95,10 @@ public:
 	bool IsSelection() const;
 	size_t Selection() const;
 	size_t Selections(Items& vItems) const;
+	size_t NextSelection(size_t nItem = Core::npos) const;
+	size_t SelectionCount() const;
 	bool IsSelected(size_t nItem) const;
+	void CacheSelection(bool bEnable = true);
 	void RestoreSel(size_t nItem);
 
 	size_t ItemCount() const;
@@ -136,10 +141,43 @@ public:
 	//! Calculate the mouse co-ordinates for the message, relative to the window.
 	CPoint calcMsgMousePos(const NMITEMACTIVATE& message) const;
 
+	//
+	// Virtual (owner-data) mode methods.
+	//
+	void DataSource(WCL::IListViewDataSource* pDataSource);
+	WCL::IListViewDataSource* DataSource() const;
+	bool IsVirtual() const;
+	void DataChanged();
+
 protected:
 	//
 	// Members.
 	//
+	WCL::IListViewDataSource*	m_pDataSource;	// The rows for a virtual list.
+	bool						m_bCacheSel;	// Cache the selection state?
+	mutable bool				m_bSelCacheValid;	// Is the selection cache up to date?
+	mutable std::set<size_t>	m_oSelCache;	// The selected items.
+
+	//
+	// Message handlers.
+	//
+	virtual bool OnReflectedNfyMsg(NMHDR& rMsgHdr, LRESULT& lResult);
+
+	//
+	// Virtual list message handlers.
+	//
+	void    OnGetDispInfo(NMLVDISPINFO& oInfo);
+	void    OnCacheHint(const NMLVCACHEHINT& oInfo);
+	LRESULT OnFindItem(const NMLVFINDITEM& oInfo);
+
+	//
+	// Selection cache methods.
+	//
+	void OnItemChanged(const NMLISTVIEW& oInfo);
+	void OnODStateChanged(const NMLVODSTATECHANGE& oInfo);
+	void OnItemInserted(int nItem, bool bInserted);
+	void UpdateSelCache() const;
+	void InvalidateSelCache();
 
 	//
 	// Window creation template methods.
@@ -269,12 +307,37 @@ inline bool CListView::IsSelection() const
 
 inline bool CListView::IsSelected(size_t nItem) const
 {
+	if (m_bCacheSel)
+	{
+		UpdateSelCache();
+
+		return (m_oSelCache.find(nItem) != m_oSelCache.end());
+	}
+
 	return (ItemState(nItem) & LVIS_SELECTED);
 }
 
 inline size_t CListView::Selection() const
 {
-	return ListView_GetNextItem(m_hWnd, (UINT)-1, LVNI_SELECTED);
+	return NextSelection();
+}
+
+inline size_t CListView::SelectionCount() const
+{
+	if (m_bCacheSel)
+	{
+		UpdateSelCache();
+
+		return m_oSelCache.size();
+	}
+
+	return ListView_GetSelectedCount(m_hWnd);
+}
+
+inline void CListView::InvalidateSelCache()
+{
+	m_bSelCacheValid = false;
+	m_oSelCache.clear();
 }
 
 inline size_t CListView::ItemCount() const
@@ -342,7 +405,22 @@ inline int CListView::Sort(PFNLVCOMPARE pfnCompare)
 
 inline int CListView::Sort(PFNLVCOMPARE pfnCompare, LPARAM lParamSort)
 {
+	ASSERT(!IsVirtual());
+
+	// Items will move.
+	InvalidateSelCache();
+
 	return ListView_SortItems(m_hWnd, pfnCompare, lParamSort);
 }
 
+inline WCL::IListViewDataSource* CListView::DataSource() const
+{
+	return m_pDataSource;
+}
+
+inline bool CListView::IsVirtual() const
+{
+	return (m_pDataSource != nullptr);
+}
+
 #endif //LISTVIEW_HPP
@@ -0,0 +1,194 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ListViewBulkUpdate.hpp
+//! \brief  The ListViewBulkUpdate class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef WCL_LISTVIEWBULKUPDATE_HPP
+#define WCL_LISTVIEWBULKUPDATE_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "ListView.hpp"
+#include <algorithm>
+#include <iterator>
+
+namespace WCL
+{
+
+namespace Detail
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Adapts a record comparison predicate to compare pointers to the records.
+
+template<typename Record, typename Less>
+class IndirectLess
+{
+public:
+	//! Constructor.
+	IndirectLess(Less less)
+		: m_less(less)
+	{
+	}
+
+	//! Compare the records.
+	bool operator()(const Record* lhs, const Record* rhs) const
+	{
+		return m_less(*lhs, *rhs);
+	}
+
+private:
+	//
+	// Members.
+	//
+	Less	m_less;		//!< The record predicate.
+};
+
+//namespace Detail
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! A scoped object for adding many rows to a ListView. Redrawing is disabled
+//! for the lifetime of the object and the control is repainted once at the end.
+//! The rows are written from a range of records, and can be sorted in-process
+//! before they are inserted, so that the control does not need to call back
+//! into the application to sort them.
+//!
+//! The cell text is provided by a function object with the signature:
+//! tstring (const Record& record, size_t column)
+
+class ListViewBulkUpdate /*: private NotCopyable*/
+{
+public:
+	//! Constructor.
+	explicit ListViewBulkUpdate(CListView& view, size_t rows = 0);
+
+	//! Destructor.
+	~ListViewBulkUpdate();
+
+	//
+	// Methods.
+	//
+
+	//! Reserve space for a number of additional rows.
+	void reserve(size_t rows);
+
+	//! Append a row for each record in the range.
+	template<typename FwdIter, typename CellText>
+	size_t appendRows(FwdIter first, FwdIter last, size_t columns, CellText cellText);
+
+	//! Sort the records and append a row for each one.
+	template<typename FwdIter, typename Less, typename CellText>
+	size_t appendSortedRows(FwdIter first, FwdIter last, Less less, size_t columns, CellText cellText);
+
+private:
+	//
+	// Members.
+	//
+	CListView&	m_view;		//!< The control being updated.
+
+	//! Append a row for a single record.
+	template<typename Record, typename CellText>
+	void appendRow(const Record& record, size_t columns, CellText& cellText);
+
+	// NotCopyable.
+	ListViewBulkUpdate(const ListViewBulkUpdate&);
+	ListViewBulkUpdate& operator=(const ListViewBulkUpdate&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Constructor. Disables redrawing and optionally reserves space for the
+//! number of rows that are about to be added.
+
+inline ListViewBulkUpdate::ListViewBulkUpdate(CListView& view, size_t rows)
+	: m_view(view)
+{
+	m_view.Redraw(false);
+
+	if (rows != 0)
+		reserve(rows);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor. Re-enables redrawing and repaints the control.
+
+inline ListViewBulkUpdate::~ListViewBulkUpdate()
+{
+	m_view.Redraw(true);
+	m_view.Invalidate();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Reserve space for a number of additional rows.
+
+inline void ListViewBulkUpdate::reserve(size_t rows)
+{
+	m_view.Reserve(m_view.ItemCount() + rows);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Append a row for each record in the range. Returns the number of rows added.
+
+template<typename FwdIter, typename CellText>
+inline size_t ListViewBulkUpdate::appendRows(FwdIter first, FwdIter last, size_t columns, CellText cellText)
+{
+	const size_t rows = std::distance(first, last);
+
+	reserve(rows);
+
+	for (FwdIter it = first; it != last; ++it)
+		appendRow(*it, columns, cellText);
+
+	return rows;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Sort the records with the predicate and append a row for each one. Only
+//! pointers to the records are sorted so the range is not modified. Returns the
+//! number of rows added.
+
+template<typename FwdIter, typename Less, typename CellText>
+inline size_t ListViewBulkUpdate::appendSortedRows(FwdIter first, FwdIter last, Less less, size_t columns, CellText cellText)
+{
+	typedef typename std::iterator_traits<FwdIter>::value_type Record;
+	typedef std::vector<const Record*> Records;
+
+	Records records;
+
+	records.reserve(std::distance(first, last));
+
+	for (FwdIter it = first; it != last; ++it)
+		records.push_back(&*it);
+
+	std::sort(records.begin(), records.end(), Detail::IndirectLess<Record, Less>(less));
+
+	reserve(records.size());
+
+	for (typename Records::const_iterator it = records.begin(); it != records.end(); ++it)
+		appendRow(**it, columns, cellText);
+
+	return records.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Append a row for a single record. The first column is set when the item is
+//! inserted to avoid a separate message.
+
+template<typename Record, typename CellText>
+inline void ListViewBulkUpdate::appendRow(const Record& record, size_t columns, CellText& cellText)
+{
+	ASSERT(columns != 0);
+
+	const size_t item = m_view.AppendItem(cellText(record, 0));
+
+	for (size_t column = 1; column != columns; ++column)
+		m_view.ItemText(item, column, cellText(record, column));
+}
+
+//namespace WCL
+}
+
+#endif // WCL_LISTVIEWBULKUPDATE_HPP
@@ -0,0 +1,439 @@
+/******************************************************************************
+** (C) Chris Oldwood
+**
+** MODULE:		MAPPEDFILE.CPP
+** COMPONENT:	Windows C++ Library.
+** DESCRIPTION:	CMappedFile class methods.
+**
+*******************************************************************************
+*/
+
+#include "Common.hpp"
+#include "MappedFile.hpp"
+#include "FileException.hpp"
+#include <limits>
+
+//! The minimum size the mapping is grown by when writing.
+const size_t MIN_GROWTH = 64 * 1024;
+
+/******************************************************************************
+** Method:		Default constructor
+**
+** Description:	.
+**
+** Parameters:	None.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+CMappedFile::CMappedFile()
+	: m_hFile(INVALID_HANDLE_VALUE)
+	, m_hMapping(NULL)
+	, m_pView(nullptr)
+	, m_Path()
+	, m_nMapSize(0)
+	, m_lPos(0)
+	, m_lEOF(0)
+{
+}
+
+/******************************************************************************
+** Method:		Destructor
+**
+** Description:	Close the file, if open.
+**
+** Parameters:	None.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+CMappedFile::~CMappedFile()
+{
+	if (m_hFile != INVALID_HANDLE_VALUE)
+		Close();
+}
+
+/******************************************************************************
+** Method:		Create()
+**
+** Description:	Create a new file, or open and truncate an existing one.
+**
+** Parameters:	pszPath		The file to create.
+**
+** Returns:		Nothing.
+**
+** Exceptions:	CFileException on error.
+**
+*******************************************************************************
+*/
+
+void CMappedFile::Create(const tchar* pszPath)
+{
+	ASSERT(m_hFile == INVALID_HANDLE_VALUE);
+
+	m_nMode = GENERIC_WRITE;
+	m_Path  = pszPath;
+
+	// A writable mapping also requires read access.
+	m_hFile = ::CreateFile(m_Path, GENERIC_READ | GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+
+	// Error?
+	if (m_hFile == INVALID_HANDLE_VALUE)
+	{
+		DWORD dwLastError = ::GetLastError();
+
+		m_nMode = GENERIC_NONE;
+
+		// File is read-only?
+		if (m_Path.ReadOnly())
+			throw CFileException(CFileException::E_READ_ONLY, m_Path, ERROR_ACCESS_DENIED);
+
+		// Unknown reason.
+		throw CFileException(CFileException::E_CREATE_FAILED, m_Path, dwLastError);
+	}
+
+	m_lPos = 0;
+	m_lEOF = 0;
+}
+
+/******************************************************************************
+** Method:		Open()
+**
+** Description:	Open an existing file for reading and/or writing and map the
+**				entire file into memory.
+**
+** Parameters:	pszPath		The file to open.
+**				nMode		The access mode.
+**
+** Returns:		Nothing.
+**
+** Exceptions:	CFileException on error.
+**
+*******************************************************************************
+*/
+
+void CMappedFile::Open(const tchar* pszPath, uint nMode)
+{
+	ASSERT(m_hFile == INVALID_HANDLE_VALUE);
+
+	m_nMode = nMode;
+	m_Path  = pszPath;
+
+	DWORD dwAccess = (nMode & GENERIC_WRITE) ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ;
+	DWORD dwShare  = (nMode & GENERIC_WRITE) ? 0 : FILE_SHARE_READ;
+
+	m_hFile = ::CreateFile(m_Path, dwAccess, dwShare, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+	// Error?
+	if (m_hFile == INVALID_HANDLE_VALUE)
+	{
+		DWORD dwLastError = ::GetLastError();
+
+		m_nMode = GENERIC_NONE;
+
+		// File exists?
+		if (!m_Path.Exists())
+			throw CFileException(CFileException::E_PATH_INVALID, m_Path, ERROR_FILE_NOT_FOUND);
+
+		// Trying to write and file is read-only ?
+		if ( (nMode & GENERIC_WRITE) && (m_Path.ReadOnly()) )
+			throw CFileException(CFileException::E_READ_ONLY, m_Path, ERROR_ACCESS_DENIED);
+
+		// Unknown reason.
+		throw CFileException(CFileException::E_OPEN_FAILED, m_Path, dwLastError);
+	}
+
+	DWORD dwSizeHigh = 0;
+	DWORD dwSizeLow  = ::GetFileSize(m_hFile, &dwSizeHigh);
+
+	uint64 nSize = (static_cast<uint64>(dwSizeHigh) << 32) | dwSizeLow;
+
+	try
+	{
+		// Too large to map as a single view?
+		if (nSize > std::numeric_limits<size_t>::max())
+			throw CFileException(CFileException::E_OPEN_FAILED, m_Path, ERROR_FILE_TOO_LARGE);
+
+		m_lPos = 0;
+		m_lEOF = static_cast<size_t>(nSize);
+
+		// An empty file cannot be mapped.
+		if (m_lEOF != 0)
+			Map(m_lEOF);
+	}
+	catch (...)
+	{
+		Close();
+		throw;
+	}
+}
+
+/******************************************************************************
+** Method:		Close()
+**
+** Description:	Unmap and close the file. If the file was written to it is
+**				truncated to the number of bytes written.
+**
+** Parameters:	None.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CMappedFile::Close()
+{
+	ASSERT(m_hFile != INVALID_HANDLE_VALUE);
+
+	Unmap();
+
+	// Remove any unused space from growing the mapping.
+	if (m_nMode & GENERIC_WRITE)
+	{
+		LONG lHigh = static_cast<LONG>(static_cast<uint64>(m_lEOF) >> 32);
+
+		::SetFilePointer(m_hFile, static_cast<LONG>(m_lEOF & 0xFFFFFFFF), &lHigh, FILE_BEGIN);
+		::SetEndOfFile(m_hFile);
+	}
+
+	::CloseHandle(m_hFile);
+
+	// Reset members.
+	m_hFile = INVALID_HANDLE_VALUE;
+	m_nMode = GENERIC_NONE;
+	m_lPos  = 0;
+	m_lEOF  = 0;
+}
+
+/******************************************************************************
+** Method:		Read()
+**
+** Description:	Core method for reading a number of bytes from the stream.
+**
+** Parameters:	pBuffer		The buffer to read to.
+**				iNumBytes	The number of bytes to read.
+**
+** Returns:		Nothing.
+**
+** Exceptions:	CFileException on error.
+**
+*******************************************************************************
+*/
+
+void CMappedFile::Read(void* pBuffer, size_t iNumBytes)
+{
+	ASSERT(m_hFile != INVALID_HANDLE_VALUE);
+	ASSERT(m_nMode & GENERIC_READ);
+
+	// Enough bytes left to read?
+	if (iNumBytes > (m_lEOF - m_lPos))
+		throw CFileException(CFileException::E_READ_FAILED, m_Path, ERROR_HANDLE_EOF);
+
+	if (iNumBytes != 0)
+		memcpy(pBuffer, m_pView + m_lPos, iNumBytes);
+
+	m_lPos += iNumBytes;
+}
+
+/******************************************************************************
+** Method:		Write()
+**
+** Description:	Core method for writing a number of bytes to the stream. The
+**				mapping is grown geometrically when the write would go past the
+**				end of the view.
+**
+** Parameters:	pBuffer		The buffer to write from.
+**				iNumBytes	The number of bytes to write.
+**
+** Returns:		Nothing.
+**
+** Exceptions:	CFileException on error.
+**
+*******************************************************************************
+*/
+
+void CMappedFile::Write(const void* pBuffer, size_t iNumBytes)
+{
+	ASSERT(m_hFile != INVALID_HANDLE_VALUE);
+	ASSERT(m_nMode & GENERIC_WRITE);
+
+	size_t nRequired = m_lPos + iNumBytes;
+
+	// Overflowed?
+	if (nRequired < m_lPos)
+		throw CFileException(CFileException::E_WRITE_FAILED, m_Path, ERROR_FILE_TOO_LARGE);
+
+	// Enough space in the current view?
+	if (nRequired > m_nMapSize)
+	{
+		size_t nNewSize = std::max(m_nMapSize * 2, m_nMapSize + MIN_GROWTH);
+
+		// Doubling overflowed or still too small?
+		if (nNewSize < nRequired)
+			nNewSize = nRequired;
+
+		Unmap();
+		Map(nNewSize);
+	}
+
+	if (iNumBytes != 0)
+		memcpy(m_pView + m_lPos, pBuffer, iNumBytes);
+
+	m_lPos += iNumBytes;
+	m_lEOF  = std::max(m_lPos, m_lEOF);
+}
+
+/******************************************************************************
+** Method:		Seek()
+**
+** Description:	Core method for changing the stream pointer.
+**
+** Parameters:	lPos		The new position.
+**				nFrom		The origin from where to seek.
+**
+** Returns:		The new stream pointer.
+**
+** Exceptions:	CFileException on error.
+**
+*******************************************************************************
+*/
+
+WCL::StreamPos CMappedFile::Seek(WCL::StreamPos lPos, SeekPos eFrom)
+{
+	ASSERT(m_hFile != INVALID_HANDLE_VALUE);
+
+	WCL::StreamPos lNewPos = m_lPos;
+
+	// Calculate new position.
+	switch(eFrom)
+	{
+		case BEGIN:		lNewPos  = lPos;			break;
+		case CURRENT:	lNewPos += lPos;			break;
+		case END:		lNewPos  = m_lEOF - lPos;	break;
+		default:		ASSERT_FALSE();				break;
+	}
+
+	// Seeked to invalid position?
+	if (lNewPos > m_lEOF)
+		throw CFileException(CFileException::E_SEEK_FAILED, m_Path, ERROR_NEGATIVE_SEEK);
+
+	m_lPos = static_cast<size_t>(lNewPos);
+
+	return m_lPos;
+}
+
+/******************************************************************************
+** Method:		IsEOF()
+**
+** Description:	Used to detect when the end of the stream has been reached.
+**
+** Parameters:	None.
+**
+** Returns:		true or false
+**
+*******************************************************************************
+*/
+
+bool CMappedFile::IsEOF()
+{
+	ASSERT(m_hFile != INVALID_HANDLE_VALUE);
+
+	return (m_lPos >= m_lEOF);
+}
+
+/******************************************************************************
+** Method:		Throw()
+**
+** Description:	Throw a CFileException.
+**
+** Parameters:	eErrCode		The error code.
+**				dwLastError		The underlying error code.
+**
+** Returns:		Nothing.
+**
+** Exceptions:	CFileException.
+**
+*******************************************************************************
+*/
+
+void CMappedFile::Throw(int eErrCode, DWORD dwLastError)
+{
+	throw CFileException(eErrCode, m_Path, dwLastError);
+}
+
+/******************************************************************************
+** Method:		Map()
+**
+** Description:	Create a mapping of the given size and map it into memory. If
+**				the file is smaller than the mapping it is extended.
+**
+** Parameters:	nSize	The size of the mapping.
+**
+** Returns:		Nothing.
+**
+** Exceptions:	CFileException on error.
+**
+*******************************************************************************
+*/
+
+void CMappedFile::Map(size_t nSize)
+{
+	ASSERT(m_hMapping == NULL);
+	ASSERT(m_pView == nullptr);
+	ASSERT(nSize != 0);
+
+	bool  bWrite     = ((m_nMode & GENERIC_WRITE) != 0);
+	DWORD dwProtect  = (bWrite) ? PAGE_READWRITE : PAGE_READONLY;
+	DWORD dwAccess   = (bWrite) ? FILE_MAP_WRITE : FILE_MAP_READ;
+	int   eErrCode   = (bWrite) ? CFileException::E_WRITE_FAILED : CFileException::E_OPEN_FAILED;
+	DWORD dwSizeHigh = static_cast<DWORD>(static_cast<uint64>(nSize) >> 32);
+	DWORD dwSizeLow  = static_cast<DWORD>(nSize & 0xFFFFFFFF);
+
+	m_hMapping = ::CreateFileMapping(m_hFile, NULL, dwProtect, dwSizeHigh, dwSizeLow, NULL);
+
+	if (m_hMapping == NULL)
+		throw CFileException(eErrCode, m_Path, ::GetLastError());
+
+	m_pView = static_cast<byte*>(::MapViewOfFile(m_hMapping, dwAccess, 0, 0, nSize));
+
+	if (m_pView == nullptr)
+	{
+		DWORD dwLastError = ::GetLastError();
+
+		::CloseHandle(m_hMapping);
+		m_hMapping = NULL;
+
+		throw CFileException(eErrCode, m_Path, dwLastError);
+	}
+
+	m_nMapSize = nSize;
+}
+
+/******************************************************************************
+** Method:		Unmap()
+**
+** Description:	Unmap the view and close the mapping, if mapped.
+**
+** Parameters:	None.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CMappedFile::Unmap()
+{
+	if (m_pView != nullptr)
+		::UnmapViewOfFile(m_pView);
+
+	if (m_hMapping != NULL)
+		::CloseHandle(m_hMapping);
+
+	m_pView    = nullptr;
+	m_hMapping = NULL;
+	m_nMapSize = 0;
+}
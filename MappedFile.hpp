@@ -0,0 +1,126 @@
+/******************************************************************************
+** (C) Chris Oldwood
+**
+** MODULE:		MAPPEDFILE.HPP
+** COMPONENT:	Windows C++ Library.
+** DESCRIPTION:	The CMappedFile class declaration.
+**
+*******************************************************************************
+*/
+
+// Check for previous inclusion
+#ifndef WCL_MAPPEDFILE_HPP
+#define WCL_MAPPEDFILE_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "Stream.hpp"
+#include "Path.hpp"
+
+/******************************************************************************
+**
+** A file stream which accesses the file through a memory-mapped view rather
+** than with ReadFile()/WriteFile(). The entire file is mapped as a single view
+** and the bytes can be accessed directly with Data() to avoid copying them.
+**
+** When writing, the mapping is grown geometrically as required, which moves
+** the view and so invalidates any pointer returned by Data(). The file is
+** truncated to the number of bytes written when it is closed.
+**
+*******************************************************************************
+*/
+
+class CMappedFile : public CStream
+{
+public:
+	//
+	// Constructors/Destructor.
+	//
+	CMappedFile();
+	~CMappedFile();
+
+	//
+	// Member access.
+	//
+	CPath       Path() const;
+	const byte* Data() const;
+	byte*       Data();
+	size_t      Size() const;
+
+	//
+	// Open/Close operations.
+	//
+	void Create(const tchar* pszPath);
+	void Open(const tchar* pszPath, uint nMode);
+	void Close();
+
+	bool IsOpen() const;
+
+	//
+	// Overridden generic operations.
+	//
+	virtual void  Read(void* pBuffer, size_t iNumBytes);
+	virtual void  Write(const void* pBuffer, size_t iNumBytes);
+	virtual WCL::StreamPos Seek(WCL::StreamPos lPos, SeekPos eFrom = BEGIN);
+	virtual bool  IsEOF();
+	virtual void  Throw(int eErrCode, DWORD dwLastError);
+
+protected:
+	//
+	// Internal members.
+	//
+	HANDLE	m_hFile;		// The files' handle.
+	HANDLE	m_hMapping;		// The file mapping handle.
+	byte*	m_pView;		// The mapped view of the file.
+	CPath	m_Path;			// The files' path.
+	size_t	m_nMapSize;		// The size of the mapped view.
+	size_t	m_lPos;			// The current stream position.
+	size_t	m_lEOF;			// The logical end of the file.
+
+	//
+	// Internal methods.
+	//
+	void Map(size_t nSize);
+	void Unmap();
+
+private:
+	// NotCopyable.
+	CMappedFile(const CMappedFile&);
+	CMappedFile& operator=(const CMappedFile&);
+};
+
+/******************************************************************************
+**
+** Implementation of inline functions.
+**
+*******************************************************************************
+*/
+
+inline CPath CMappedFile::Path() const
+{
+	return m_Path;
+}
+
+inline const byte* CMappedFile::Data() const
+{
+	return m_pView;
+}
+
+inline byte* CMappedFile::Data()
+{
+	return m_pView;
+}
+
+inline size_t CMappedFile::Size() const
+{
+	return m_lEOF;
+}
+
+inline bool CMappedFile::IsOpen() const
+{
+	return (m_hFile != INVALID_HANDLE_VALUE);
+}
+
+#endif // WCL_MAPPEDFILE_HPP
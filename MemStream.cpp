@@ -18,24 +18,29 @@
 // Default allocation size in bytes (1K).
 const size_t ALLOC_SIZE = 1024;
 
+// The multiplier used for geometric growth.
+const size_t GROWTH_FACTOR = 2;
+
 /******************************************************************************
 ** Method:		Constructor.
 **
 ** Description:	.
 **
-** Parameters:	None.
+** Parameters:	oBuffer		The underlying memory block.
+**				eGrowth		The policy for growing the block when writing.
 **
 ** Returns:		Nothing.
 **
 *******************************************************************************
 */
 
-CMemStream::CMemStream(CBuffer& oBuffer)
+CMemStream::CMemStream(CBuffer& oBuffer, Growth eGrowth)
 	: m_oBuffer(oBuffer)
 	, m_pBuffer(nullptr)
 	, m_lAllocSize(oBuffer.Size())
 	, m_lEOF(oBuffer.Size())
 	, m_lPos(0)
+	, m_eGrowth(eGrowth)
 {
 }
 
@@ -140,6 +145,95 @@ void CMemStream::Close()
 	m_nMode   = GENERIC_NONE;
 }
 
+/******************************************************************************
+** Method:		Reserve()
+**
+** Description:	Ensure the underlying block can hold at least the number of
+**				bytes specified without further reallocation.
+**
+** Parameters:	nBytes	The minimum capacity in bytes.
+**
+** Returns:		Nothing.
+**
+** Exceptions:	CMemStreamException on error.
+**
+*******************************************************************************
+*/
+
+void CMemStream::Reserve(size_t nBytes)
+{
+	ASSERT(m_pBuffer != nullptr);
+	ASSERT(m_nMode & GENERIC_WRITE);
+
+	// Stream open?
+	if (m_pBuffer == nullptr)
+		throw CMemStreamException(CMemStreamException::E_WRITE_FAILED);
+
+	if (nBytes > m_lAllocSize)
+		Resize(nBytes);
+}
+
+/******************************************************************************
+** Method:		ShrinkToFit()
+**
+** Description:	Release any capacity in the underlying block beyond the
+**				current end of the stream.
+**
+** Parameters:	None.
+**
+** Returns:		Nothing.
+**
+** Exceptions:	CMemStreamException on error.
+**
+*******************************************************************************
+*/
+
+void CMemStream::ShrinkToFit()
+{
+	ASSERT(m_pBuffer != nullptr);
+	ASSERT(m_nMode & GENERIC_WRITE);
+
+	// Stream open?
+	if (m_pBuffer == nullptr)
+		throw CMemStreamException(CMemStreamException::E_WRITE_FAILED);
+
+	// Keep a non-empty block so that the stream remains open.
+	size_t lNewSize = std::max<size_t>(m_lEOF, 1);
+
+	if (lNewSize < m_lAllocSize)
+		Resize(lNewSize);
+}
+
+/******************************************************************************
+** Method:		Resize()
+**
+** Description:	Reallocate the underlying block to the specified size.
+**
+** Parameters:	nBytes	The new size of the block in bytes.
+**
+** Returns:		Nothing.
+**
+** Exceptions:	CMemStreamException on error.
+**
+*******************************************************************************
+*/
+
+void CMemStream::Resize(size_t nBytes)
+{
+	ASSERT(nBytes >= m_lEOF);
+
+	m_pBuffer = nullptr;
+
+	m_oBuffer.Size(nBytes);
+
+	m_pBuffer = static_cast<byte*>(m_oBuffer.Buffer());
+
+	if (m_pBuffer == nullptr)
+		throw CMemStreamException(CMemStreamException::E_WRITE_FAILED);
+
+	m_lAllocSize = nBytes;
+}
+
 /******************************************************************************
 ** Method:		Read()
 **
@@ -200,16 +294,15 @@ void CMemStream::Write(const void* pBuffer, size_t iNumBytes)
 	// Enough space in current block?
 	if ((m_lPos + iNumBytes) > m_lAllocSize)
 	{
-		// Extend block by 1 page or iNumBytes, if larger.
-		m_lAllocSize += std::max(ALLOC_SIZE, iNumBytes);
-
-		m_pBuffer = nullptr;
-
-		m_oBuffer.Size(m_lAllocSize);
+		size_t lNewSize = m_lAllocSize;
 
-		m_pBuffer = static_cast<byte*>(m_oBuffer.Buffer());
+		// Extend block by a multiple of its size, or 1 page or iNumBytes, if larger.
+		if (m_eGrowth == GEOMETRIC_GROWTH)
+			lNewSize = std::max(m_lAllocSize * GROWTH_FACTOR, m_lAllocSize + ALLOC_SIZE);
+		else
+			lNewSize = m_lAllocSize + std::max(ALLOC_SIZE, iNumBytes);
 
-		ASSERT(m_pBuffer != nullptr);
+		Resize(std::max(lNewSize, m_lPos + iNumBytes));
 	}
 
 	// Write bytes to the output buffer.
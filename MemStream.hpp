@@ -31,16 +31,33 @@ class CBuffer;
 class CMemStream : public CStream
 {
 public:
+	//! The policies for growing the buffer when writing.
+	enum Growth
+	{
+		FIXED_GROWTH,		//!< Extend by a fixed increment or the write size.
+		GEOMETRIC_GROWTH,	//!< Extend by a multiple of the current size.
+	};
+
 	//
 	// Constructors/Destructor.
 	//
-	CMemStream(CBuffer& oBuffer);
+	CMemStream(CBuffer& oBuffer, Growth eGrowth = GEOMETRIC_GROWTH);
 	virtual	~CMemStream();
 
 	//
 	// Properties.
 	//
 	size_t Size() const;
+	size_t Capacity() const;
+
+	Growth GrowthPolicy() const;
+	void   GrowthPolicy(Growth eGrowth);
+
+	//
+	// Capacity operations.
+	//
+	void Reserve(size_t nBytes);
+	void ShrinkToFit();
 
 	//
 	// Open/Close operations.
@@ -67,6 +84,12 @@ protected:
 	size_t		m_lAllocSize;	// Current allocated size.
 	size_t		m_lEOF;			// Current end of stream.
 	size_t		m_lPos;			// Current position in the stream.
+	Growth		m_eGrowth;		// The buffer growth policy.
+
+	//
+	// Internal methods.
+	//
+	void Resize(size_t nBytes);
 
 private:
 	// NotCopyable.
@@ -86,4 +109,19 @@ inline size_t CMemStream::Size() const
 	return m_lEOF;
 }
 
+inline size_t CMemStream::Capacity() const
+{
+	return m_lAllocSize;
+}
+
+inline CMemStream::Growth CMemStream::GrowthPolicy() const
+{
+	return m_eGrowth;
+}
+
+inline void CMemStream::GrowthPolicy(Growth eGrowth)
+{
+	m_eGrowth = eGrowth;
+}
+
 #endif // WCL_MEMSTREAM_HPP
@@ -15,6 +15,7 @@
 #include "IMsgFilter.hpp"
 #include "TraceLogger.hpp"
 #include "Win32Exception.hpp"
+#include "AutoThreadLock.hpp"
 #include <Core/RuntimeException.hpp>
 
 /******************************************************************************
@@ -33,6 +34,10 @@ CMsgThread::CMsgThread()
 	: m_oMsg()
 	, m_oMsgFilters()
 	, m_nResult(THREAD_EXIT_FAILURE)
+	, m_oUpdates()
+	, m_oJobsLock()
+	, m_oJobs()
+	, m_oJobsPosted(CEvent::AUTO_RESET, CEvent::NOT_SIGNALLED)
 {
 #ifdef _DEBUG
 	memset(&m_oMsg, 0, sizeof(MSG));
@@ -78,7 +83,7 @@ void CMsgThread::Run()
 
 	// Process message queue until WM_QUIT.
 	while (ProcessMsgQueue(false))
-		WaitMessage();
+		WaitForWork();
 
 #ifdef _DEBUG
 	memset(&m_oMsg, 0, sizeof(MSG));
@@ -153,6 +158,10 @@ bool CMsgThread::ProcessMsgQueue(bool bRepostQuitMsg)
 		WCL::TraceLogger::Install();
 #endif
 
+		// Apply any cross-thread updates and jobs first.
+		m_oUpdates.drain();
+		RunPostedJobs();
+
 		// Message waiting?
 		while (PeekMessage(&m_oMsg, NULL, WM_NULL, WM_NULL, PM_NOREMOVE))
 		{
@@ -192,6 +201,10 @@ bool CMsgThread::ProcessMsgQueue(bool bRepostQuitMsg)
 				OnThreadMsg(m_oMsg.message, m_oMsg.wParam, m_oMsg.lParam);
 			}
 		}
+
+		// Apply any updates and jobs posted while dispatching.
+		m_oUpdates.drain();
+		RunPostedJobs();
 	}
 	catch (const Core::Exception& e)
 	{
@@ -212,6 +225,71 @@ bool CMsgThread::ProcessMsgQueue(bool bRepostQuitMsg)
 	return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+//! Queue a job to be run by the thread's message loop. This can be called from
+//! any thread, e.g. to marshal the result of a pool job back onto the UI thread.
+
+void CMsgThread::PostJob(ThreadJobPtr& pJob)
+{
+	ASSERT(pJob.get() != nullptr);
+
+	{
+		CAutoThreadLock oAutoLock(m_oJobsLock);
+
+		m_oJobs.push_back(pJob);
+	}
+
+	m_oJobsPosted.Signal();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Run the jobs posted by other threads. Jobs cancelled whilst queued are
+//! skipped. An exception thrown by a job is reported, as with a pool thread,
+//! and does not stop the remaining jobs from running.
+
+void CMsgThread::RunPostedJobs()
+{
+	CJobQueue oJobs;
+
+	{
+		CAutoThreadLock oAutoLock(m_oJobsLock);
+
+		if (m_oJobs.empty())
+			return;
+
+		oJobs.swap(m_oJobs);
+	}
+
+	for (CJobQueue::iterator oIter = oJobs.begin(); oIter != oJobs.end(); ++oIter)
+	{
+		ThreadJobPtr pJob = *oIter;
+
+		// Cancelled whilst queued?
+		if (!pJob->ChangeStatus(CThreadJob::PENDING, CThreadJob::RUNNING))
+			continue;
+
+		try
+		{
+			pJob->Run();
+		}
+		catch (const Core::Exception& e)
+		{
+			WCL::ReportUnhandledException(TXT("Unexpected exception caught in RunPostedJobs()\n\n%s"), e.twhat());
+		}
+		catch (const std::exception& e)
+		{
+			WCL::ReportUnhandledException(TXT("Unexpected exception caught in RunPostedJobs()\n\n%hs"), e.what());
+		}
+		catch (...)
+		{
+			WCL::ReportUnhandledException(TXT("Unexpected unknown exception caught in RunPostedJobs()"));
+		}
+
+		pJob->Status(CThreadJob::COMPLETED);
+		pJob->OnFinished();
+	}
+}
+
 #if (__GNUC__ >= 8) // GCC 8+
 #pragma GCC diagnostic pop
 #endif
@@ -237,6 +315,25 @@ bool CMsgThread::WaitForMessageOrSignal(HANDLE handle) const
 	return (result == WAIT_OBJECT_0);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+//! Wait for a message, a cross-thread update or a posted job.
+
+void CMsgThread::WaitForWork() const
+{
+	const DWORD count = 2;
+	HANDLE      handles[count] = { m_oUpdates.event(), m_oJobsPosted.Handle() };
+
+	DWORD result = ::MsgWaitForMultipleObjects(count, handles, FALSE, INFINITE, QS_ALLINPUT);
+
+	ASSERT(result != WAIT_TIMEOUT);
+
+	if (result == WAIT_FAILED)
+		throw WCL::Win32Exception(TXT("Failed to wait for message or signal"));
+
+	if ( (result >= WAIT_ABANDONED_0) && (result <= WAIT_ABANDONED_0+count-1) )
+		throw Core::RuntimeException(TXT("Failed to wait for message or signal - handle abandoned"));
+}
+
 /******************************************************************************
 ** Method:		OnThreadMsg()
 **
@@ -18,7 +18,12 @@
 
 #include "IMsgThread.hpp"
 #include "Thread.hpp"
+#include "UpdateQueue.hpp"
+#include "ThreadJob.hpp"
+#include "CriticalSection.hpp"
+#include "Event.hpp"
 #include <list>
+#include <vector>
 
 /******************************************************************************
 **
@@ -59,6 +64,16 @@ public:
 	//! Wait for message or handle to be signalled.
 	bool WaitForMessageOrSignal(HANDLE handle) const;
 
+	//
+	// Cross-thread updates.
+	//
+
+	//! Get the queue used by other threads to post updates.
+	WCL::UpdateQueue& Updates();
+
+	//! Queue a job to be run by the thread's message loop.
+	void PostJob(ThreadJobPtr& pJob);
+
 	//
 	// Constants.
 	//
@@ -72,6 +87,7 @@ public:
 protected:
 	// Template short-hands.
 	typedef std::list<IMsgFilter*> CMsgFilters;
+	typedef std::vector<ThreadJobPtr> CJobQueue;
 
 	//
 	// Members.
@@ -79,6 +95,10 @@ protected:
 	MSG			m_oMsg;
 	CMsgFilters	m_oMsgFilters;
 	int			m_nResult;			//!< The WM_QUIT result.
+	WCL::UpdateQueue m_oUpdates;	//!< The cross-thread updates.
+	CCriticalSection m_oJobsLock;	//!< The lock for the posted jobs.
+	CJobQueue	m_oJobs;			//!< The jobs posted by other threads.
+	CEvent		m_oJobsPosted;		//!< Signalled when a job is posted.
 
 	// The main thread function.
 	virtual void Run();
@@ -87,6 +107,17 @@ protected:
 	// Message handlers.
 	//
 	virtual void OnThreadMsg(UINT nMsg, WPARAM wParam, LPARAM lParam);
+
+private:
+	//
+	// Internal methods.
+	//
+
+	//! Run the jobs posted by other threads.
+	void RunPostedJobs();
+
+	//! Wait for a message, update or posted job.
+	void WaitForWork() const;
 };
 
 /******************************************************************************
@@ -109,4 +140,13 @@ inline const MSG& CMsgThread::CurrentMsg() const
 	return m_oMsg;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+//! Get the queue used by other threads to post updates. The updates are
+//! applied by the thread's message loop.
+
+inline WCL::UpdateQueue& CMsgThread::Updates()
+{
+	return m_oUpdates;
+}
+
 #endif //MSGTHREAD_HPP
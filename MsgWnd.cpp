@@ -11,6 +11,8 @@
 #include "Common.hpp"
 #include "MsgWnd.hpp"
 #include "ScreenDC.hpp"
+#include "MemDC.hpp"
+#include "Bitmap.hpp"
 #include "App.hpp"
 #include "CmdCtrl.hpp"
 
@@ -35,9 +37,55 @@ CMsgWnd::CMsgWnd()
 	: m_pCtrlMsgTable(nullptr)
 	, m_pbMsgHandled(nullptr)
 	, m_plMsgResult(nullptr)
+	, m_pIndexedTable(nullptr)
+	, m_vCtrlMsgIndex()
+	, m_bBufferedPaint(false)
+	, m_pPaintDC(nullptr)
+	, m_pPaintBmp(nullptr)
 {
 }
 
+/******************************************************************************
+** Method:		Destructor.
+**
+** Description:	Frees the off-screen paint buffer, if allocated.
+**
+** Parameters:	None.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+CMsgWnd::~CMsgWnd()
+{
+	ReleasePaintBuffer();
+}
+
+/******************************************************************************
+** Method:		BufferedPaint()
+**
+** Description:	Enables or disables double-buffered painting. When enabled
+**				OnEraseBackground() and OnPaint() draw onto an off-screen
+**				bitmap the size of the client area, which is then copied to
+**				the screen in one go to avoid flicker. WM_ERASEBKGND is then
+**				ignored as the background is erased in the buffer instead.
+**
+** Parameters:	bEnable		Enable or disable the mode.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CMsgWnd::BufferedPaint(bool bEnable)
+{
+	m_bBufferedPaint = bEnable;
+
+	if (!m_bBufferedPaint)
+		ReleasePaintBuffer();
+}
+
 /******************************************************************************
 ** Method:		WndProc()
 **
@@ -101,6 +149,10 @@ LRESULT CMsgWnd::WndProc(HWND hWnd, UINT iMsg, WPARAM wParam, LPARAM lParam)
 				*m_pbMsgHandled = true;
 				*m_plMsgResult  = TRUE;
 
+				// Erased in the buffer when painted.
+				if (m_bBufferedPaint)
+					return 0;
+
 				// Construct a device and call the method.
 				CScreenDC	DC(reinterpret_cast<HDC>(wParam));
 				OnEraseBackground(DC);
@@ -115,7 +167,11 @@ LRESULT CMsgWnd::WndProc(HWND hWnd, UINT iMsg, WPARAM wParam, LPARAM lParam)
 			{
 				// Construct a device and call the paint method.
 				CScreenDC	DC(psPaint);
-				OnPaint(DC);
+
+				if (m_bBufferedPaint)
+					PaintBuffered(DC, psPaint.rcPaint);
+				else
+					OnPaint(DC);
 			}
 			EndPaint(hWnd, &psPaint);
 			break;
@@ -143,6 +199,12 @@ LRESULT CMsgWnd::WndProc(HWND hWnd, UINT iMsg, WPARAM wParam, LPARAM lParam)
 		case WM_SIZE:
 			{
 				CSize NewSize(LOWORD(lParam), HIWORD(lParam));
+
+				// Buffer no longer matches the client area?
+				if ( (m_pPaintBmp != nullptr) && (wParam != SIZE_MINIMIZED)
+				  && (m_pPaintBmp->Size() != NewSize) )
+					ReleasePaintBuffer();
+
 				OnResize(static_cast<WCL::ResizeFlags>(wParam), NewSize);
 			}
 			break;
@@ -232,6 +294,7 @@ LRESULT CMsgWnd::WndProc(HWND hWnd, UINT iMsg, WPARAM wParam, LPARAM lParam)
 
 		// Window being destroyed (Non-client).
 		case WM_NCDESTROY:
+			ReleasePaintBuffer();
 			OnNCDestroy();
 			break;
 
@@ -447,16 +510,11 @@ void CMsgWnd::OnCtrlMsg(uint iID, uint iMsg, HWND hControl)
 	if (pWnd != nullptr)
 		pWnd->OnReflectedCtrlMsg(iMsg);
 
-	CTRLMSG* pCtrlMsg = m_pCtrlMsgTable;
-
 	// Find control callback function.
-	while ( (pCtrlMsg) && (pCtrlMsg->m_iCtrlID)
-		 && ((pCtrlMsg->m_iMsgType != WM_COMMAND) || (pCtrlMsg->m_iCtrlID != iID) || (pCtrlMsg->m_iMsgID != iMsg)) )
-	    ++pCtrlMsg;
+	const CTRLMSG* pCtrlMsg = FindCtrlMsg(WM_COMMAND, iID, iMsg);
 
 	// If found, call handler.
-	if ( (pCtrlMsg) && (pCtrlMsg->m_iMsgType == WM_COMMAND)
-	  && (pCtrlMsg->m_iCtrlID == iID) && (pCtrlMsg->m_iMsgID == iMsg) )
+	if (pCtrlMsg != nullptr)
 	{
 		PFNCMDMSGHANDLER pfnMsgHandler = reinterpret_cast<PFNCMDMSGHANDLER>(pCtrlMsg->m_pfnMsgHandler);
 		(this->*pfnMsgHandler)();
@@ -484,31 +542,155 @@ LRESULT CMsgWnd::OnCtrlMsg(NMHDR& rMsgHdr)
 	// Find if control is mapped.
 	CMsgWnd* pWnd = static_cast<CMsgWnd*>(CWnd::s_WndMap.Find(rMsgHdr.hwndFrom));
 
+	LRESULT  lResult  = 0;
+	bool     bHandled = false;
+
 	// Reflect message back to control.
 	if (pWnd != nullptr)
-		pWnd->OnReflectedCtrlMsg(rMsgHdr);
+		bHandled = pWnd->OnReflectedNfyMsg(rMsgHdr, lResult);
 
-	LRESULT  lResult  = 0;
-	CTRLMSG* pCtrlMsg = m_pCtrlMsgTable;
 	WCL::ControlID iID = rMsgHdr.idFrom;
 	uint	 iMsg     = rMsgHdr.code;
 
 	// Find control callback function.
-	while ( (pCtrlMsg) && (pCtrlMsg->m_iCtrlID)
-		 && ((pCtrlMsg->m_iMsgType != WM_NOTIFY) || (pCtrlMsg->m_iCtrlID != iID) || (pCtrlMsg->m_iMsgID != iMsg)) )
-	    ++pCtrlMsg;
+	const CTRLMSG* pCtrlMsg = FindCtrlMsg(WM_NOTIFY, static_cast<uint>(iID), iMsg);
 
 	// If found, call handler.
-	if ( (pCtrlMsg) && (pCtrlMsg->m_iMsgType == WM_NOTIFY)
-	  && (pCtrlMsg->m_iCtrlID == iID) && (pCtrlMsg->m_iMsgID == iMsg) )
+	if (pCtrlMsg != nullptr)
 	{
 		PFNNFYMSGHANDLER pfnMsgHandler = reinterpret_cast<PFNNFYMSGHANDLER>(pCtrlMsg->m_pfnMsgHandler);
-		lResult = (this->*pfnMsgHandler)(rMsgHdr);
+		LRESULT lHandlerResult = (this->*pfnMsgHandler)(rMsgHdr);
+
+		// Control result takes precedence.
+		if (!bHandled)
+			lResult = lHandlerResult;
 	}
 
 	return lResult;
 }
 
+/******************************************************************************
+** Method:		FindCtrlMsg()
+**
+** Description:	Find the first entry in the control message table for the
+**				message. The table is compiled into a hash index the first time
+**				it is used (or whenever the table is replaced) so that each
+**				lookup is independent of the number of entries.
+**
+** Parameters:	iMsgType	WM_COMMAND or WM_NOTIFY.
+**				iCtrlID		The ID of the control.
+**				iMsgID		The control message ID.
+**
+** Returns:		The table entry or nullptr if the message is not mapped.
+**
+*******************************************************************************
+*/
+
+const CMsgWnd::CTRLMSG* CMsgWnd::FindCtrlMsg(uint iMsgType, uint iCtrlID, uint iMsgID)
+{
+	if (m_pCtrlMsgTable == nullptr)
+		return nullptr;
+
+	if (m_pIndexedTable != m_pCtrlMsgTable)
+		BuildCtrlMsgIndex();
+
+	const size_t nMask = m_vCtrlMsgIndex.size()-1;
+
+	// Linear probe until we find the message or an empty slot.
+	for (size_t nSlot = HashCtrlMsg(iMsgType, iCtrlID, iMsgID) & nMask; ; nSlot = (nSlot+1) & nMask)
+	{
+		const CTRLMSG* pCtrlMsg = m_vCtrlMsgIndex[nSlot];
+
+		if (pCtrlMsg == nullptr)
+			return nullptr;
+
+		if ( (pCtrlMsg->m_iMsgType == iMsgType) && (pCtrlMsg->m_iCtrlID == iCtrlID)
+		  && (pCtrlMsg->m_iMsgID == iMsgID) )
+			return pCtrlMsg;
+	}
+}
+
+/******************************************************************************
+** Method:		BuildCtrlMsgIndex()
+**
+** Description:	Compile the control message table into an open-addressed hash
+**				index. Where the table contains duplicate entries only the
+**				first is indexed to match the original linear search.
+**
+** Parameters:	None.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CMsgWnd::BuildCtrlMsgIndex()
+{
+	ASSERT(m_pCtrlMsgTable != nullptr);
+
+	size_t nEntries = 0;
+
+	for (const CTRLMSG* pCtrlMsg = m_pCtrlMsgTable; pCtrlMsg->m_iCtrlID != 0; ++pCtrlMsg)
+		++nEntries;
+
+	// Keep the load factor under 50% so probe sequences stay short.
+	size_t nSlots = 8;
+
+	while (nSlots < (nEntries * 2))
+		nSlots *= 2;
+
+	const size_t nMask = nSlots-1;
+
+	m_vCtrlMsgIndex.assign(nSlots, nullptr);
+
+	for (const CTRLMSG* pCtrlMsg = m_pCtrlMsgTable; pCtrlMsg->m_iCtrlID != 0; ++pCtrlMsg)
+	{
+		size_t nSlot = HashCtrlMsg(pCtrlMsg->m_iMsgType, pCtrlMsg->m_iCtrlID, pCtrlMsg->m_iMsgID) & nMask;
+
+		while (m_vCtrlMsgIndex[nSlot] != nullptr)
+		{
+			const CTRLMSG* pExisting = m_vCtrlMsgIndex[nSlot];
+
+			// Duplicate entry?
+			if ( (pExisting->m_iMsgType == pCtrlMsg->m_iMsgType) && (pExisting->m_iCtrlID == pCtrlMsg->m_iCtrlID)
+			  && (pExisting->m_iMsgID == pCtrlMsg->m_iMsgID) )
+				break;
+
+			nSlot = (nSlot+1) & nMask;
+		}
+
+		if (m_vCtrlMsgIndex[nSlot] == nullptr)
+			m_vCtrlMsgIndex[nSlot] = pCtrlMsg;
+	}
+
+	m_pIndexedTable = m_pCtrlMsgTable;
+}
+
+/******************************************************************************
+** Method:		HashCtrlMsg()
+**
+** Description:	Calculate the hash index value for a control message.
+**
+** Parameters:	iMsgType	WM_COMMAND or WM_NOTIFY.
+**				iCtrlID		The ID of the control.
+**				iMsgID		The control message ID.
+**
+** Returns:		The hash value.
+**
+*******************************************************************************
+*/
+
+size_t CMsgWnd::HashCtrlMsg(uint iMsgType, uint iCtrlID, uint iMsgID)
+{
+	uint nHash = (iCtrlID * 0x9E3779B1u) ^ (iMsgID * 0x85EBCA77u) ^ iMsgType;
+
+	nHash ^= (nHash >> 16);
+	nHash *= 0x45D9F3Bu;
+	nHash ^= (nHash >> 16);
+
+	return nHash;
+}
+
 /******************************************************************************
 ** Method:		OnReflectedCtrlMsg()
 **
@@ -547,6 +729,30 @@ void CMsgWnd::OnReflectedCtrlMsg(NMHDR& /*rMsgHdr*/)
 {
 }
 
+/******************************************************************************
+** Method:		OnReflectedNfyMsg()
+**
+** Description:	A WM_NOTIFY style message from this child has been sent to the
+**				parent and reflected back here to the control. This is used by
+**				controls which need to return a result for the message, such
+**				as when answering owner-data notifications. The default
+**				implementation forwards to OnReflectedCtrlMsg().
+**
+** Parameters:	rMsgHdr		The message.
+**				lResult		The result to return, if handled.
+**
+** Returns:		true if the control provided the result, false if not.
+**
+*******************************************************************************
+*/
+
+bool CMsgWnd::OnReflectedNfyMsg(NMHDR& rMsgHdr, LRESULT& /*lResult*/)
+{
+	OnReflectedCtrlMsg(rMsgHdr);
+
+	return false;
+}
+
 /******************************************************************************
 ** Method:		OnActivate()
 **
@@ -755,3 +961,77 @@ void CMsgWnd::OnHitTest(const CPoint& ptCursor)
 {
 	DefaultWndProc(m_hWnd, WM_NCHITTEST, 0, MAKELPARAM(ptCursor.x, ptCursor.y));
 }
+
+/******************************************************************************
+** Method:		PaintBuffered()
+**
+** Description:	Paints the window via the off-screen buffer. The buffer is
+**				created on first use and reused until the window is resized.
+**				Drawing is clipped to the invalid region and only that part
+**				of the buffer is copied to the screen.
+**
+** Parameters:	rDC			The screen device.
+**				rcPaint		The region to repaint.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CMsgWnd::PaintBuffered(CDC& rDC, const CRect& rcPaint)
+{
+	if (rcPaint.Empty())
+		return;
+
+	// Create the buffer on first use.
+	if (m_pPaintDC == nullptr)
+	{
+		CRect rcClient = ClientRect();
+
+		if (rcClient.Empty())
+			return;
+
+		m_pPaintBmp = new CBitmap;
+		m_pPaintBmp->Create(rcClient.Size(), rDC);
+
+		m_pPaintDC = new CMemDC(rDC);
+		m_pPaintDC->Select(*m_pPaintBmp);
+	}
+
+	CMemDC& MemDC  = *m_pPaintDC;
+	int     iState = MemDC.SaveState();
+
+	// Only draw the invalid region.
+	::IntersectClipRect(MemDC.Handle(), rcPaint.left, rcPaint.top, rcPaint.right, rcPaint.bottom);
+
+	OnEraseBackground(MemDC);
+	OnPaint(MemDC);
+
+	// Deselect anything selected by the handlers.
+	MemDC.RestoreState(iState);
+
+	::BitBlt(rDC.Handle(), rcPaint.left, rcPaint.top, rcPaint.Width(), rcPaint.Height(),
+				MemDC.Handle(), rcPaint.left, rcPaint.top, SRCCOPY);
+}
+
+/******************************************************************************
+** Method:		ReleasePaintBuffer()
+**
+** Description:	Frees the off-screen paint buffer, if allocated. The device
+**				is freed first so that the bitmap is no longer selected.
+**
+** Parameters:	None.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CMsgWnd::ReleasePaintBuffer()
+{
+	delete m_pPaintDC;
+	m_pPaintDC = nullptr;
+
+	delete m_pPaintBmp;
+	m_pPaintBmp = nullptr;
+}
@@ -17,10 +17,13 @@
 #endif
 
 #include "Wnd.hpp"
+#include <vector>
 
 // Forward declarations.
 class CPoint;
 class CDC;
+class CMemDC;
+class CBitmap;
 
 /******************************************************************************
 **
@@ -38,6 +41,13 @@ public:
 	// Constructors/Destructor.
 	//
 	CMsgWnd();
+	virtual ~CMsgWnd();
+
+	//
+	// Painting methods.
+	//
+	void BufferedPaint(bool bEnable);
+	bool IsBufferedPaint() const;
 
 	//
 	// Scroll bar methods.
@@ -101,6 +111,7 @@ protected:
 	virtual LRESULT OnCtrlMsg(NMHDR& rMsgHdr);
 	virtual void OnReflectedCtrlMsg(uint iMsg);
 	virtual void OnReflectedCtrlMsg(NMHDR& rMsgHdr);
+	virtual bool OnReflectedNfyMsg(NMHDR& rMsgHdr, LRESULT& lResult);
 	virtual void OnMeasureItem(uint iID, uint iItem, uint& iWidth, uint& iHeight);
 	virtual void OnDrawItem(uint iID, uint iAction, uint iState, CDC& rDC, uint iItem, const CRect& rcItem);
 	virtual void OnSetCursor(HWND hWnd, uint nHitCode, uint nMouseMsg);
@@ -135,6 +146,21 @@ private:
 	//
 	WCL::DlgResult*	m_pbMsgHandled;		// Was message handled?
 	LRESULT*		m_plMsgResult;		// Message result code.
+	const CTRLMSG*	m_pIndexedTable;	// The table the index was built from.
+	std::vector<const CTRLMSG*> m_vCtrlMsgIndex;	// Hash index of the table.
+	bool			m_bBufferedPaint;	// Paint via an off-screen buffer?
+	CMemDC*			m_pPaintDC;			// The off-screen device.
+	CBitmap*		m_pPaintBmp;		// The off-screen bitmap.
+
+	//
+	// Internal methods.
+	//
+	const CTRLMSG* FindCtrlMsg(uint iMsgType, uint iCtrlID, uint iMsgID);
+	void BuildCtrlMsgIndex();
+	void PaintBuffered(CDC& rDC, const CRect& rcPaint);
+	void ReleasePaintBuffer();
+
+	static size_t HashCtrlMsg(uint iMsgType, uint iCtrlID, uint iMsgID);
 
 	// NotCopyable.
 	CMsgWnd(const CMsgWnd&);
@@ -164,6 +190,11 @@ private:
 *******************************************************************************
 */
 
+inline bool CMsgWnd::IsBufferedPaint() const
+{
+	return m_bBufferedPaint;
+}
+
 inline int CMsgWnd::HorzScrollPos(int iPos, bool bRepaint)
 {
 	return ::SetScrollPos(m_hWnd, SB_HORZ, iPos, bRepaint);
@@ -10,6 +10,7 @@
 
 #include "Common.hpp"
 #include "Pen.hpp"
+#include "GDICache.hpp"
 
 /******************************************************************************
 ** Method:		Constructor.
@@ -26,12 +27,14 @@
 CPen::CPen()
 	: m_hPen(NULL)
 	, m_bOwner(false)
+	, m_bShared(false)
 {
 }
 
 CPen::CPen(int iID)
 	: m_hPen()
 	, m_bOwner()
+	, m_bShared()
 {
 	Create(iID);
 }
@@ -39,6 +42,7 @@ CPen::CPen(int iID)
 CPen::CPen(int iStyle, int iWidth, COLORREF crClr)
 	: m_hPen()
 	, m_bOwner()
+	, m_bShared()
 {
 	Create(iStyle, iWidth, crClr);
 }
@@ -57,13 +61,13 @@ CPen::CPen(int iStyle, int iWidth, COLORREF crClr)
 
 CPen::~CPen()
 {
-	// Delete if valid and we own it.
-	if ( (m_hPen) && (m_bOwner) )
-		::DeleteObject(m_hPen);
+	Release();
 }
 
 void CPen::Create(int iID)
 {
+	Release();
+
 	m_hPen   = GetStockPen(iID);
 	m_bOwner = false;
 
@@ -72,8 +76,63 @@ void CPen::Create(int iID)
 
 void CPen::Create(int iStyle, int iWidth, COLORREF crClr)
 {
+	Release();
+
 	m_hPen   = ::CreatePen(iStyle, iWidth, crClr);
 	m_bOwner = true;
 
 	ASSERT(m_hPen != NULL);
 }
+
+/******************************************************************************
+** Method:		CreateShared()
+**
+** Description:	Acquire the pen from the process-wide GDI object cache. Objects
+**				with the same definition share the same handle, which is
+**				released back to the cache.
+**
+** Parameters:	iStyle	The pen style.
+**				iWidth	The pen width.
+**				crClr	The pen colour.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CPen::CreateShared(int iStyle, int iWidth, COLORREF crClr)
+{
+	Release();
+
+	m_hPen    = WCL::GDICache::instance().acquirePen(iStyle, iWidth, crClr);
+	m_bShared = true;
+
+	ASSERT(m_hPen != NULL);
+}
+
+/******************************************************************************
+** Method:		Release()
+**
+** Description:	Releases the resources by destroying it, if we're the owner,
+**				or returning it to the cache, if it's shared.
+**
+** Parameters:	None.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CPen::Release()
+{
+	// Free resource, if the owner.
+	if ( (m_hPen != NULL) && (m_bOwner) )
+		::DeleteObject(m_hPen);
+	else if ( (m_hPen != NULL) && (m_bShared) )
+		WCL::GDICache::instance().release(m_hPen);
+
+	// Reset state.
+	m_hPen    = NULL;
+	m_bOwner  = false;
+	m_bShared = false;
+}
@@ -36,6 +36,7 @@ public:
 
 	void Create(int iID);
 	void Create(int iStyle, int iWidth, COLORREF crClr);
+	void CreateShared(int iStyle, int iWidth, COLORREF crClr);
 
 	//
 	// Member access.
@@ -48,6 +49,12 @@ protected:
 	//
 	HPEN	m_hPen;
 	bool	m_bOwner;
+	bool	m_bShared;
+
+	//
+	// Internal methods.
+	//
+	void Release();
 
 	CORE_NOT_COPYABLE(CPen);
 };
@@ -13,6 +13,7 @@
 #include "StatusBarPanel.hpp"
 #include "ScreenDC.hpp"
 #include "App.hpp"
+#include <algorithm>
 
 /******************************************************************************
 **
@@ -51,6 +52,9 @@ CStatusBar::CStatusBar(bool bSizeGrip)
 	, m_pActive(nullptr)
 	, m_apPanels()
 	, m_oHintBar()
+	, m_nInterval(DEFAULT_INTERVAL)
+	, m_bTimerActive(false)
+	, m_apDirty()
 {
 }
 
@@ -133,6 +137,7 @@ void CStatusBar::OnCreate(const CRect& rcClient)
 {
 	// Create the child windows.
 	m_oHintBar.Create(*this, IDC_HINT_BAR, rcClient);
+	m_oHintBar.m_pStatusBar = this;
 
 	// Set active window to be the hint window.
 	m_pActive = &m_oHintBar;
@@ -381,8 +386,105 @@ void CStatusBar::AddPanel(CStatusBarPanel& oPanel)
 	ASSERT(oPanel.Handle() != NULL);
 
 	m_apPanels.push_back(&oPanel);
+	oPanel.m_pStatusBar = this;
 
 	// Force a layout change, if window created.
 	if (m_hWnd != NULL)
 		OnResize(SIZE_RESTORED, ClientRect().Size());
 }
+
+/******************************************************************************
+** Method:		RepaintInterval()
+**
+** Description:	Sets the minimum time between repaints of a single panel. A
+**				value of 0 repaints panels as soon as they change.
+**
+** Parameters:	nInterval	The interval in milliseconds.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CStatusBar::RepaintInterval(uint nInterval)
+{
+	m_nInterval = nInterval;
+}
+
+/******************************************************************************
+** Method:		PanelChanged()
+**
+** Description:	Schedules the repaint of a panel whose content has changed.
+**				The first change is repainted immediately and starts the
+**				repaint timer. Further changes before the timer fires are
+**				coalesced so that each panel is only repainted once per
+**				interval.
+**
+** Parameters:	oPanel	The panel that has changed.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CStatusBar::PanelChanged(CWnd& oPanel)
+{
+	ASSERT(oPanel.Handle() != NULL);
+
+	// Repaint now?
+	if ( (m_hWnd == NULL) || (m_nInterval == 0) )
+	{
+		oPanel.Invalidate();
+		return;
+	}
+
+	// Start of a new interval?
+	if (!m_bTimerActive)
+	{
+		oPanel.Invalidate();
+
+		StartTimer(REPAINT_TIMER_ID, m_nInterval);
+		m_bTimerActive = true;
+		return;
+	}
+
+	// Defer until the timer fires.
+	if (std::find(m_apDirty.begin(), m_apDirty.end(), &oPanel) == m_apDirty.end())
+		m_apDirty.push_back(&oPanel);
+}
+
+/******************************************************************************
+** Method:		OnTimer()
+**
+** Description:	Repaints the panels that have changed during the last interval.
+**				The timer is stopped once an interval passes with no changes.
+**
+** Parameters:	iTimerID	The timer ID.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CStatusBar::OnTimer(WCL::TimerID iTimerID)
+{
+	// Not our timer?
+	if (iTimerID != REPAINT_TIMER_ID)
+	{
+		CCtrlWnd::OnTimer(iTimerID);
+		return;
+	}
+
+	// Nothing changed?
+	if (m_apDirty.empty())
+	{
+		StopTimer(REPAINT_TIMER_ID);
+		m_bTimerActive = false;
+		return;
+	}
+
+	for (CWnds::const_iterator oIter = m_apDirty.begin(); oIter != m_apDirty.end(); ++oIter)
+		(*oIter)->Invalidate();
+
+	m_apDirty.clear();
+}
@@ -43,6 +43,12 @@ public:
 	// Panel methods.
 	//
 	void AddPanel(CStatusBarPanel& oPanel);
+	void PanelChanged(CWnd& oPanel);
+
+	//
+	// Repaint methods.
+	//
+	void RepaintInterval(uint nInterval);
 
 	//
 	// Hint methods.
@@ -53,6 +59,7 @@ public:
 protected:
 	// Template shorthands.
 	typedef std::vector<CStatusBarPanel*> CPanels;
+	typedef std::vector<CWnd*> CWnds;
 
 	//
 	// Members.
@@ -61,10 +68,19 @@ protected:
 	CWnd*			m_pActive;		// Active window to left of status bar.
 	CPanels			m_apPanels;		// Status bar panels on right-hand side.
 	CHintBar		m_oHintBar;		// The menu/toolbar hint window.
+	uint			m_nInterval;	// Minimum time between panel repaints.
+	bool			m_bTimerActive;	// Is the repaint timer running?
+	CWnds			m_apDirty;		// Panels waiting to be repainted.
 
 	// Child window IDs.
 	static const uint IDC_HINT_BAR = 100;
 
+	// Timer IDs.
+	static const uint REPAINT_TIMER_ID = 1;
+
+	// Default repaint interval (ms).
+	static const uint DEFAULT_INTERVAL = 50;
+
 	//
 	// Internal methods.
 	//
@@ -83,6 +99,7 @@ protected:
 	virtual void OnPaint(CDC& rDC);
 	virtual void OnResize(int iFlag, const CSize& rNewSize);
 	virtual void OnHitTest(const CPoint& ptCursor);
+	virtual void OnTimer(WCL::TimerID iTimerID);
 
 private:
 	// NotCopyable.
@@ -153,10 +153,16 @@ void CStatusBarIcon::ClearIcon(bool bForcePaint)
 	m_pBitmap = nullptr;
 	m_nIndex  = 0;
 
-	Invalidate();
-
+	// Repaint now or let the status bar coalesce it.
 	if (bForcePaint)
+	{
+		Invalidate();
 		Update();
+	}
+	else
+	{
+		ContentChanged();
+	}
 }
 
 /******************************************************************************
@@ -182,8 +188,14 @@ void CStatusBarIcon::SetIcon(const CTransparentBmp& oBitmap, uint nIndex, bool b
 	m_pBitmap = &oBitmap;
 	m_nIndex  = nIndex;
 
-	Invalidate();
-
+	// Repaint now or let the status bar coalesce it.
 	if (bForcePaint)
+	{
+		Invalidate();
 		Update();
+	}
+	else
+	{
+		ContentChanged();
+	}
 }
@@ -142,9 +142,12 @@ void CStatusBarLabel::SetLabel(const tchar* pszLabel)
 {
 	ASSERT(pszLabel != NULL);
 
+	// Ignore, if same label.
+	if (m_strLabel == pszLabel)
+		return;
+
 	m_strLabel = pszLabel;
 
 	// Repaint, if created.
-	if (m_hWnd != NULL)
-		Invalidate();
+	ContentChanged();
 }
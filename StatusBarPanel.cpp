@@ -11,6 +11,7 @@
 #include "Common.hpp"
 #include "StatusBarPanel.hpp"
 #include "DC.hpp"
+#include "StatusBar.hpp"
 
 /******************************************************************************
 ** Method:		Constructor.
@@ -25,6 +26,7 @@
 */
 
 CStatusBarPanel::CStatusBarPanel()
+	: m_pStatusBar(nullptr)
 {
 }
 
@@ -105,3 +107,29 @@ void CStatusBarPanel::OnPaint(CDC& rDC)
 
 	rDC.Border3D(rcClient, false, false);
 }
+
+/******************************************************************************
+** Method:		ContentChanged()
+**
+** Description:	Requests a repaint of the panel after its content has changed.
+**				The repaint is scheduled by the status bar so that frequent
+**				changes are coalesced.
+**
+** Parameters:	None.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CStatusBarPanel::ContentChanged()
+{
+	// Ignore, if not created.
+	if (m_hWnd == NULL)
+		return;
+
+	if (m_pStatusBar != nullptr)
+		m_pStatusBar->PanelChanged(*this);
+	else
+		Invalidate();
+}
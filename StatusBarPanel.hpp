@@ -18,6 +18,9 @@
 
 #include "CtrlWnd.hpp"
 
+// Forward declarations.
+class CStatusBar;
+
 /******************************************************************************
 ** 
 ** The base class for child windows that sit on the right of the status bar.
@@ -43,6 +46,12 @@ protected:
 	//
 	// Members.
 	//
+	CStatusBar*	m_pStatusBar;	// The owning status bar, if any.
+
+	//
+	// Internal methods.
+	//
+	void ContentChanged();
 
 	//
 	// Window creation template methods.
@@ -54,6 +63,9 @@ protected:
 	// Message processors.
 	//
 	virtual void OnPaint(CDC& rDC);
+
+	// Friends.
+	friend class CStatusBar;
 };
 
 /******************************************************************************
@@ -0,0 +1,194 @@
+/******************************************************************************
+** (C) Chris Oldwood
+**
+** MODULE:		STRARRAY.CPP
+** COMPONENT:	Windows C++ Library
+** DESCRIPTION:	CStrArray class definition.
+**
+*******************************************************************************
+*/
+
+#include "Common.hpp"
+#include "StrArray.hpp"
+
+// The minimum size of the hash index.
+static const size_t MIN_INDEX_SIZE = 16;
+
+/******************************************************************************
+** Method:		IndexFind()
+**
+** Description:	Enable or disable the use of a hash index for case sensitive
+**				calls to Find(). The index is built on the first Find() and is
+**				maintained by Add(). Any other change causes it to be rebuilt
+**				on the next Find().
+**
+** Parameters:	bIndex	True to use the index, false to scan the array.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CStrArray::IndexFind(bool bIndex)
+{
+	m_bIndexFind = bIndex;
+
+	if (!bIndex)
+	{
+		HashIndex vEmpty;
+
+		m_vIndex.swap(vEmpty);
+	}
+
+	InvalidateIndex();
+}
+
+/******************************************************************************
+** Method:		AddToIndex()
+**
+** Description:	Add the string just appended to the array to the hash index,
+**				if it is up to date. If the index is too full it is discarded
+**				so that the next Find() rebuilds it at a larger size.
+**
+** Parameters:	nIndex	The index of the string.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CStrArray::AddToIndex(size_t nIndex)
+{
+	if (!m_bIndexFind || !m_bIndexValid)
+		return;
+
+	// Keep the load factor below a half.
+	if ((nIndex+1) * 2 > m_vIndex.size())
+	{
+		InvalidateIndex();
+		return;
+	}
+
+	const CString& strString = m_vStrings[nIndex];
+
+	InsertIndex(m_vIndex, HashString(strString, strString.Length()), nIndex);
+}
+
+/******************************************************************************
+** Method:		BuildIndex()
+**
+** Description:	Rebuild the hash index from the strings in the array.
+**
+** Parameters:	None.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CStrArray::BuildIndex() const
+{
+	size_t nSize = MIN_INDEX_SIZE;
+
+	while (nSize < (m_vStrings.size() * 2))
+		nSize *= 2;
+
+	m_vIndex.assign(nSize, 0);
+
+	// Insert in order so that the first of any duplicates is found first.
+	for (size_t i = 0; i != m_vStrings.size(); ++i)
+	{
+		const CString& strString = m_vStrings[i];
+
+		InsertIndex(m_vIndex, HashString(strString, strString.Length()), i);
+	}
+
+	m_bIndexValid = true;
+}
+
+/******************************************************************************
+** Method:		FindIndexed()
+**
+** Description:	Find the first occurrence of a string using the hash index.
+**
+** Parameters:	pszString	The string to find.
+**
+** Returns:		The index of the string or Core::npos.
+**
+*******************************************************************************
+*/
+
+size_t CStrArray::FindIndexed(const tchar* pszString) const
+{
+	if (!m_bIndexValid)
+		BuildIndex();
+
+	size_t nLength = tstrlen(pszString);
+	size_t nMask   = m_vIndex.size() - 1;
+	size_t nSlot   = HashString(pszString, nLength) & nMask;
+
+	// Linear probe until an empty slot.
+	for (size_t nEntry = m_vIndex[nSlot]; nEntry != 0; nEntry = m_vIndex[nSlot])
+	{
+		const CString& strString = m_vStrings[nEntry-1];
+
+		if ( (strString.Length() == nLength) && (strString.Compare(pszString, false) == 0) )
+			return nEntry-1;
+
+		nSlot = (nSlot + 1) & nMask;
+	}
+
+	return Core::npos;
+}
+
+/******************************************************************************
+** Method:		HashString()
+**
+** Description:	Calculate the hash of a string, using FNV-1a.
+**
+** Parameters:	pszString	The string.
+**				nLength		The length of the string in chars.
+**
+** Returns:		The hash value.
+**
+*******************************************************************************
+*/
+
+size_t CStrArray::HashString(const tchar* pszString, size_t nLength)
+{
+	size_t nHash = 2166136261u;
+
+	for (size_t i = 0; i != nLength; ++i)
+	{
+		nHash ^= static_cast<utchar>(pszString[i]);
+		nHash *= 16777619u;
+	}
+
+	return nHash;
+}
+
+/******************************************************************************
+** Method:		InsertIndex()
+**
+** Description:	Insert a string index into the first free slot of a hash index.
+**				The index must have a free slot.
+**
+** Parameters:	vIndex	The hash index.
+**				nHash	The hash of the string.
+**				nIndex	The index of the string.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CStrArray::InsertIndex(HashIndex& vIndex, size_t nHash, size_t nIndex)
+{
+	size_t nMask = vIndex.size() - 1;
+	size_t nSlot = nHash & nMask;
+
+	while (vIndex[nSlot] != 0)
+		nSlot = (nSlot + 1) & nMask;
+
+	vIndex[nSlot] = nIndex+1;
+}
@@ -20,7 +20,9 @@
 
 /******************************************************************************
 **
-** This is an array collection that stores strings.
+** This is an array collection that stores strings. The strings are held by
+** value in a single contiguous array and Find() can optionally use a hash
+** index for large arrays that are searched repeatedly.
 **
 ** NB: This class was originally based on a TPtrArray<CString>.
 **
@@ -35,12 +37,18 @@ public:
 	//
 	CStrArray();
 	CStrArray(const CStrArray& oRHS);
+#ifdef WCL_HAS_RVALUE_REFS
+	CStrArray(CStrArray&& oRHS);
+#endif
 	~CStrArray();
 
 	//
 	// Operators.
 	//
 	CStrArray& operator=(const CStrArray& oRHS);
+#ifdef WCL_HAS_RVALUE_REFS
+	CStrArray& operator=(CStrArray&& oRHS);
+#endif
 
 	//
 	// Methods.
@@ -53,23 +61,47 @@ public:
 
 	void Set(size_t nIndex, const CString& rString);
 	size_t Add(const CString& rString);
+#ifdef WCL_HAS_RVALUE_REFS
+	size_t Add(CString&& rString);
+#endif
 	void Insert(size_t nIndex, const CString& rString);
 
 	void Delete(size_t nIndex);
 	void DeleteAll();
 
+	void Reserve(size_t nSize);
+
 	size_t Find(const tchar* pszString, bool bIgnoreCase = false) const;
 
+	//! Use a hash index for case sensitive calls to Find().
+	void IndexFind(bool bIndex);
+
 private:
 	//! The underlying array type..
-	typedef std::vector<CString*> StringVector;
+	typedef std::vector<CString> StringVector;
 	//! A const iterator for the strings vector.
 	typedef StringVector::const_iterator CIter;
+	//! The hash index type.
+	typedef std::vector<size_t> HashIndex;
 
 	//
 	// Members.
 	//
-	StringVector	m_vStrings;		//!< The underlying collection of strings.
+	StringVector		m_vStrings;		//!< The underlying collection of strings.
+	bool				m_bIndexFind;	//!< Use the hash index for Find()?
+	mutable HashIndex	m_vIndex;		//!< The hash table of string indices + 1.
+	mutable bool		m_bIndexValid;	//!< Is the hash index up to date?
+
+	//
+	// Internal methods.
+	//
+	void InvalidateIndex();
+	void AddToIndex(size_t nIndex);
+	void BuildIndex() const;
+	size_t FindIndexed(const tchar* pszString) const;
+
+	static size_t HashString(const tchar* pszString, size_t nLength);
+	static void InsertIndex(HashIndex& vIndex, size_t nHash, size_t nIndex);
 };
 
 /******************************************************************************
@@ -81,34 +113,73 @@ private:
 
 inline CStrArray::CStrArray()
 	: m_vStrings()
+	, m_bIndexFind(false)
+	, m_vIndex()
+	, m_bIndexValid(false)
 {
 }
 
 inline CStrArray::CStrArray(const CStrArray& oRHS)
+	: m_vStrings(oRHS.m_vStrings)
+	, m_bIndexFind(oRHS.m_bIndexFind)
+	, m_vIndex()
+	, m_bIndexValid(false)
+{
+}
+
+#ifdef WCL_HAS_RVALUE_REFS
+
+inline CStrArray::CStrArray(CStrArray&& oRHS)
 	: m_vStrings()
+	, m_bIndexFind(oRHS.m_bIndexFind)
+	, m_vIndex()
+	, m_bIndexValid(oRHS.m_bIndexValid)
 {
-	for (CIter it = oRHS.m_vStrings.begin(); it != oRHS.m_vStrings.end(); ++it)
-		m_vStrings.push_back(new CString(*(*it)));
+	m_vStrings.swap(oRHS.m_vStrings);
+	m_vIndex.swap(oRHS.m_vIndex);
+
+	oRHS.m_bIndexValid = false;
 }
 
+#endif
+
 inline CStrArray::~CStrArray()
 {
-	DeleteAll();
 }
 
 inline CStrArray& CStrArray::operator=(const CStrArray& oRHS)
 {
 	if (this != &oRHS)
 	{
-		DeleteAll();
+		m_vStrings   = oRHS.m_vStrings;
+		m_bIndexFind = oRHS.m_bIndexFind;
+
+		InvalidateIndex();
+	}
+
+	return *this;
+}
+
+#ifdef WCL_HAS_RVALUE_REFS
+
+inline CStrArray& CStrArray::operator=(CStrArray&& oRHS)
+{
+	if (this != &oRHS)
+	{
+		m_vStrings.swap(oRHS.m_vStrings);
+		m_vIndex.swap(oRHS.m_vIndex);
+
+		m_bIndexFind  = oRHS.m_bIndexFind;
+		m_bIndexValid = oRHS.m_bIndexValid;
 
-		for (CIter it = oRHS.m_vStrings.begin(); it != oRHS.m_vStrings.end(); ++it)
-			m_vStrings.push_back(new CString(*(*it)));
+		oRHS.DeleteAll();
 	}
 
 	return *this;
 }
 
+#endif
+
 inline bool CStrArray::Empty() const
 {
 	return m_vStrings.empty();
@@ -123,66 +194,107 @@ inline const CString& CStrArray::At(size_t nIndex) const
 {
 	ASSERT(nIndex < Size());
 
-	return *(m_vStrings.at(nIndex));
+	return m_vStrings.at(nIndex);
 }
 
 inline const CString& CStrArray::operator[](size_t nIndex) const
 {
 	ASSERT(nIndex < Size());
 
-	return *(m_vStrings[nIndex]);
+	return m_vStrings[nIndex];
 }
 
 inline void CStrArray::Set(size_t nIndex, const CString& rString)
 {
 	ASSERT(nIndex < Size());
 
-	*(m_vStrings[nIndex]) = rString;
+	m_vStrings[nIndex] = rString;
+
+	InvalidateIndex();
 }
 
 inline size_t CStrArray::Add(const CString& rString)
 {
-	m_vStrings.push_back(new CString(rString));
+	m_vStrings.push_back(rString);
+
+	size_t nIndex = m_vStrings.size()-1;
+
+	AddToIndex(nIndex);
+
+	return nIndex;
+}
+
+#ifdef WCL_HAS_RVALUE_REFS
+
+inline size_t CStrArray::Add(CString&& rString)
+{
+	m_vStrings.push_back(std::move(rString));
+
+	size_t nIndex = m_vStrings.size()-1;
+
+	AddToIndex(nIndex);
 
-	return m_vStrings.size()-1;
+	return nIndex;
 }
 
+#endif
+
 inline void CStrArray::Insert(size_t nIndex, const CString& rString)
 {
 	ASSERT(nIndex <= Size());
 
-	m_vStrings.insert(m_vStrings.begin()+nIndex, new CString(rString));
+	m_vStrings.insert(m_vStrings.begin()+nIndex, rString);
+
+	InvalidateIndex();
 }
 
 inline void CStrArray::Delete(size_t nIndex)
 {
 	ASSERT(nIndex < Size());
 
-	delete m_vStrings[nIndex];
 	m_vStrings.erase(m_vStrings.begin()+nIndex);
+
+	InvalidateIndex();
 }
 
 inline void CStrArray::DeleteAll()
 {
-	for (CIter it = m_vStrings.begin(); it != m_vStrings.end(); ++it)
-		delete *it;
-
 	m_vStrings.clear();
+
+	InvalidateIndex();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Reserve space for the number of strings expected, to avoid regrowing the
+//! array whilst adding them.
+
+inline void CStrArray::Reserve(size_t nSize)
+{
+	m_vStrings.reserve(nSize);
 }
 
 inline size_t CStrArray::Find(const tchar* pszString, bool bIgnoreCase) const
 {
 	ASSERT(pszString != nullptr);
 
+	if (m_bIndexFind && !bIgnoreCase)
+		return FindIndexed(pszString);
+
 	for (CIter it = m_vStrings.begin(); it != m_vStrings.end(); ++it)
 	{
-		CString* pString = *it;
-
-		if (pString->Compare(pszString, bIgnoreCase) == 0)
+		if (it->Compare(pszString, bIgnoreCase) == 0)
 			return std::distance(m_vStrings.begin(), it);
 	}
 
 	return Core::npos;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+//! Discard the hash index. It is rebuilt on the next indexed Find().
+
+inline void CStrArray::InvalidateIndex()
+{
+	m_bIndexValid = false;
+}
+
 #endif // WCL_STRARRAY_HPP
@@ -29,7 +29,10 @@ CStrTok::CStrTok(const tchar* pszString, tchar cSep, int nFlags)
 	, m_strSeps(&cSep, 1)
 	, m_nFlags(nFlags)
 	, m_eNextToken(END_TOKEN)
+	, m_bWideSeps(false)
 {
+	BuildSepTable();
+
 	if (*pszString != TXT('\0'))
 		m_eNextToken = VALUE_TOKEN;
 }
@@ -51,7 +54,10 @@ CStrTok::CStrTok(const tchar* pszString, const tchar* pszSeps, int nFlags)
 	, m_strSeps(pszSeps)
 	, m_nFlags(nFlags)
 	, m_eNextToken(END_TOKEN)
+	, m_bWideSeps(false)
 {
+	BuildSepTable();
+
 	if (*pszString != TXT('\0'))
 		m_eNextToken = VALUE_TOKEN;
 }
@@ -72,6 +78,36 @@ CStrTok::~CStrTok()
 {
 }
 
+/******************************************************************************
+** Method:		BuildSepTable()
+**
+** Description:	Build the lookup table used to classify the characters as
+**				separators, rather than searching the separator list for each
+**				character. Separators above 255 are rare so they are left to
+**				a search of the list.
+**
+** Parameters:	None.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CStrTok::BuildSepTable()
+{
+	memset(m_abSeps, 0, sizeof(m_abSeps));
+
+	for (const tchar* psz = m_strSeps; *psz != TXT('\0'); ++psz)
+	{
+		const size_t nChar = static_cast<utchar>(*psz);
+
+		if (nChar < 256)
+			m_abSeps[nChar] = true;
+		else
+			m_bWideSeps = true;
+	}
+}
+
 /******************************************************************************
 ** Method:		NextToken()
 **
@@ -85,6 +121,27 @@ CStrTok::~CStrTok()
 */
 
 CString CStrTok::NextToken()
+{
+	Span oToken = NextSpan();
+
+	return CString(oToken.m_pszFirst, oToken.m_nLength);
+}
+
+/******************************************************************************
+** Method:		NextSpan()
+**
+** Description:	Returns the next token, either a string or separator list, as
+**				a view onto the string being tokenised. This avoids allocating
+**				a string for each token.
+**
+** Parameters:	None.
+**
+** Returns:		The next token.
+**
+*******************************************************************************
+*/
+
+CStrTok::Span CStrTok::NextSpan()
 {
 	ASSERT(MoreTokens());
 
@@ -95,7 +152,7 @@ CString CStrTok::NextToken()
 	if (m_eNextToken == VALUE_TOKEN)
 	{
 		// Find next separator or EOS.
-		while ( (*m_pszString != TXT('\0')) && (tstrchr(m_strSeps, *m_pszString) == nullptr) )
+		while ( (*m_pszString != TXT('\0')) && (!IsSep(*m_pszString)) )
 			++m_pszString;
 
 		pszEnd = m_pszString;
@@ -116,7 +173,7 @@ CString CStrTok::NextToken()
 				// Merge consecutive separators?
 				if (m_nFlags & MERGE_SEPS)
 				{
-					while ( (*m_pszString != TXT('\0')) && (tstrchr(m_strSeps, *m_pszString) != nullptr) )
+					while ( (*m_pszString != TXT('\0')) && (IsSep(*m_pszString)) )
 						++m_pszString;
 				}
 			}
@@ -130,14 +187,14 @@ CString CStrTok::NextToken()
 	// Next token is a separator.
 	else //(m_eNextToken == SEPARATOR_TOKEN)
 	{
-		ASSERT(tstrchr(m_strSeps, *m_pszString) != nullptr);
+		ASSERT(IsSep(*m_pszString));
 
 		++m_pszString;
 
 		// Merge consecutive separators?
 		if (m_nFlags & MERGE_SEPS)
 		{
-			while ( (*m_pszString != TXT('\0')) && (tstrchr(m_strSeps, *m_pszString) != nullptr) )
+			while ( (*m_pszString != TXT('\0')) && (IsSep(*m_pszString)) )
 				++m_pszString;
 		}
 
@@ -147,7 +204,9 @@ CString CStrTok::NextToken()
 		m_eNextToken = VALUE_TOKEN;
 	}
 
-	return CString(pszStart, pszEnd-pszStart);
+	Span oToken = { pszStart, static_cast<size_t>(pszEnd-pszStart) };
+
+	return oToken;
 }
 
 /******************************************************************************
@@ -200,3 +259,58 @@ size_t CStrTok::Split(const tchar* pszString, const tchar* pszSeps, CStrArray& a
 
 	return astrFields.Size();
 }
+
+/******************************************************************************
+** Method:		Split()
+**
+** Description:	Splits a string into separate fields, as views onto the string.
+**
+** Parameters:	pszString	The string to split.
+**				cSep		The separator.
+**				vecFields	The vector into which the fields are returned.
+**				nFlags		The split options (See Flags).
+**
+** Returns:		The number of fields.
+**
+*******************************************************************************
+*/
+
+size_t CStrTok::Split(const tchar* pszString, tchar cSep, CSpans& vecFields, uint nFlags)
+{
+	tchar szSeps[2] = {cSep, TXT('\0')};
+
+	return Split(pszString, szSeps, vecFields, nFlags);
+}
+
+/******************************************************************************
+** Method:		Split()
+**
+** Description:	Splits a string into separate fields, as views onto the string.
+**				The vector is cleared first, but keeps its capacity, so that
+**				it can be reused to split many strings without allocating.
+**
+** Parameters:	pszString	The string to split.
+**				pszSeps		The list of separators.
+**				vecFields	The vector into which the fields are returned.
+**				nFlags		The split options (See Flags).
+**
+** Returns:		The number of fields.
+**
+*******************************************************************************
+*/
+
+size_t CStrTok::Split(const tchar* pszString, const tchar* pszSeps, CSpans& vecFields, uint nFlags)
+{
+	ASSERT(pszString != nullptr);
+	ASSERT(pszSeps   != nullptr);
+
+	CStrTok oStrTok(pszString, pszSeps, nFlags);
+
+	vecFields.clear();
+
+	// Add all tokens to the vector.
+	while (oStrTok.MoreTokens())
+		vecFields.push_back(oStrTok.NextSpan());
+
+	return vecFields.size();
+}
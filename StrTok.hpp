@@ -16,6 +16,8 @@
 #pragma once
 #endif
 
+#include <vector>
+
 /******************************************************************************
 **
 ** A string tokeniser.
@@ -34,11 +36,22 @@ public:
 	CStrTok(const tchar* pszString, const tchar* pszSeps, int nFlags = NONE);
 	~CStrTok();
 
+	// A token, as a view onto the string being tokenised.
+	struct Span
+	{
+		const tchar*	m_pszFirst;		// The first character.
+		size_t			m_nLength;		// The number of characters.
+	};
+
+	// Template shorthands.
+	typedef std::vector<Span> CSpans;
+
 	//
 	// Methods.
 	//
 	bool    MoreTokens() const;
 	CString NextToken();
+	Span    NextSpan();
 
 	//
 	// Flags.
@@ -55,6 +68,8 @@ public:
 	//
 	static size_t Split(const tchar* pszString, tchar cSep,           CStrArray& astrFields, uint nFlags = NONE);
 	static size_t Split(const tchar* pszString, const tchar* pszSeps, CStrArray& astrFields, uint nFlags = NONE);
+	static size_t Split(const tchar* pszString, tchar cSep,           CSpans& vecFields, uint nFlags = NONE);
+	static size_t Split(const tchar* pszString, const tchar* pszSeps, CSpans& vecFields, uint nFlags = NONE);
 
 protected:
 	// Token types.
@@ -73,6 +88,14 @@ protected:
 	CString			m_strSeps;		// The list of separators.
 	uint			m_nFlags;		// The tokenising flags.
 	TokenType		m_eNextToken;	// The next token type expected.
+	bool			m_abSeps[256];	// The lookup table for the separators below 256.
+	bool			m_bWideSeps;	// Are there any separators above 255?
+
+	//
+	// Internal methods.
+	//
+	void BuildSepTable();
+	bool IsSep(tchar cChar) const;
 
 private:
 	// NotCopyable.
@@ -92,4 +115,14 @@ inline bool CStrTok::MoreTokens() const
 	return (m_eNextToken != END_TOKEN);
 }
 
+inline bool CStrTok::IsSep(tchar cChar) const
+{
+	const size_t nChar = static_cast<utchar>(cChar);
+
+	if (nChar < 256)
+		return m_abSeps[nChar];
+
+	return (m_bWideSeps && (tstrchr(m_strSeps, cChar) != nullptr));
+}
+
 #endif // STRTOK_HPP
@@ -20,17 +20,18 @@
 #include <tchar.h>
 #include <Core/BadLogicException.hpp>
 #include <Core/AnsiWide.hpp>
+#include <algorithm>
+#include <vector>
 
-/******************************************************************************
-**
-** Class variables.
-**
-*******************************************************************************
-*/
-
-CString::StringData CString::strNULL;
+// A match found when replacing strings.
+struct ReplaceMatch
+{
+	size_t	m_nPos;		// The position of the match.
+	size_t	m_nEntry;	// The replacement table entry matched.
+};
 
-tchar* CString::pszNULL = strNULL.m_acData;
+// Template shorthands.
+typedef std::vector<ReplaceMatch> CReplaceMatches;
 
 /******************************************************************************
 ** Method:		LoadRsc()
@@ -52,12 +53,16 @@ void CString::LoadRsc(uint iRscID)
 
 	BufferSize(nChars+1);
 
+	size_t nLength = 0;
+
 	// Load until buffer is big enough.
-	while(static_cast<size_t>(::LoadString(CModule::This().Handle(), iRscID, m_pszData, static_cast<int>(nChars+1))) == nChars)
+	while((nLength = static_cast<size_t>(::LoadString(CModule::This().Handle(), iRscID, m_pszData, static_cast<int>(nChars+1)))) == nChars)
 	{
 		nChars *= 2;
 		BufferSize(nChars+1);
 	}
+
+	GetData()->m_nLength = nLength;
 }
 
 /******************************************************************************
@@ -81,22 +86,118 @@ void CString::BufferSize(size_t nChars)
 
 	// Increase buffer size?
 	if (pData->m_nAllocSize < nChars)
-	{
-		Free();
+		Attach(Alloc(nChars));
+}
 
-		size_t nBytes = Core::numBytes<tchar>(nChars);
+/******************************************************************************
+** Method:		Reserve()
+**
+** Description:	Ensure enough space is allocated for the string to grow to the
+**				size specified without reallocating. Unlike BufferSize() the
+**				contents are preserved.
+**
+** Parameters:	nChars	The buffer length in characters, inc a null terminator.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
 
-		// Allocate new buffer.
-		pData = static_cast<StringData*>(malloc(nBytes + sizeof(StringData)));
-		ASSERT(pData != nullptr);
+void CString::Reserve(size_t nChars)
+{
+	ASSERT(nChars > 0);
 
-		pData->m_nAllocSize = nChars;
-		pData->m_acData[0]  = TXT('\0');
+	StringData* pOldData = GetData();
 
-		m_pszData = pData->m_acData;
+	// Increase buffer size?
+	if (pOldData->m_nAllocSize < nChars)
+	{
+		size_t      nLength  = Length();
+		StringData* pNewData = Alloc(nChars);
+
+		// Copy old string, inc the null terminator.
+		memcpy(pNewData->m_acData, pOldData->m_acData, Core::numBytes<tchar>(nLength+1));
+		pNewData->m_nLength = nLength;
+
+		// Free old string, if on the heap.
+		Attach(pNewData);
 	}
 }
 
+/******************************************************************************
+** Method:		GrowSize()
+**
+** Description:	Calculate the buffer size to use when appending requires the
+**				buffer to grow. The buffer is at least doubled so that a
+**				string built by repeated appends is reallocated a logarithmic
+**				number of times.
+**
+** Parameters:	nChars	The buffer length required, inc a null terminator.
+**
+** Returns:		The buffer length to allocate.
+**
+*******************************************************************************
+*/
+
+size_t CString::GrowSize(size_t nChars) const
+{
+	size_t nGrowSize = GetData()->m_nAllocSize * 2;
+
+	return std::max(nGrowSize, nChars);
+}
+
+/******************************************************************************
+** Method:		Alloc()
+**
+** Description:	Allocate a heap buffer large enough for the number of characters
+**				specified. The buffer contains an empty string.
+**
+** Parameters:	nChars	The buffer length in characters, inc a null terminator.
+**
+** Returns:		The new buffer.
+**
+*******************************************************************************
+*/
+
+CString::StringData* CString::Alloc(size_t nChars)
+{
+	ASSERT(nChars > 0);
+
+	size_t nBytes = Core::numBytes<tchar>(nChars);
+
+	// Allocate new buffer.
+	StringData* pData = static_cast<StringData*>(malloc(nBytes + sizeof(StringData)));
+	ASSERT(pData != nullptr);
+
+	pData->m_nAllocSize = nChars;
+	pData->m_nLength    = 0;
+	pData->m_acData[0]  = TXT('\0');
+
+	return pData;
+}
+
+/******************************************************************************
+** Method:		Attach()
+**
+** Description:	Replace the current buffer with a heap buffer, freeing the
+**				previous one if it was on the heap.
+**
+** Parameters:	pData	The new buffer.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CString::Attach(StringData* pData)
+{
+	ASSERT(pData != nullptr);
+
+	Free();
+
+	m_pszData = pData->m_acData;
+}
+
 /******************************************************************************
 ** Method:		Copy()
 **
@@ -121,12 +222,17 @@ void CString::Copy(const tchar* lpszBuffer, size_t nChars)
 		return;
 	}
 
-	// Copy.
+	// Stop at an embedded null terminator, like strncpy().
+	nChars = std::find(lpszBuffer, lpszBuffer+nChars, TXT('\0')) - lpszBuffer;
+
+	// Copy, allowing for the source being part of this string.
 	BufferSize(nChars+1);
-	tstrncpy(m_pszData, lpszBuffer, nChars);
+	memmove(m_pszData, lpszBuffer, Core::numBytes<tchar>(nChars));
 
 	// Ensure string is terminated.
 	m_pszData[nChars] = TXT('\0');
+
+	GetData()->m_nLength = nChars;
 }
 
 /******************************************************************************
@@ -147,11 +253,11 @@ void CString::Free()
 {
 	ASSERT(m_pszData);
 
-	// Not empty string?
-	if (m_pszData != pszNULL)
+	// Heap allocated string?
+	if (!IsInline())
 		free(GetData());
 
-	m_pszData = pszNULL;
+	Init();
 }
 
 #if (defined NDEBUG) && (__GNUC__ >= 8) // GCC 8+
@@ -161,63 +267,87 @@ void CString::Free()
 #endif
 
 /******************************************************************************
-** Method:		Operator +=()
+** Method:		Append()
 **
-** Description:	Concatenate the supplied string onto the existing one. Growing
-**				the buffer if necessary.
+** Description:	Concatenate a number of characters onto the existing string,
+**				growing the buffer geometrically if necessary. The copy stops
+**				at an embedded null terminator, like strncpy().
 **
-** Parameters:	rFile	A reference to the file.
+** Parameters:	pszString	The characters to append.
+**				nChars		The number of characters to append.
 **
 ** Returns:		Nothing.
 **
 *******************************************************************************
 */
 
-void CString::operator +=(const tchar* pszString)
+void CString::Append(const tchar* pszString, size_t nChars)
 {
 	ASSERT(m_pszData);
 	ASSERT(pszString);
 
+	// Stop at an embedded null terminator.
+	nChars = std::find(pszString, pszString+nChars, TXT('\0')) - pszString;
+
 	// Ignore empty strings.
-	if (*pszString == TXT('\0'))
+	if (nChars == 0)
 		return;
 
-	size_t iStrLen   = Length();
-	size_t iParamLen = tstrlen(pszString);
+	size_t iStrLen = Length();
 
 	StringData* pOldData = GetData();
 
 	// Buffer big enough?
-	if (pOldData->m_nAllocSize < (iStrLen+iParamLen+1))
+	if (pOldData->m_nAllocSize < (iStrLen+nChars+1))
 	{
-		// Detach old buffer.
-		m_pszData = pszNULL;
-
 		// Allocate a new buffer.
-		BufferSize(iStrLen+iParamLen+1);
+		StringData* pNewData = Alloc(GrowSize(iStrLen+nChars+1));
 
-		// Copy old string and cat new one.
-		tstrcpy(m_pszData, pOldData->m_acData);
-		tstrcat(m_pszData, pszString);
+		// Copy old string and new one, which may be part of the old one.
+		memcpy(pNewData->m_acData, pOldData->m_acData, Core::numBytes<tchar>(iStrLen));
+		memcpy(pNewData->m_acData+iStrLen, pszString, Core::numBytes<tchar>(nChars));
 
-		// Free old string, if not empty string.
-		if (pOldData != &strNULL)
-			free(pOldData);
+		// Free old string, if on the heap.
+		Attach(pNewData);
 	}
 	else
 	{
-		// Just append.
-		tstrcat(m_pszData, pszString);
+		// Just append, allowing for the string overlapping this one.
+		memmove(m_pszData+iStrLen, pszString, Core::numBytes<tchar>(nChars));
 	}
+
+	m_pszData[iStrLen+nChars] = TXT('\0');
+
+	GetData()->m_nLength = iStrLen+nChars;
+}
+
+/******************************************************************************
+** Method:		Operator +=()
+**
+** Description:	Concatenate the supplied string onto the existing one. Growing
+**				the buffer if necessary.
+**
+** Parameters:	pszString	The string to append.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CString::operator +=(const tchar* pszString)
+{
+	ASSERT(pszString);
+
+	Append(pszString, tstrlen(pszString));
 }
 
 /******************************************************************************
 ** Method:		Operator +=()
 **
 ** Description:	Concatenate the supplied character onto the existing string.
-**				It grows the buffer if necessary.
+**				It grows the buffer geometrically if necessary.
 **
-** Parameters:	rFile	A reference to the file.
+** Parameters:	cChar	The character to append.
 **
 ** Returns:		Nothing.
 **
@@ -237,27 +367,21 @@ void CString::operator +=(tchar cChar)
 	// Buffer big enough?
 	if (pOldData->m_nAllocSize < (iStrLen+2))
 	{
-		// Detach old buffer.
-		m_pszData = pszNULL;
-
 		// Allocate a new buffer.
-		BufferSize(iStrLen+2);
+		StringData* pNewData = Alloc(GrowSize(iStrLen+2));
 
-		// Copy old string and cat new one.
-		tstrcpy(m_pszData, pOldData->m_acData);
-		m_pszData[iStrLen]   = cChar;
-		m_pszData[iStrLen+1] = TXT('\0');
+		// Copy old string.
+		memcpy(pNewData->m_acData, pOldData->m_acData, Core::numBytes<tchar>(iStrLen));
 
-		// Free old string, if not empty string.
-		if (pOldData != &strNULL)
-			free(pOldData);
-	}
-	else
-	{
-		// Just append.
-		m_pszData[iStrLen]   = cChar;
-		m_pszData[iStrLen+1] = TXT('\0');
+		// Free old string, if on the heap.
+		Attach(pNewData);
 	}
+
+	// Append.
+	m_pszData[iStrLen]   = cChar;
+	m_pszData[iStrLen+1] = TXT('\0');
+
+	GetData()->m_nLength = iStrLen+1;
 }
 
 #if (defined NDEBUG) && (__GNUC__ >= 8) // GCC 8+
@@ -288,6 +412,7 @@ void CString::ReadString<char>(WCL::IInputStream& stream)
 		const char* charBuffer = static_cast<const char*>(rawBuffer);
 		Core::ansiToWide(charBuffer, charBuffer+numChars, m_pszData);
 #endif
+		InvalidateLength();
 	}
 }
 
@@ -312,6 +437,7 @@ void CString::ReadString<wchar_t>(WCL::IInputStream& stream)
 #else
 		stream.Read(m_pszData, Core::numBytes<wchar_t>(numChars));
 #endif
+		InvalidateLength();
 	}
 }
 
@@ -321,27 +447,49 @@ void CString::ReadString<wchar_t>(WCL::IInputStream& stream)
 template<>
 void CString::WriteString<char>(WCL::IOutputStream& stream) const
 {
-	uint32 numChars = static_cast<uint32>(GetData()->m_nAllocSize);
+#ifdef ANSI_BUILD
+	// Only the string and its terminator are written, not the whole buffer.
+	uint32 numChars = Empty() ? 0 : static_cast<uint32>(Length()+1);
 
 	stream << numChars;
 
 	if (numChars != 0)
-	{
-		stream.Write(T2A(m_pszData), Core::numBytes<char>(numChars));
-	}
+		stream.Write(m_pszData, Core::numBytes<char>(numChars));
+#else
+	std::string buffer = Core::wideToAnsi(m_pszData, m_pszData+Length());
+
+	// Only the string and its terminator are written.
+	uint32 numChars = buffer.empty() ? 0 : static_cast<uint32>(buffer.size()+1);
+
+	stream << numChars;
+
+	if (numChars != 0)
+		stream.Write(buffer.c_str(), Core::numBytes<char>(numChars));
+#endif
 }
 
 template<>
 void CString::WriteString<wchar_t>(WCL::IOutputStream& stream) const
 {
-	uint32 numChars = static_cast<uint32>(GetData()->m_nAllocSize);
+#ifdef ANSI_BUILD
+	std::wstring buffer = Core::ansiToWide(m_pszData, m_pszData+Length());
+
+	// Only the string and its terminator are written.
+	uint32 numChars = buffer.empty() ? 0 : static_cast<uint32>(buffer.size()+1);
 
 	stream << numChars;
 
 	if (numChars != 0)
-	{
-		stream.Write(T2W(m_pszData), Core::numBytes<wchar_t>(numChars));
-	}
+		stream.Write(buffer.c_str(), Core::numBytes<wchar_t>(numChars));
+#else
+	// Only the string and its terminator are written, not the whole buffer.
+	uint32 numChars = Empty() ? 0 : static_cast<uint32>(Length()+1);
+
+	stream << numChars;
+
+	if (numChars != 0)
+		stream.Write(m_pszData, Core::numBytes<wchar_t>(numChars));
+#endif
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -414,29 +562,66 @@ void CString::FormatEx(const tchar* pszFormat, va_list args)
 
 	m_pszData[nResult] = TXT('\0');
 
+	GetData()->m_nLength = nResult;
+
 #else
 
-	// Allocate an initial buffer.
-	size_t nLength = 256;
+	// The size of the initial buffer, on the stack.
+	const size_t STACK_CHARS = 512;
 
-	BufferSize(nLength+1);
+	// The largest buffer tried, when the length required is not known.
+	const size_t MAX_GUESS_CHARS = 64*1024*1024;
 
-	int nResult = -1;
+	tchar   szBuffer[STACK_CHARS];
+	va_list argsCopy;
 
-	// Format the string, growing the buffer and repeating if necessary.
-	while ((nResult = _vsntprintf(m_pszData, nLength, pszFormat, args)) == -1)
+	// Format into the stack buffer first, which is enough for most strings.
+	va_copy(argsCopy, args);
+	int nResult = _vsntprintf(szBuffer, STACK_CHARS, pszFormat, argsCopy);
+	va_end(argsCopy);
+
+	if ( (nResult >= 0) && (static_cast<size_t>(nResult) < STACK_CHARS) )
 	{
-		nLength *= 2;
-		BufferSize(nLength+1);
+		Copy(szBuffer, nResult);
+		return;
 	}
 
-	ASSERT(static_cast<size_t>(nResult) <= nLength);
+	// A C99 style result is the length required, otherwise keep doubling.
+	size_t nLength = (nResult >= 0) ? static_cast<size_t>(nResult) : (STACK_CHARS*2);
 
-	// Handle any errors.
-	if (nResult < 0)
-		throw Core::BadLogicException(Core::fmt(TXT("Insufficient buffer size calculated in CString::FormatEx(). Result: %d"), nResult));
+	for (;;)
+	{
+		// Format into a new buffer, as the arguments may refer to this string.
+		StringData* pData = Alloc(nLength+1);
 
-	m_pszData[nResult] = TXT('\0');
+		va_copy(argsCopy, args);
+		nResult = _vsntprintf(pData->m_acData, nLength+1, pszFormat, argsCopy);
+		va_end(argsCopy);
+
+		if ( (nResult >= 0) && (static_cast<size_t>(nResult) <= nLength) )
+		{
+			pData->m_acData[nResult] = TXT('\0');
+			pData->m_nLength         = nResult;
+
+			Attach(pData);
+			return;
+		}
+
+		free(pData);
+
+		if (nResult >= 0)
+		{
+			nLength = static_cast<size_t>(nResult);
+		}
+		else
+		{
+			// Give up, rather than keep doubling forever on a format error.
+			if (nLength >= MAX_GUESS_CHARS)
+				throw Core::BadLogicException(Core::fmt(TXT("Insufficient buffer size calculated in CString::FormatEx(). Result: %d"), nResult));
+
+			nLength *= 2;
+		}
+	}
 
 #endif
 }
@@ -477,6 +662,109 @@ CString CString::FmtEx(const tchar* pszFormat, va_list args)
 	return str;
 }
 
+/******************************************************************************
+** Method:		AppendFmtText()
+**
+** Description:	Append the format string up to the next "{}" placeholder. A
+**				"{{" is appended as a single brace.
+**
+** Parameters:	pszFormat	The format string.
+**
+** Returns:		The format string after the placeholder, or nullptr if there
+**				are no more placeholders.
+**
+*******************************************************************************
+*/
+
+const tchar* CString::AppendFmtText(const tchar* pszFormat)
+{
+	ASSERT(pszFormat != nullptr);
+
+	const tchar* psz = pszFormat;
+
+	for (;;)
+	{
+		const tchar* pszBrace = tstrchr(psz, TXT('{'));
+
+		// No more placeholders?
+		if (pszBrace == nullptr)
+		{
+			operator+=(psz);
+			return nullptr;
+		}
+
+		Append(psz, pszBrace-psz);
+
+		if (pszBrace[1] == TXT('}'))
+			return pszBrace+2;
+
+		// Escaped or unmatched brace.
+		operator+=(TXT('{'));
+		psz = (pszBrace[1] == TXT('{')) ? pszBrace+2 : pszBrace+1;
+	}
+}
+
+/******************************************************************************
+** Method:		AppendArg()
+**
+** Description:	Append an integer argument, converting it directly rather than
+**				via sprintf().
+**
+** Parameters:	nValue	The value to append.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CString::AppendArg(long long nValue)
+{
+	if (nValue < 0)
+	{
+		operator+=(TXT('-'));
+
+		// Negate as unsigned to allow for the most negative value.
+		AppendArg(0ULL - static_cast<unsigned long long>(nValue));
+	}
+	else
+	{
+		AppendArg(static_cast<unsigned long long>(nValue));
+	}
+}
+
+void CString::AppendArg(unsigned long long nValue)
+{
+	tchar  szDigits[32];
+	tchar* pszDigit = szDigits + ARRAY_SIZE(szDigits);
+
+	// Write the digits from the end.
+	do
+	{
+		*--pszDigit = static_cast<tchar>(TXT('0') + (nValue % 10));
+		nValue /= 10;
+	}
+	while (nValue != 0);
+
+	Append(pszDigit, (szDigits + ARRAY_SIZE(szDigits)) - pszDigit);
+}
+
+/******************************************************************************
+** Method:		AppendArg()
+**
+** Description:	Append a floating-point argument. This uses the "%g" format.
+**
+** Parameters:	dValue	The value to append.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CString::AppendArg(double dValue)
+{
+	Append(Fmt(TXT("%g"), dValue));
+}
+
 /******************************************************************************
 ** Method:		Find()
 **
@@ -602,13 +890,7 @@ CString CString::Left(size_t nCount) const
 	if ( (nCount == 0) || (Length() == 0) )
 		return TXT("");
 
-	CString str;
-
-	str.BufferSize(nCount+1);
-	tstrncpy(str.m_pszData, m_pszData, nCount);
-	str.m_pszData[nCount] = TXT('\0');
-
-	return str;
+	return CString(m_pszData, nCount);
 }
 
 /******************************************************************************
@@ -635,13 +917,7 @@ CString CString::Mid(size_t nFirst, size_t nCount) const
 	if ( (nCount == 0) || (Length() == 0) )
 		return TXT("");
 
-	CString str;
-
-	str.BufferSize(nCount+1);
-	tstrncpy(str.m_pszData, m_pszData+nFirst, nCount);
-	str.m_pszData[nCount] = TXT('\0');
-
-	return str;
+	return CString(m_pszData+nFirst, nCount);
 }
 
 /******************************************************************************
@@ -664,13 +940,7 @@ CString CString::Right(size_t nCount) const
 	if ( (nCount == 0) || (Length() == 0) )
 		return TXT("");
 
-	CString str;
-
-	str.BufferSize(nCount+1);
-	tstrncpy(str.m_pszData, m_pszData+Length()-nCount, nCount);
-	str.m_pszData[nCount] = TXT('\0');
-
-	return str;
+	return CString(m_pszData+Length()-nCount, nCount);
 }
 
 /******************************************************************************
@@ -689,7 +959,7 @@ CString CString::Right(size_t nCount) const
 void CString::Insert(size_t nPos, const tchar* pszString)
 {
 	ASSERT(pszString != nullptr);
-	ASSERT(nPos <= tstrlen(m_pszData));
+	ASSERT(nPos <= Length());
 
 	// Get extra text length.
 	size_t nTextLen = tstrlen(pszString);
@@ -711,27 +981,26 @@ void CString::Insert(size_t nPos, const tchar* pszString)
 	{
 		StringData* pOldData = GetData();
 
-		// Detach old buffer.
-		m_pszData = pszNULL;
-
 		// Allocate a new buffer.
-		BufferSize(nThisLen+nTextLen+1);
+		StringData* pNewData = Alloc(nThisLen+nTextLen+1);
+		tchar*      pszData  = pNewData->m_acData;
 
 		// Copy leading chars from old text.
-		tstrncpy(m_pszData, pOldData->m_acData, nPos);
+		memcpy(pszData, pOldData->m_acData, Core::numBytes<tchar>(nPos));
 
 		// Copy new text.
-		tstrncpy(m_pszData+nPos, pszString, nTextLen);
+		memcpy(pszData+nPos, pszString, Core::numBytes<tchar>(nTextLen));
 
 		// Copy trailing chars from old text.
-		tstrncpy(m_pszData+nPos+nTextLen, pOldData->m_acData+nPos, nThisLen-nPos);
+		memcpy(pszData+nPos+nTextLen, pOldData->m_acData+nPos, Core::numBytes<tchar>(nThisLen-nPos));
 
 		// Terminate string.
-		m_pszData[nThisLen+nTextLen] = TXT('\0');
+		pszData[nThisLen+nTextLen] = TXT('\0');
 
-		// Free old string, if not empty string.
-		if (pOldData != &strNULL)
-			free(pOldData);
+		// Free old string, if on the heap.
+		Attach(pNewData);
+
+		GetData()->m_nLength = nThisLen+nTextLen;
 	}
 }
 
@@ -770,8 +1039,10 @@ void CString::Delete(size_t nFirst, size_t nCount)
 	tchar* pszDst = m_pszData + nFirst;
 	tchar* pszSrc = pszDst + nCount;
 
-	// Move string contents down.
-	tstrcpy(pszDst, pszSrc);
+	// Move string contents down, inc the null terminator.
+	memmove(pszDst, pszSrc, Core::numBytes<tchar>(nLength-nFirst-nCount+1));
+
+	GetData()->m_nLength = nLength-nCount;
 }
 
 /******************************************************************************
@@ -789,6 +1060,10 @@ void CString::Delete(size_t nFirst, size_t nCount)
 
 void CString::Replace(tchar cOldChar, tchar cNewChar)
 {
+	// Truncating the string?
+	if (cNewChar == TXT('\0'))
+		InvalidateLength();
+
 	tchar* psz = m_pszData;
 
 	while (*psz != TXT('\0'))
@@ -817,20 +1092,14 @@ void CString::Replace(tchar cChar, const tchar* pszString)
 {
 	ASSERT(pszString != nullptr);
 
-	CString      str;
-	const tchar* psz = m_pszData;
-
-	while (*psz != TXT('\0'))
-	{
-		if (*psz == cChar)
-			str += pszString;
-		else
-			str += *psz;
+	// Nothing to match?
+	if (cChar == TXT('\0'))
+		return;
 
-		++psz;
-	}
+	const tchar       szOld[] = { cChar, TXT('\0') };
+	const Replacement oEntry  = { szOld, pszString };
 
-	Copy(str);
+	Replace(&oEntry, 1, false);
 }
 
 /******************************************************************************
@@ -841,6 +1110,7 @@ void CString::Replace(tchar cChar, const tchar* pszString)
 **
 ** Parameters:	pszOldString	The string to replace.
 **				pszNewString	The string to replace it with.
+**				bIgnoreCase		Whether to ignore case when matching.
 **
 ** Returns:		Nothing.
 **
@@ -852,34 +1122,177 @@ void CString::Replace(const tchar* pszOldString, const tchar* pszNewString, bool
 	ASSERT(pszOldString != nullptr);
 	ASSERT(pszNewString != nullptr);
 
-	typedef int (*CompareFn)(const tchar*, const tchar*, size_t);
+	const Replacement oEntry = { pszOldString, pszNewString };
 
-	CString      str;
-	const tchar* psz = m_pszData;
+	Replace(&oEntry, 1, bIgnoreCase);
+}
 
-	// Presize to current string length.
-	str.BufferSize(Length()+1);
+/******************************************************************************
+** Method:		Replace()
+**
+** Description:	Replaces each of a number of strings with another string in a
+**				single pass, ignoring case if required. Where more than one
+**				entry matches at the same position the earliest in the table
+**				is used. The replacements are not rescanned.
+**
+**				The matches are found first, using the first character of
+**				each entry to skip quickly over the text in between, so that
+**				the result can be allocated once at its final size and then
+**				written in a single pass.
+**
+** Parameters:	pTable			The table of replacements.
+**				nEntries		The number of entries in the table.
+**				bIgnoreCase		Whether to ignore case when matching.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CString::Replace(const Replacement* pTable, size_t nEntries, bool bIgnoreCase)
+{
+	ASSERT((pTable != nullptr) || (nEntries == 0));
+
+	typedef int (*CompareFn)(const tchar*, const tchar*, size_t);
 
 	// Choose the compare function.
 	CompareFn lpfnCompare = (bIgnoreCase) ? tstrnicmp : tstrncmp;
-	size_t    nCmpLen     = tstrlen(pszOldString);
 
-	while (*psz != TXT('\0'))
+	std::vector<size_t> vecOldLens(nEntries);
+	std::vector<size_t> vecNewLens(nEntries);
+
+	bool  abFirstChars[256] = { false };
+	tchar cOnlyFirst = TXT('\0');
+	bool  bOnlyFirst = true;
+
+	// Measure the entries and build the table of first characters.
+	for (size_t i = 0; i < nEntries; ++i)
 	{
-		// Found a match?
-		if (lpfnCompare(psz, pszOldString, nCmpLen) == 0)
+		ASSERT(pTable[i].m_pszOld != nullptr);
+		ASSERT(pTable[i].m_pszNew != nullptr);
+		ASSERT(*pTable[i].m_pszOld != TXT('\0'));
+
+		vecOldLens[i] = tstrlen(pTable[i].m_pszOld);
+		vecNewLens[i] = tstrlen(pTable[i].m_pszNew);
+
+		// Can never match?
+		if (vecOldLens[i] == 0)
+			continue;
+
+		tchar szFirst[] = { pTable[i].m_pszOld[0], TXT('\0'), pTable[i].m_pszOld[0], TXT('\0') };
+
+		if (bIgnoreCase)
 		{
-			psz += tstrlen(pszOldString);
-			str += pszNewString;
+			tstrlwr(szFirst);
+			tstrupr(szFirst+2);
 		}
-		else
+
+		for (size_t j = 0; j < 4; j += 2)
+		{
+			const tchar cFirst = szFirst[j];
+
+			abFirstChars[static_cast<utchar>(cFirst) & 0xFF] = true;
+
+			if (cOnlyFirst == TXT('\0'))
+				cOnlyFirst = cFirst;
+			else if (cFirst != cOnlyFirst)
+				bOnlyFirst = false;
+		}
+	}
+
+	// Nothing to match?
+	if (cOnlyFirst == TXT('\0'))
+		return;
+
+	const size_t    nLength = Length();
+	const tchar*    pszEnd  = m_pszData + nLength;
+	const tchar*    psz     = m_pszData;
+	size_t          nNewLength = nLength;
+	CReplaceMatches vecMatches;
+
+	// Find the matches.
+	while (psz < pszEnd)
+	{
+		// Skip to the next possible match.
+		if (bOnlyFirst)
+		{
+			psz = tstrchr(psz, cOnlyFirst);
+
+			if (psz == nullptr)
+				break;
+		}
+		else if (!abFirstChars[static_cast<utchar>(*psz) & 0xFF])
 		{
-			str += *psz;
-			psz += 1;
+			++psz;
+			continue;
 		}
+
+		size_t nEntry = 0;
+
+		while ( (nEntry < nEntries) && ( (vecOldLens[nEntry] == 0) || (lpfnCompare(psz, pTable[nEntry].m_pszOld, vecOldLens[nEntry]) != 0) ) )
+			++nEntry;
+
+		// No match?
+		if (nEntry == nEntries)
+		{
+			++psz;
+			continue;
+		}
+
+		const ReplaceMatch oMatch = { static_cast<size_t>(psz - m_pszData), nEntry };
+
+		vecMatches.push_back(oMatch);
+
+		nNewLength = nNewLength - vecOldLens[nEntry] + vecNewLens[nEntry];
+		psz += vecOldLens[nEntry];
 	}
 
-	Copy(str);
+	// Nothing to replace?
+	if (vecMatches.empty())
+		return;
+
+	// Replacing everything with nothing?
+	if (nNewLength == 0)
+	{
+		Free();
+		return;
+	}
+
+	// Write the result into a buffer of the final size. A short result is
+	// built on the stack and copied to the small string buffer.
+	tchar       szInline[INLINE_CHARS];
+	StringData* pNewData = (nNewLength < INLINE_CHARS) ? nullptr : Alloc(nNewLength+1);
+	tchar*      pszDst   = (pNewData != nullptr) ? pNewData->m_acData : szInline;
+	size_t      nSrcPos  = 0;
+
+	for (CReplaceMatches::const_iterator itMatch = vecMatches.begin(); itMatch != vecMatches.end(); ++itMatch)
+	{
+		const size_t nGap    = itMatch->m_nPos - nSrcPos;
+		const size_t nNewLen = vecNewLens[itMatch->m_nEntry];
+
+		memcpy(pszDst, m_pszData+nSrcPos, Core::numBytes<tchar>(nGap));
+		pszDst += nGap;
+
+		memcpy(pszDst, pTable[itMatch->m_nEntry].m_pszNew, Core::numBytes<tchar>(nNewLen));
+		pszDst += nNewLen;
+
+		nSrcPos = itMatch->m_nPos + vecOldLens[itMatch->m_nEntry];
+	}
+
+	// Copy the tail and terminate.
+	memcpy(pszDst, m_pszData+nSrcPos, Core::numBytes<tchar>(nLength-nSrcPos));
+	pszDst[nLength-nSrcPos] = TXT('\0');
+
+	if (pNewData != nullptr)
+	{
+		Attach(pNewData);
+
+		GetData()->m_nLength = nNewLength;
+	}
+	else
+	{
+		Copy(szInline, nNewLength);
+	}
 }
 
 /******************************************************************************
@@ -897,9 +1310,14 @@ void CString::Replace(const tchar* pszOldString, const tchar* pszNewString, bool
 
 CString& CString::RepCtrlChars()
 {
-	Replace(TXT('\t'), TXT("\\t"));
-	Replace(TXT('\r'), TXT("\\r"));
-	Replace(TXT('\n'), TXT("\\n"));
+	static const Replacement s_aoCtrlChars[] =
+	{
+		{ TXT("\t"), TXT("\\t") },
+		{ TXT("\r"), TXT("\\r") },
+		{ TXT("\n"), TXT("\\n") },
+	};
+
+	Replace(s_aoCtrlChars, ARRAY_SIZE(s_aoCtrlChars), false);
 
 	return *this;
 }
@@ -43,9 +43,13 @@ public:
 	CString(const tchar* pszBuffer);
 	CString(const tchar* pszBuffer, size_t iChars);
 	CString(const CString& strSrc);
+#ifdef WCL_HAS_RVALUE_REFS
+	CString(CString&& strSrc) CORE_NO_THROW;
+#endif
 	~CString();
 
 	void BufferSize(size_t nChars);
+	void Reserve(size_t nChars);
 	void LoadRsc(uint iRscID);
 
 	//
@@ -68,14 +72,24 @@ public:
 	iterator begin();
 	iterator end();
 
+	// A string replacement, for use in a replacement table.
+	struct Replacement
+	{
+		const tchar*	m_pszOld;	// The string to replace.
+		const tchar*	m_pszNew;	// The string to replace it with.
+	};
+
 	//
 	// Mutation.
 	//
+	void     Append(const tchar* pszString, size_t nChars);
+	void     Append(const CString& strString);
 	void     Insert(size_t nPos, const tchar* pszString);
 	void     Delete(size_t nFirst, size_t nCount = 1);
 	void     Replace(tchar cOldChar, tchar cNewChar);
 	void     Replace(tchar cChar, const tchar* pszString);
 	void     Replace(const tchar* pszOldString, const tchar* pszNewString, bool bIgnoreCase = true);
+	void     Replace(const Replacement* pTable, size_t nEntries, bool bIgnoreCase = true);
 	CString& RepCtrlChars();
 	CString& Trim(bool bLeft = true, bool bRight = true);
 	CString& ToLower();
@@ -109,12 +123,21 @@ public:
     CORE_MSPRINTF(1, 0)
 	static CString FmtEx(const tchar* pszFormat, va_list args);
 
+#ifdef WCL_HAS_VARIADIC_TEMPLATES
+	//! Format a string by substituting the arguments for "{}" placeholders.
+	template<typename... Args>
+	static CString FmtArgs(const tchar* pszFormat, const Args&... args);
+#endif
+
 	//
 	// Core operators.
 	//
 	tchar& operator[](size_t nChar);
 
 	const CString& operator=(const CString& strSrc);
+#ifdef WCL_HAS_RVALUE_REFS
+	const CString& operator=(CString&& strSrc);
+#endif
 	const CString& operator=(const tchar* pszBuffer);
 	const CString& operator=(const tstring& string);
 
@@ -139,6 +162,7 @@ public:
 	void operator +=(const tchar* pszString);
 	void operator +=(tchar cChar);
 	void operator +=(const tstring& string);
+	void operator +=(const CString& strString);
 
 	//
 	// Persistence.
@@ -160,32 +184,81 @@ protected:
 	*******************************************************************************
 	*/
 
+	// The number of characters, inc null terminator, stored inline.
+	static const size_t INLINE_CHARS = 16;
+
+	// The length value used when the cached length is unknown.
+	static const size_t UNKNOWN_LENGTH = static_cast<size_t>(-1);
+
 #pragma pack(push, 1)
 
 	struct StringData
 	{
 		size_t	m_nAllocSize;	// Size of buffer in characters inc null terminator.
+		size_t	m_nLength;		// Cached length in characters or UNKNOWN_LENGTH.
 		tchar	m_acData[1];	// Start of string data.
 	};
 
+	// The small string buffer, which shares the StringData layout.
+	struct InlineData
+	{
+		size_t	m_nAllocSize;				// Always INLINE_CHARS.
+		size_t	m_nLength;					// Cached length in characters or UNKNOWN_LENGTH.
+		tchar	m_acData[INLINE_CHARS];		// The string data.
+	};
+
 #pragma pack(pop)
 
 	//
 	// Members.
 	//
-	tchar*	m_pszData;			// Pointer to StringData buffer.
+	tchar*		m_pszData;		// Pointer to StringData or InlineData buffer.
+	InlineData	m_oInline;		// Storage for short strings.
 
 	//
 	// Internal methods.
 	//
+	void Init();
 	StringData* GetData() const;
+	bool IsInline() const;
+	void InvalidateLength() const;
 	void Copy(const tchar* lpszBuffer);
 	void Copy(const tchar* lpszBuffer, size_t nChars);
+	void Attach(StringData* pData);
 	void Free();
+	size_t GrowSize(size_t nChars) const;
+
+	static StringData* Alloc(size_t nChars);
+
+	//
+	// Type-safe formatting.
+	//
+	const tchar* AppendFmtText(const tchar* pszFormat);
 
-	// NULL string.
-	static StringData strNULL;
-	static tchar*     pszNULL;
+#ifdef WCL_HAS_VARIADIC_TEMPLATES
+	void FmtNext(const tchar* pszFormat);
+	template<typename T, typename... Args>
+	void FmtNext(const tchar* pszFormat, const T& arg, const Args&... args);
+#endif
+
+	void AppendArg(const tchar* pszValue);
+	void AppendArg(const CString& strValue);
+	void AppendArg(const tstring& strValue);
+	void AppendArg(tchar cValue);
+	void AppendArg(bool bValue);
+	void AppendArg(int nValue);
+	void AppendArg(unsigned int nValue);
+	void AppendArg(long nValue);
+	void AppendArg(unsigned long nValue);
+	void AppendArg(long long nValue);
+	void AppendArg(unsigned long long nValue);
+	void AppendArg(double dValue);
+
+#ifdef WCL_HAS_VARIADIC_TEMPLATES
+	// Reject any other pointer, rather than print it as a bool.
+	template<typename T>
+	void AppendArg(const T* pValue) = delete;
+#endif
 };
 
 /******************************************************************************
@@ -196,34 +269,55 @@ protected:
 */
 
 inline CString::CString()
-	: m_pszData(pszNULL)
 {
+	Init();
 }
 
 inline CString::CString(uint iRscID)
-	: m_pszData(pszNULL)
 {
+	Init();
 	LoadRsc(iRscID);
 }
 
 inline CString::CString(const tchar* pszBuffer)
-	: m_pszData(pszNULL)
 {
+	Init();
 	Copy(pszBuffer, tstrlen(pszBuffer));
 }
 
 inline CString::CString(const tchar* pszBuffer, size_t iChars)
-	: m_pszData(pszNULL)
 {
+	Init();
 	Copy(pszBuffer, iChars);
 }
 
 inline CString::CString(const CString& strSrc)
-	: m_pszData(pszNULL)
 {
+	Init();
 	Copy(strSrc.m_pszData, strSrc.Length());
 }
 
+#ifdef WCL_HAS_RVALUE_REFS
+
+inline CString::CString(CString&& strSrc) CORE_NO_THROW
+{
+	Init();
+
+	// Steal the heap buffer?
+	if (!strSrc.IsInline())
+	{
+		Attach(strSrc.GetData());
+		strSrc.Init();
+	}
+	else
+	{
+		// Fits the inline buffer, so never allocates.
+		Copy(strSrc.m_pszData, strSrc.Length());
+	}
+}
+
+#endif
+
 inline CString::~CString()
 {
 	Free();
@@ -236,11 +330,20 @@ inline bool CString::Empty() const
 	return (m_pszData[0] == TXT('\0'));
 }
 
+////////////////////////////////////////////////////////////////////////////////
+//! Get the length of the string in chars. The length is cached and only
+//! recalculated after the buffer has been handed out for writing.
+
 inline size_t CString::Length() const
 {
 	ASSERT(m_pszData);
 
-	return tstrlen(m_pszData);
+	StringData* pData = GetData();
+
+	if (pData->m_nLength == UNKNOWN_LENGTH)
+		pData->m_nLength = tstrlen(m_pszData);
+
+	return pData->m_nLength;
 }
 
 inline CString& CString::ToLower()
@@ -263,6 +366,29 @@ inline const CString& CString::operator=(const CString& strSrc)
 	return *this;
 }
 
+#ifdef WCL_HAS_RVALUE_REFS
+
+inline const CString& CString::operator=(CString&& strSrc)
+{
+	if (this != &strSrc)
+	{
+		// Steal the heap buffer?
+		if (!strSrc.IsInline())
+		{
+			Attach(strSrc.GetData());
+			strSrc.Init();
+		}
+		else
+		{
+			Copy(strSrc.m_pszData, strSrc.Length());
+		}
+	}
+
+	return *this;
+}
+
+#endif
+
 inline const CString& CString::operator=(const tchar* pszBuffer)
 {
 	ASSERT(pszBuffer);
@@ -284,10 +410,16 @@ inline const tchar* CString::c_str() const
 	return m_pszData;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+//! Get the buffer for writing to directly. As the caller may change the
+//! contents the cached length is discarded.
+
 inline tchar* CString::Buffer() const
 {
 	ASSERT(m_pszData);
 
+	InvalidateLength();
+
 	return m_pszData;
 }
 
@@ -311,13 +443,15 @@ inline CString::const_iterator CString::end() const
 {
 	ASSERT(m_pszData != nullptr);
 
-	return (m_pszData + tstrlen(m_pszData));
+	return (m_pszData + Length());
 }
 
 inline CString::iterator CString::begin()
 {
 	ASSERT(m_pszData != nullptr);
 
+	InvalidateLength();
+
 	return m_pszData;
 }
 
@@ -325,7 +459,11 @@ inline CString::iterator CString::end()
 {
 	ASSERT(m_pszData != nullptr);
 
-	return (m_pszData + tstrlen(m_pszData));
+	iterator itEnd = m_pszData + Length();
+
+	InvalidateLength();
+
+	return itEnd;
 }
 
 inline CString::operator const tchar*() const
@@ -339,6 +477,8 @@ inline tchar& CString::operator[](size_t nChar)
 {
 	ASSERT(nChar < Capacity());
 
+	InvalidateLength();
+
 	return m_pszData[nChar];
 }
 
@@ -349,7 +489,10 @@ inline bool CString::operator ==(const tchar* pszString) const
 
 inline bool CString::operator ==(const CString& strString) const
 {
-	return (tstrcmp(m_pszData, strString) == 0);
+	if (Length() != strString.Length())
+		return false;
+
+	return (tstrcmp(m_pszData, strString.m_pszData) == 0);
 }
 
 inline bool CString::operator !=(const tchar* pszString) const
@@ -359,7 +502,7 @@ inline bool CString::operator !=(const tchar* pszString) const
 
 inline bool CString::operator !=(const CString& strString) const
 {
-	return (tstrcmp(m_pszData, strString) != 0);
+	return !operator==(strString);
 }
 
 inline bool CString::operator <(const tchar* pszString) const
@@ -384,7 +527,120 @@ inline int CString::Compare(const tchar* pszString, size_t nChars, bool bIgnoreC
 
 inline void CString::operator +=(const tstring& string)
 {
-	operator +=(string.c_str());
+	Append(string.data(), string.length());
+}
+
+inline void CString::operator +=(const CString& strString)
+{
+	Append(strString);
+}
+
+inline void CString::Append(const CString& strString)
+{
+	Append(strString.m_pszData, strString.Length());
+}
+
+#ifdef WCL_HAS_VARIADIC_TEMPLATES
+
+////////////////////////////////////////////////////////////////////////////////
+//! Format a string by substituting the arguments, in order, for the "{}"
+//! placeholders in the format string. Use "{{" for a literal brace. Unlike
+//! Fmt() the argument types are checked at compile time, and strings and
+//! integers are appended directly without any printf-style parsing.
+
+template<typename... Args>
+inline CString CString::FmtArgs(const tchar* pszFormat, const Args&... args)
+{
+	ASSERT(pszFormat != nullptr);
+
+	CString str;
+
+	str.FmtNext(pszFormat, args...);
+
+	return str;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Append the remainder of the format string once the arguments have all been
+//! substituted.
+
+inline void CString::FmtNext(const tchar* pszFormat)
+{
+	const tchar* pszNext = AppendFmtText(pszFormat);
+
+	ASSERT(pszNext == nullptr);	// More placeholders than arguments.
+
+	// Leave any unused placeholders as they are.
+	while (pszNext != nullptr)
+	{
+		operator+=(TXT("{}"));
+		pszNext = AppendFmtText(pszNext);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Append the format string up to the next placeholder and then the next
+//! argument.
+
+template<typename T, typename... Args>
+inline void CString::FmtNext(const tchar* pszFormat, const T& arg, const Args&... args)
+{
+	const tchar* pszNext = AppendFmtText(pszFormat);
+
+	ASSERT(pszNext != nullptr);	// More arguments than placeholders.
+
+	if (pszNext == nullptr)
+		return;
+
+	AppendArg(arg);
+	FmtNext(pszNext, args...);
+}
+
+#endif
+
+inline void CString::AppendArg(const tchar* pszValue)
+{
+	operator+=(pszValue);
+}
+
+inline void CString::AppendArg(const CString& strValue)
+{
+	Append(strValue);
+}
+
+inline void CString::AppendArg(const tstring& strValue)
+{
+	Append(strValue.data(), strValue.length());
+}
+
+inline void CString::AppendArg(tchar cValue)
+{
+	operator+=(cValue);
+}
+
+inline void CString::AppendArg(bool bValue)
+{
+	operator+=(bValue ? TXT("true") : TXT("false"));
+}
+
+inline void CString::AppendArg(int nValue)
+{
+	AppendArg(static_cast<long long>(nValue));
+}
+
+inline void CString::AppendArg(unsigned int nValue)
+{
+	AppendArg(static_cast<unsigned long long>(nValue));
+}
+
+inline void CString::AppendArg(long nValue)
+{
+	AppendArg(static_cast<long long>(nValue));
+}
+
+inline void CString::AppendArg(unsigned long nValue)
+{
+	AppendArg(static_cast<unsigned long long>(nValue));
 }
 
 inline void CString::Copy(const tchar* lpszBuffer)
@@ -392,11 +648,30 @@ inline void CString::Copy(const tchar* lpszBuffer)
 	Copy(lpszBuffer, tstrlen(lpszBuffer));
 }
 
+inline void CString::Init()
+{
+	m_oInline.m_nAllocSize = INLINE_CHARS;
+	m_oInline.m_nLength    = 0;
+	m_oInline.m_acData[0]  = TXT('\0');
+
+	m_pszData = m_oInline.m_acData;
+}
+
 inline CString::StringData* CString::GetData() const
 {
 	byte* pData = reinterpret_cast<byte*>(m_pszData);
 
-	return reinterpret_cast<StringData*>(pData - (sizeof(size_t)));
+	return reinterpret_cast<StringData*>(pData - offsetof(StringData, m_acData));
+}
+
+inline bool CString::IsInline() const
+{
+	return (m_pszData == m_oInline.m_acData);
+}
+
+inline void CString::InvalidateLength() const
+{
+	GetData()->m_nLength = UNKNOWN_LENGTH;
 }
 
 /******************************************************************************
@@ -46,6 +46,39 @@ public:
 	bool			m_updateInvoked;
 };
 
+class TestRangeCmdController : public CCmdControl
+{
+public:
+	static const uint FIRST_RANGE_ID = 100;
+	static const uint LAST_RANGE_ID = 109;
+	static const uint OVERLAPPING_ID = 105;
+
+	TestRangeCmdController()
+		: CCmdControl(m_commandWnd)
+		, m_rangeCommandId(0)
+		, m_singleInvoked(false)
+	{
+		DEFINE_CMD_TABLE
+			CMD_RANGE(FIRST_RANGE_ID, LAST_RANGE_ID, &TestRangeCmdController::onRangeCommand, nullptr, 1)
+			CMD_ENTRY(OVERLAPPING_ID, &TestRangeCmdController::onSingleCommand, nullptr, 2)
+		END_CMD_TABLE
+	}
+
+	void onRangeCommand(uint id)
+	{
+		m_rangeCommandId = id;
+	}
+
+	void onSingleCommand()
+	{
+		m_singleInvoked = true;
+	}
+
+	TestCommandWnd	m_commandWnd;
+	uint			m_rangeCommandId;
+	bool			m_singleInvoked;
+};
+
 TEST_SET(CmdControl)
 {
 
@@ -71,6 +104,40 @@ TEST_CASE("Executing unmapped command should not generate an error")
 }
 TEST_CASE_END
 
+TEST_CASE("Executing a command in a range should invoke the range callback with the command")
+{
+	TestRangeCmdController controller;
+
+	controller.Execute(TestRangeCmdController::FIRST_RANGE_ID);
+	TEST_TRUE(controller.m_rangeCommandId == TestRangeCmdController::FIRST_RANGE_ID);
+
+	controller.Execute(TestRangeCmdController::LAST_RANGE_ID);
+	TEST_TRUE(controller.m_rangeCommandId == TestRangeCmdController::LAST_RANGE_ID);
+}
+TEST_CASE_END
+
+TEST_CASE("Executing a command outside a range should not invoke the range callback")
+{
+	TestRangeCmdController controller;
+
+	controller.Execute(TestRangeCmdController::FIRST_RANGE_ID-1);
+	controller.Execute(TestRangeCmdController::LAST_RANGE_ID+1);
+
+	TEST_TRUE(controller.m_rangeCommandId == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("When table entries overlap the first entry in the table handles the command")
+{
+	TestRangeCmdController controller;
+
+	controller.Execute(TestRangeCmdController::OVERLAPPING_ID);
+
+	TEST_TRUE(controller.m_rangeCommandId == TestRangeCmdController::OVERLAPPING_ID);
+	TEST_FALSE(controller.m_singleInvoked);
+}
+TEST_CASE_END
+
 TEST_CASE("Updating the UI should invoke update UI callback function")
 {
 	TestCmdController controller;
@@ -0,0 +1,123 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ColumnarDataSourceTests.cpp
+//! \brief  The unit tests for the ColumnarDataSource class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <WCL/ColumnarDataSource.hpp>
+
+namespace
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Append a row with two columns.
+
+void appendRow(WCL::ColumnarDataSource& source, const tchar* first, const tchar* second, size_t image = Core::npos)
+{
+	const tchar* values[] = { first, second };
+
+	source.appendRow(values, image);
+}
+
+}
+
+TEST_SET(ColumnarDataSource)
+{
+
+TEST_CASE("a new data source has no rows")
+{
+	WCL::ColumnarDataSource source(2);
+
+	TEST_TRUE(source.columnCount() == 2);
+	TEST_TRUE(source.rowCount() == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("the cells of an appended row can be retrieved by row and column")
+{
+	WCL::ColumnarDataSource source(2);
+
+	appendRow(source, TXT("apple"), TXT("1"));
+	appendRow(source, TXT("banana"), nullptr);
+
+	TEST_TRUE(source.rowCount() == 2);
+	TEST_TRUE(tstrcmp(source.cellText(0, 0), TXT("apple")) == 0);
+	TEST_TRUE(tstrcmp(source.cellText(0, 1), TXT("1")) == 0);
+	TEST_TRUE(tstrcmp(source.cellText(1, 0), TXT("banana")) == 0);
+	TEST_TRUE(tstrcmp(source.cellText(1, 1), TXT("")) == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("rows without an image return npos for the image")
+{
+	WCL::ColumnarDataSource source(2);
+
+	appendRow(source, TXT("apple"), TXT("1"));
+	appendRow(source, TXT("banana"), TXT("2"), 3);
+	appendRow(source, TXT("cherry"), TXT("3"));
+
+	TEST_TRUE(source.rowImage(0) == Core::npos);
+	TEST_TRUE(source.rowImage(1) == 3);
+	TEST_TRUE(source.rowImage(2) == Core::npos);
+}
+TEST_CASE_END
+
+TEST_CASE("sorting a column reorders the rows without changing their values")
+{
+	WCL::ColumnarDataSource source(2);
+
+	appendRow(source, TXT("cherry"), TXT("1"), 1);
+	appendRow(source, TXT("Apple"), TXT("2"), 2);
+	appendRow(source, TXT("banana"), TXT("3"), 3);
+
+	source.sort(0);
+
+	TEST_TRUE(tstrcmp(source.cellText(0, 0), TXT("Apple")) == 0);
+	TEST_TRUE(tstrcmp(source.cellText(0, 1), TXT("2")) == 0);
+	TEST_TRUE(source.rowImage(0) == 2);
+	TEST_TRUE(tstrcmp(source.cellText(2, 0), TXT("cherry")) == 0);
+
+	source.sort(1, false);
+
+	TEST_TRUE(tstrcmp(source.cellText(0, 0), TXT("banana")) == 0);
+	TEST_TRUE(tstrcmp(source.cellText(2, 0), TXT("cherry")) == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("finding a row matches the first column ignoring case")
+{
+	WCL::ColumnarDataSource source(2);
+
+	appendRow(source, TXT("apple"), TXT("1"));
+	appendRow(source, TXT("banana"), TXT("2"));
+	appendRow(source, TXT("blueberry"), TXT("3"));
+
+	TEST_TRUE(source.findRow(TXT("BANANA"), false, 0, false) == 1);
+	TEST_TRUE(source.findRow(TXT("b"), false, 0, false) == Core::npos);
+	TEST_TRUE(source.findRow(TXT("b"), true, 0, false) == 1);
+	TEST_TRUE(source.findRow(TXT("b"), true, 2, false) == 2);
+	TEST_TRUE(source.findRow(TXT("apple"), false, 1, false) == Core::npos);
+	TEST_TRUE(source.findRow(TXT("apple"), false, 1, true) == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("clearing the data source removes all rows")
+{
+	WCL::ColumnarDataSource source(2);
+
+	source.reserve(10, 8);
+	appendRow(source, TXT("apple"), TXT("1"), 1);
+	source.clear();
+
+	TEST_TRUE(source.rowCount() == 0);
+
+	appendRow(source, TXT("banana"), TXT("2"));
+
+	TEST_TRUE(tstrcmp(source.cellText(0, 0), TXT("banana")) == 0);
+	TEST_TRUE(source.rowImage(0) == Core::npos);
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
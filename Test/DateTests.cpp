@@ -29,5 +29,102 @@ TEST_CASE("using Windows long format day, month name and year separated by a spa
 }
 TEST_CASE_END
 
+TEST_CASE("the start of the epoch is stored as zero seconds")
+{
+	TEST_TRUE(CDate(1, 1, 1970).GetDateInSecs() == 0);
+	TEST_TRUE(CDate(2, 1, 1970).GetDateInSecs() == WCL::SECS_PER_DAY);
+	TEST_TRUE(CDate(31, 12, 1969).GetDateInSecs() == -WCL::SECS_PER_DAY);
+}
+TEST_CASE_END
+
+TEST_CASE("the day, month and year fields are extracted from the date")
+{
+	CDate date(29, 2, 2000);
+
+	TEST_TRUE(date.Day() == 29);
+	TEST_TRUE(date.Month() == 2);
+	TEST_TRUE(date.Year() == 2000);
+	TEST_TRUE(date.DaysInMonth() == 29);
+
+	CDate earlyDate(14, 12, 1901);
+
+	TEST_TRUE(earlyDate.Day() == 14);
+	TEST_TRUE(earlyDate.Month() == 12);
+	TEST_TRUE(earlyDate.Year() == 1901);
+}
+TEST_CASE_END
+
+TEST_CASE("setting a single field leaves the other fields unchanged")
+{
+	CDate date(1, 2, 2003);
+
+	date.Day(28);
+	date.Month(11);
+	date.Year(1999);
+
+	TEST_TRUE(date == CDate(28, 11, 1999));
+}
+TEST_CASE_END
+
+TEST_CASE("every date in the supported range survives a round trip through seconds")
+{
+	// A 32-bit time_t can only represent dates from late 1901 to early 2038.
+	const bool narrowTime = (sizeof(WCL::Seconds) < 8);
+	const int  firstYear = narrowTime ? CDate::MIN_YEAR+1 : CDate::MIN_YEAR;
+	const int  lastYear  = narrowTime ? 2037 : CDate::MAX_YEAR;
+
+	bool allMatch = true;
+	bool allConsecutive = true;
+	WCL::Seconds previous = CDate(1, 1, firstYear).GetDateInSecs() - WCL::SECS_PER_DAY;
+
+	for (int year = firstYear; year <= lastYear; ++year)
+	{
+		for (int month = CDate::MIN_MONTH; month <= CDate::MAX_MONTH; ++month)
+		{
+			const int numDays = CDate(1, month, year).DaysInMonth();
+
+			for (int day = CDate::MIN_DAY; day <= numDays; ++day)
+			{
+				const CDate date(day, month, year);
+				const CDate copy(date.GetDateInSecs());
+
+				int actualDay, actualMonth, actualYear;
+
+				copy.Get(actualDay, actualMonth, actualYear);
+
+				allMatch = allMatch && (actualDay == day) && (actualMonth == month) && (actualYear == year);
+				allConsecutive = allConsecutive && (date.GetDateInSecs() == previous + WCL::SECS_PER_DAY);
+
+				previous = date.GetDateInSecs();
+			}
+		}
+	}
+
+	TEST_TRUE(allMatch);
+	TEST_TRUE(allConsecutive);
+}
+TEST_CASE_END
+
+TEST_CASE("an array of seconds can be decomposed into date fields in one call")
+{
+	const WCL::Seconds dates[] =
+	{
+		CDate(1, 2, 2003).GetDateInSecs(),
+		CDate(29, 2, 2000).GetDateInSecs() + WCL::SECS_PER_HOUR,
+		CDate(31, 12, 1969).GetDateInSecs(),
+		CDate(1, 1, 1970).GetDateInSecs() + WCL::SECS_PER_DAY - 1,
+	};
+
+	CDate::Fields fields[ARRAY_SIZE(dates)];
+
+	CDate::Decompose(dates, ARRAY_SIZE(dates), fields);
+
+	TEST_TRUE(fields[0].m_iDay == 1  && fields[0].m_iMonth == 2  && fields[0].m_iYear == 2003);
+	TEST_TRUE(fields[1].m_iDay == 29 && fields[1].m_iMonth == 2  && fields[1].m_iYear == 2000);
+	TEST_TRUE(fields[2].m_iDay == 31 && fields[2].m_iMonth == 12 && fields[2].m_iYear == 1969);
+	TEST_TRUE(fields[3].m_iDay == 1  && fields[3].m_iMonth == 1  && fields[3].m_iYear == 1970);
+}
+TEST_CASE_END
+
 }
 TEST_SET_END
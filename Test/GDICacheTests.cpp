@@ -0,0 +1,172 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   GDICacheTests.cpp
+//! \brief  The unit tests for the GDICache class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <WCL/GDICache.hpp>
+
+TEST_SET(GDICache)
+{
+
+TEST_CASE("a new cache is empty")
+{
+	WCL::GDICache cache;
+
+	TEST_TRUE(cache.capacity() == WCL::GDICache::DEFAULT_CAPACITY);
+	TEST_TRUE(cache.size() == 0);
+	TEST_TRUE(cache.hits() == 0);
+	TEST_TRUE(cache.misses() == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("acquiring the same definition twice returns the same handle")
+{
+	WCL::GDICache cache;
+
+	HBRUSH first = cache.acquireBrush(RGB(255, 0, 0));
+	HBRUSH second = cache.acquireBrush(RGB(255, 0, 0));
+
+	TEST_TRUE(first != NULL);
+	TEST_TRUE(second == first);
+	TEST_TRUE(cache.size() == 1);
+	TEST_TRUE(cache.misses() == 1);
+	TEST_TRUE(cache.hits() == 1);
+
+	cache.release(first);
+	cache.release(second);
+}
+TEST_CASE_END
+
+TEST_CASE("different definitions return different handles")
+{
+	WCL::GDICache cache;
+
+	HBRUSH brush = cache.acquireBrush(RGB(255, 0, 0));
+	HPEN   solid = cache.acquirePen(PS_SOLID, 1, RGB(255, 0, 0));
+	HPEN   dash  = cache.acquirePen(PS_DASH, 1, RGB(255, 0, 0));
+
+	TEST_TRUE(static_cast<HGDIOBJ>(brush) != static_cast<HGDIOBJ>(solid));
+	TEST_TRUE(solid != dash);
+	TEST_TRUE(cache.size() == 3);
+	TEST_TRUE(cache.misses() == 3);
+
+	cache.release(brush);
+	cache.release(solid);
+	cache.release(dash);
+}
+TEST_CASE_END
+
+TEST_CASE("fonts are matched on their definition")
+{
+	WCL::GDICache cache;
+
+	LOGFONT first = { 0 };
+	LOGFONT second = { 0 };
+
+	first.lfHeight = second.lfHeight = 12;
+	tstrcpy(first.lfFaceName, TXT("Arial"));
+	tstrcpy(second.lfFaceName, TXT("Arial"));
+
+	HFONT font = cache.acquireFont(first);
+
+	TEST_TRUE(cache.acquireFont(second) == font);
+
+	second.lfWeight = FW_BOLD;
+
+	HFONT bold = cache.acquireFont(second);
+
+	TEST_TRUE(bold != font);
+	TEST_TRUE(cache.hits() == 1);
+	TEST_TRUE(cache.misses() == 2);
+
+	cache.release(font);
+	cache.release(font);
+	cache.release(bold);
+}
+TEST_CASE_END
+
+TEST_CASE("released objects are kept for reuse")
+{
+	WCL::GDICache cache;
+
+	HBRUSH brush = cache.acquireBrush(RGB(0, 255, 0));
+
+	cache.release(brush);
+
+	TEST_TRUE(cache.size() == 1);
+	TEST_TRUE(cache.acquireBrush(RGB(0, 255, 0)) == brush);
+	TEST_TRUE(cache.hits() == 1);
+
+	cache.release(brush);
+}
+TEST_CASE_END
+
+TEST_CASE("the least recently released object is destroyed when the cache is full")
+{
+	WCL::GDICache cache(2);
+
+	HBRUSH red = cache.acquireBrush(RGB(255, 0, 0));
+	HBRUSH green = cache.acquireBrush(RGB(0, 255, 0));
+
+	cache.release(red);
+	cache.release(green);
+
+	HBRUSH blue = cache.acquireBrush(RGB(0, 0, 255));
+
+	TEST_TRUE(cache.size() == 2);
+
+	cache.resetStats();
+	cache.release(cache.acquireBrush(RGB(0, 255, 0)));
+
+	TEST_TRUE(cache.hits() == 1);
+
+	cache.release(cache.acquireBrush(RGB(255, 0, 0)));
+
+	TEST_TRUE(cache.misses() == 1);
+
+	cache.release(blue);
+}
+TEST_CASE_END
+
+TEST_CASE("referenced objects are never destroyed to make room")
+{
+	WCL::GDICache cache(1);
+
+	HBRUSH red = cache.acquireBrush(RGB(255, 0, 0));
+	HBRUSH green = cache.acquireBrush(RGB(0, 255, 0));
+
+	TEST_TRUE(cache.size() == 2);
+
+	cache.release(red);
+
+	TEST_TRUE(cache.size() == 1);
+
+	cache.release(green);
+
+	TEST_TRUE(cache.size() == 1);
+}
+TEST_CASE_END
+
+TEST_CASE("purging the cache destroys only the unreferenced objects")
+{
+	WCL::GDICache cache;
+
+	HBRUSH red = cache.acquireBrush(RGB(255, 0, 0));
+	HBRUSH green = cache.acquireBrush(RGB(0, 255, 0));
+
+	cache.release(red);
+	cache.purge();
+
+	TEST_TRUE(cache.size() == 1);
+
+	cache.release(green);
+	cache.purge();
+
+	TEST_TRUE(cache.size() == 0);
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
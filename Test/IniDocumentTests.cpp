@@ -0,0 +1,241 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   IniDocumentTests.cpp
+//! \brief  The unit tests for the IniDocument class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <WCL/IniDocument.hpp>
+
+TEST_SET(IniDocument)
+{
+	const tstring text = TXT("; Comment\r\n")
+						 TXT("[Section]\r\n")
+						 TXT("; Entry comment\r\n")
+						 TXT("Key = \"Value\" \r\n")
+						 TXT("Number=42\r\n")
+						 TXT("\r\n")
+						 TXT("[Other]\r\n")
+						 TXT("Name=Text\r\n");
+
+TEST_CASE("a default constructed document is empty and unmodified")
+{
+	WCL::IniDocument document;
+
+	WCL::IniDocument::Strings names;
+
+	TEST_TRUE(document.readSectionNames(names) == 0);
+	TEST_TRUE(document.format().empty());
+	TEST_FALSE(document.isModified());
+}
+TEST_CASE_END
+
+TEST_CASE("formatting an unmodified document returns the original text")
+{
+	WCL::IniDocument document;
+
+	document.parse(text);
+
+	TEST_TRUE(document.format() == text);
+	TEST_FALSE(document.isModified());
+}
+TEST_CASE_END
+
+TEST_CASE("lines terminated by a lone line feed are parsed")
+{
+	WCL::IniDocument document;
+
+	document.parse(TXT("[Section]\nKey=Value\n"));
+
+	tstring value;
+
+	TEST_TRUE(document.readString(TXT("Section"), TXT("Key"), value));
+	TEST_TRUE(value == TXT("Value"));
+}
+TEST_CASE_END
+
+TEST_CASE("reading a value trims the whitespace and surrounding quotes")
+{
+	WCL::IniDocument document;
+
+	document.parse(text);
+
+	tstring value;
+
+	TEST_TRUE(document.readString(TXT("Section"), TXT("Key"), value));
+	TEST_TRUE(value == TXT("Value"));
+}
+TEST_CASE_END
+
+TEST_CASE("section and key names are matched ignoring case")
+{
+	WCL::IniDocument document;
+
+	document.parse(text);
+
+	tstring value;
+
+	TEST_TRUE(document.readString(TXT("SECTION"), TXT("number"), value));
+	TEST_TRUE(value == TXT("42"));
+}
+TEST_CASE_END
+
+TEST_CASE("reading a missing section or key fails")
+{
+	WCL::IniDocument document;
+
+	document.parse(text);
+
+	tstring value;
+
+	TEST_FALSE(document.readString(TXT("Missing"), TXT("Key"), value));
+	TEST_FALSE(document.readString(TXT("Section"), TXT("Missing"), value));
+}
+TEST_CASE_END
+
+TEST_CASE("comment lines are not read as entries")
+{
+	WCL::IniDocument document;
+
+	document.parse(TXT("[Section]\r\n;Key=Value\r\n"));
+
+	tstring value;
+
+	TEST_FALSE(document.readString(TXT("Section"), TXT(";Key"), value));
+}
+TEST_CASE_END
+
+TEST_CASE("writing an existing key only replaces its line")
+{
+	WCL::IniDocument document;
+
+	document.parse(text);
+	document.writeString(TXT("Section"), TXT("number"), TXT("99"));
+
+	tstring expected = TXT("; Comment\r\n")
+					   TXT("[Section]\r\n")
+					   TXT("; Entry comment\r\n")
+					   TXT("Key = \"Value\" \r\n")
+					   TXT("Number=99\r\n")
+					   TXT("\r\n")
+					   TXT("[Other]\r\n")
+					   TXT("Name=Text\r\n");
+
+	TEST_TRUE(document.format() == expected);
+	TEST_TRUE(document.isModified());
+}
+TEST_CASE_END
+
+TEST_CASE("writing the same value does not modify the document")
+{
+	WCL::IniDocument document;
+
+	document.parse(text);
+	document.writeString(TXT("Section"), TXT("Number"), TXT("42"));
+
+	TEST_FALSE(document.isModified());
+}
+TEST_CASE_END
+
+TEST_CASE("writing a new key adds it after the last entry of the section")
+{
+	WCL::IniDocument document;
+
+	document.parse(text);
+	document.writeString(TXT("Section"), TXT("New"), TXT("Entry"));
+
+	tstring expected = TXT("; Comment\r\n")
+					   TXT("[Section]\r\n")
+					   TXT("; Entry comment\r\n")
+					   TXT("Key = \"Value\" \r\n")
+					   TXT("Number=42\r\n")
+					   TXT("New=Entry\r\n")
+					   TXT("\r\n")
+					   TXT("[Other]\r\n")
+					   TXT("Name=Text\r\n");
+
+	TEST_TRUE(document.format() == expected);
+
+	tstring value;
+
+	TEST_TRUE(document.readString(TXT("Section"), TXT("New"), value));
+	TEST_TRUE(value == TXT("Entry"));
+}
+TEST_CASE_END
+
+TEST_CASE("writing a key to a new section appends the section")
+{
+	WCL::IniDocument document;
+
+	document.parse(text);
+	document.writeString(TXT("New"), TXT("Key"), TXT("Value"));
+
+	TEST_TRUE(document.format() == text + TXT("[New]\r\nKey=Value\r\n"));
+}
+TEST_CASE_END
+
+TEST_CASE("deleting a key removes only its line")
+{
+	WCL::IniDocument document;
+
+	document.parse(text);
+	document.deleteEntry(TXT("Section"), TXT("Key"));
+
+	tstring value;
+
+	TEST_FALSE(document.readString(TXT("Section"), TXT("Key"), value));
+	TEST_TRUE(document.readString(TXT("Section"), TXT("Number"), value));
+	TEST_TRUE(document.format().find(TXT("; Entry comment\r\nNumber=42\r\n")) != tstring::npos);
+}
+TEST_CASE_END
+
+TEST_CASE("deleting a section removes the section and its entries")
+{
+	WCL::IniDocument document;
+
+	document.parse(text);
+	document.deleteSection(TXT("Section"));
+
+	tstring value;
+
+	TEST_FALSE(document.readString(TXT("Section"), TXT("Number"), value));
+	TEST_TRUE(document.readString(TXT("Other"), TXT("Name"), value));
+	TEST_TRUE(document.format() == TXT("; Comment\r\n[Other]\r\nName=Text\r\n"));
+}
+TEST_CASE_END
+
+TEST_CASE("section names and entries are read in document order")
+{
+	WCL::IniDocument document;
+
+	document.parse(text);
+
+	WCL::IniDocument::Strings names;
+
+	TEST_TRUE(document.readSectionNames(names) == 2);
+	TEST_TRUE(names[0] == TXT("Section"));
+	TEST_TRUE(names[1] == TXT("Other"));
+
+	WCL::IniDocument::Strings keys, values;
+
+	TEST_TRUE(document.readSection(TXT("Section"), keys, values) == 2);
+	TEST_TRUE(keys[0] == TXT("Key") && values[0] == TXT("Value"));
+	TEST_TRUE(keys[1] == TXT("Number") && values[1] == TXT("42"));
+}
+TEST_CASE_END
+
+TEST_CASE("the first of any duplicate sections or keys is used")
+{
+	WCL::IniDocument document;
+
+	document.parse(TXT("[Section]\r\nKey=First\r\nKey=Second\r\n[Section]\r\nKey=Third\r\n"));
+
+	tstring value;
+
+	TEST_TRUE(document.readString(TXT("Section"), TXT("Key"), value));
+	TEST_TRUE(value == TXT("First"));
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
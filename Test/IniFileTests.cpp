@@ -6,6 +6,7 @@
 #include "Common.hpp"
 #include <Core/UnitTest.hpp>
 #include <WCL/IniFile.hpp>
+#include <WCL/File.hpp>
 
 TEST_SET(IniFile)
 {
@@ -23,5 +24,38 @@ TEST_CASE("default construction refers to a file with the name of the process an
 }
 TEST_CASE_END
 
+TEST_CASE("changes made after loading the file are only written when flushed")
+{
+	const CPath path = CPath::TempDir() / TXT("WCL-IniFileTests.ini");
+
+	CFile::WriteTextFile(path, TXT("; Comment\r\n[Section]\r\nKey=Value\r\n"), ANSI_TEXT);
+
+	CIniFile oIniFile(path);
+
+	oIniFile.Load();
+
+	TEST_TRUE(oIniFile.IsLoaded());
+	TEST_TRUE(oIniFile.ReadString(TXT("Section"), TXT("Key"), TXT("")) == TXT("Value"));
+
+	oIniFile.WriteInt(TXT("Section"), TXT("Number"), 42);
+
+	TEST_TRUE(oIniFile.IsModified());
+	TEST_TRUE(oIniFile.ReadInt(TXT("Section"), TXT("Number"), 0) == 42);
+	TEST_TRUE(CFile::ReadTextFile(path) == TXT("; Comment\r\n[Section]\r\nKey=Value\r\n"));
+
+	oIniFile.Flush();
+
+	TEST_FALSE(oIniFile.IsModified());
+	TEST_TRUE(CFile::ReadTextFile(path) == TXT("; Comment\r\n[Section]\r\nKey=Value\r\nNumber=42\r\n"));
+
+	oIniFile.Unload();
+
+	TEST_FALSE(oIniFile.IsLoaded());
+	TEST_TRUE(oIniFile.ReadInt(TXT("Section"), TXT("Number"), 0) == 42);
+
+	CFile::Delete(path);
+}
+TEST_CASE_END
+
 }
 TEST_SET_END
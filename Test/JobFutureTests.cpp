@@ -0,0 +1,224 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   JobFutureTests.cpp
+//! \brief  The unit tests for the JobFuture class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <WCL/JobFuture.hpp>
+#include <WCL/ThreadPool.hpp>
+#include <WCL/Event.hpp>
+
+namespace
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A job that records the order in which it was run.
+
+class OrderedJob : public CThreadJob
+{
+public:
+	OrderedJob(volatile LONG& nCounter)
+		: m_nCounter(nCounter)
+		, m_nOrder(0)
+	{
+	}
+
+	virtual void Run()
+	{
+		m_nOrder = ::InterlockedIncrement(&m_nCounter);
+	}
+
+	LONG Order() const
+	{
+		return m_nOrder;
+	}
+
+private:
+	volatile LONG&	m_nCounter;
+	LONG			m_nOrder;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! A job that blocks until it is released.
+
+class BlockingJob : public CThreadJob
+{
+public:
+	BlockingJob(CEvent& oStarted, CEvent& oRelease)
+		: m_oStarted(oStarted)
+		, m_oRelease(oRelease)
+	{
+	}
+
+	virtual void Run()
+	{
+		m_oStarted.Signal();
+		m_oRelease.Wait();
+	}
+
+private:
+	CEvent&	m_oStarted;
+	CEvent&	m_oRelease;
+};
+
+}
+
+TEST_SET(JobFuture)
+{
+	const DWORD TIMEOUT = 10000;
+
+TEST_CASE("waiting on a future returns once the job has completed")
+{
+	volatile LONG nCounter = 0;
+
+	CThreadPool oPool(1);
+
+	oPool.Start();
+
+	ThreadJobPtr   pJob(new OrderedJob(nCounter));
+	WCL::JobFuture oFuture = oPool.AddJob(pJob);
+
+	TEST_TRUE(oFuture.wait(TIMEOUT));
+	TEST_TRUE(oFuture.isFinished());
+	TEST_TRUE(oFuture.isCompleted());
+	TEST_TRUE(nCounter == 1);
+
+	oPool.Stop();
+	oPool.ClearCompletedJobs();
+}
+TEST_CASE_END
+
+TEST_CASE("waiting on a future times out whilst the job is still running")
+{
+	CEvent oStarted(CEvent::MANUAL, CEvent::NOT_SIGNALLED);
+	CEvent oRelease(CEvent::MANUAL, CEvent::NOT_SIGNALLED);
+
+	CThreadPool oPool(1);
+
+	oPool.Start();
+
+	ThreadJobPtr   pJob(new BlockingJob(oStarted, oRelease));
+	WCL::JobFuture oFuture = oPool.AddJob(pJob);
+
+	oStarted.Wait();
+
+	TEST_FALSE(oFuture.wait(0));
+	TEST_FALSE(oFuture.isFinished());
+
+	oRelease.Signal();
+
+	TEST_TRUE(oFuture.wait(TIMEOUT));
+
+	oPool.Stop();
+	oPool.ClearCompletedJobs();
+}
+TEST_CASE_END
+
+TEST_CASE("cancelling a pending job finishes it without running it")
+{
+	volatile LONG nCounter = 0;
+
+	CEvent oStarted(CEvent::MANUAL, CEvent::NOT_SIGNALLED);
+	CEvent oRelease(CEvent::MANUAL, CEvent::NOT_SIGNALLED);
+
+	CThreadPool oPool(1);
+
+	oPool.Start();
+
+	ThreadJobPtr pBlockingJob(new BlockingJob(oStarted, oRelease));
+	ThreadJobPtr pJob(new OrderedJob(nCounter));
+
+	WCL::JobFuture oBlocking = oPool.AddJob(pBlockingJob);
+
+	oStarted.Wait();
+
+	WCL::JobFuture oFuture = oPool.AddJob(pJob);
+
+	TEST_TRUE(oFuture.cancel());
+	TEST_TRUE(oFuture.isCancelled());
+	TEST_TRUE(oFuture.wait(0));
+
+	oRelease.Signal();
+
+	TEST_TRUE(oBlocking.wait(TIMEOUT));
+	TEST_TRUE(nCounter == 0);
+
+	oPool.Stop();
+	oPool.ClearCompletedJobs();
+}
+TEST_CASE_END
+
+TEST_CASE("a continuation is run after the job it continues from")
+{
+	volatile LONG nCounter = 0;
+
+	CEvent oStarted(CEvent::MANUAL, CEvent::NOT_SIGNALLED);
+	CEvent oRelease(CEvent::MANUAL, CEvent::NOT_SIGNALLED);
+
+	CThreadPool oPool(2);
+
+	oPool.Start();
+
+	ThreadJobPtr pBlockingJob(new BlockingJob(oStarted, oRelease));
+	ThreadJobPtr pFirstJob(new OrderedJob(nCounter));
+	ThreadJobPtr pSecondJob(new OrderedJob(nCounter));
+
+	WCL::JobFuture oBlocking = oPool.AddJob(pBlockingJob);
+	WCL::JobFuture oSecond = oBlocking.then(pFirstJob).then(pSecondJob);
+
+	oStarted.Wait();
+
+	TEST_TRUE(pFirstJob->Status() == CThreadJob::PENDING);
+	TEST_TRUE(oPool.PendingJobCount() == 0);
+
+	oRelease.Signal();
+
+	TEST_TRUE(oSecond.wait(TIMEOUT));
+	TEST_TRUE(static_cast<OrderedJob*>(pFirstJob.get())->Order() == 1);
+	TEST_TRUE(static_cast<OrderedJob*>(pSecondJob.get())->Order() == 2);
+
+	oPool.Stop();
+	oPool.ClearCompletedJobs();
+}
+TEST_CASE_END
+
+TEST_CASE("cancelling a job cancels its continuations")
+{
+	volatile LONG nCounter = 0;
+
+	CEvent oStarted(CEvent::MANUAL, CEvent::NOT_SIGNALLED);
+	CEvent oRelease(CEvent::MANUAL, CEvent::NOT_SIGNALLED);
+
+	CThreadPool oPool(1);
+
+	oPool.Start();
+
+	ThreadJobPtr pBlockingJob(new BlockingJob(oStarted, oRelease));
+	ThreadJobPtr pJob(new OrderedJob(nCounter));
+	ThreadJobPtr pNextJob(new OrderedJob(nCounter));
+
+	WCL::JobFuture oBlocking = oPool.AddJob(pBlockingJob);
+
+	oStarted.Wait();
+
+	WCL::JobFuture oFuture = oPool.AddJob(pJob);
+	WCL::JobFuture oNext = oFuture.then(pNextJob);
+
+	oFuture.cancel();
+
+	TEST_TRUE(oNext.isCancelled());
+	TEST_TRUE(oNext.wait(0));
+
+	oRelease.Signal();
+
+	TEST_TRUE(oBlocking.wait(TIMEOUT));
+	TEST_TRUE(nCounter == 0);
+
+	oPool.Stop();
+	oPool.ClearCompletedJobs();
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
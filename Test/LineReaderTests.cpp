@@ -0,0 +1,152 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   LineReaderTests.cpp
+//! \brief  The unit tests for the LineReader class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <WCL/LineReader.hpp>
+#include <WCL/MemStream.hpp>
+#include <WCL/Buffer.hpp>
+
+namespace
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read all the lines from an ANSI text buffer as views.
+
+std::vector<std::string> readAnsiLines(const std::string& text, size_t blockSize)
+{
+	CBuffer	   buffer(text.data(), text.size());
+	CMemStream stream(buffer);
+
+	stream.Open();
+
+	WCL::AnsiLineReader reader(stream, blockSize);
+
+	std::vector<std::string> lines;
+	const char* begin = nullptr;
+	const char* end = nullptr;
+
+	while (reader.readLine(begin, end))
+		lines.push_back(std::string(begin, end));
+
+	stream.Close();
+
+	return lines;
+}
+
+}
+
+TEST_SET(LineReader)
+{
+
+TEST_CASE("reading an empty stream returns no lines")
+{
+	std::vector<std::string> lines = readAnsiLines("", WCL::AnsiLineReader::DEFAULT_BLOCK_SIZE);
+
+	TEST_TRUE(lines.empty());
+}
+TEST_CASE_END
+
+TEST_CASE("lines can be terminated by CR, LF or CR/LF")
+{
+	std::vector<std::string> lines = readAnsiLines("CR/LF\r\nLF\nCR\rlast", WCL::AnsiLineReader::DEFAULT_BLOCK_SIZE);
+
+	TEST_TRUE(lines.size() == 4);
+	TEST_TRUE(lines[0] == "CR/LF");
+	TEST_TRUE(lines[1] == "LF");
+	TEST_TRUE(lines[2] == "CR");
+	TEST_TRUE(lines[3] == "last");
+}
+TEST_CASE_END
+
+TEST_CASE("empty lines are returned and a final terminator does not add an empty line")
+{
+	std::vector<std::string> lines = readAnsiLines("\r\n\r\ntext\r\n", WCL::AnsiLineReader::DEFAULT_BLOCK_SIZE);
+
+	TEST_TRUE(lines.size() == 3);
+	TEST_TRUE(lines[0].empty());
+	TEST_TRUE(lines[1].empty());
+	TEST_TRUE(lines[2] == "text");
+}
+TEST_CASE_END
+
+TEST_CASE("lines and terminators that straddle block boundaries are read correctly")
+{
+	const std::string text = "first line\r\nsecond\r\n\r\nthird line is longer than the block\r\nx";
+
+	for (size_t blockSize = 1; blockSize != 16; ++blockSize)
+	{
+		std::vector<std::string> lines = readAnsiLines(text, blockSize);
+
+		TEST_TRUE(lines.size() == 5);
+		TEST_TRUE(lines[0] == "first line");
+		TEST_TRUE(lines[1] == "second");
+		TEST_TRUE(lines[2].empty());
+		TEST_TRUE(lines[3] == "third line is longer than the block");
+		TEST_TRUE(lines[4] == "x");
+	}
+}
+TEST_CASE_END
+
+TEST_CASE("unicode lines are converted to the build's string type")
+{
+	const wchar_t text[] = L"one\r\ntwo\r\n";
+
+	CBuffer	   buffer(text, Core::numBytes<wchar_t>(wcslen(text)));
+	CMemStream stream(buffer);
+
+	stream.Open();
+
+	WCL::UnicodeLineReader reader(stream);
+	tstring                line;
+
+	TEST_TRUE(reader.readLine(line) && (line == TXT("one")));
+	TEST_TRUE(reader.readLine(line) && (line == TXT("two")));
+	TEST_FALSE(reader.readLine(line));
+	TEST_TRUE(reader.isEOF());
+
+	stream.Close();
+}
+TEST_CASE_END
+
+TEST_CASE("reading starts from the current stream position")
+{
+	const char text[] = "skip\r\nread";
+
+	CBuffer	   buffer(text, strlen(text));
+	CMemStream stream(buffer);
+
+	stream.Open();
+	stream.Seek(6);
+
+	WCL::AnsiLineReader reader(stream);
+	tstring             line;
+
+	TEST_TRUE(reader.readLine(line) && (line == TXT("read")));
+	TEST_FALSE(reader.readLine(line));
+
+	stream.Close();
+}
+TEST_CASE_END
+
+TEST_CASE("a large number of lines are all read from the stream")
+{
+	const size_t numLines = 100000;
+	const std::string line = "The quick brown fox jumps over the lazy dog";
+
+	std::string text;
+
+	for (size_t i = 0; i != numLines; ++i)
+		text += line + "\r\n";
+
+	std::vector<std::string> lines = readAnsiLines(text, 4096);
+
+	TEST_TRUE(lines.size() == numLines);
+	TEST_TRUE(std::count(lines.begin(), lines.end(), line) == static_cast<ptrdiff_t>(numLines));
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
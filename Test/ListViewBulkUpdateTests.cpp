@@ -0,0 +1,78 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ListViewBulkUpdateTests.cpp
+//! \brief  The unit tests for the ListViewBulkUpdate class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <WCL/ListViewBulkUpdate.hpp>
+#include <vector>
+
+namespace
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A simple record to display as a row.
+
+struct Record
+{
+	int		m_id;
+	tstring	m_name;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the text for a cell of a record.
+
+struct CellText
+{
+	tstring operator()(const Record& record, size_t column) const
+	{
+		return (column == 0) ? Core::fmt(TXT("%d"), record.m_id) : record.m_name;
+	}
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Order the records by name.
+
+struct ByName
+{
+	bool operator()(const Record& lhs, const Record& rhs) const
+	{
+		return (lhs.m_name < rhs.m_name);
+	}
+};
+
+//! The type of iterator over a vector of records.
+typedef std::vector<Record>::const_iterator RecordIter;
+
+}
+
+TEST_SET(ListViewBulkUpdate)
+{
+
+TEST_CASE("the append methods can be instantiated for a simple record type")
+{
+	size_t (WCL::ListViewBulkUpdate::*appendRows)(RecordIter, RecordIter, size_t, CellText)
+		= &WCL::ListViewBulkUpdate::appendRows<RecordIter, CellText>;
+	size_t (WCL::ListViewBulkUpdate::*appendSortedRows)(RecordIter, RecordIter, ByName, size_t, CellText)
+		= &WCL::ListViewBulkUpdate::appendSortedRows<RecordIter, ByName, CellText>;
+
+	TEST_TRUE(appendRows != nullptr);
+	TEST_TRUE(appendSortedRows != nullptr);
+}
+TEST_CASE_END
+
+TEST_CASE("the sort predicate compares the records, not the pointers to them")
+{
+	const Record first  = { 1, TXT("b") };
+	const Record second = { 2, TXT("a") };
+
+	WCL::Detail::IndirectLess<Record, ByName> less = WCL::Detail::IndirectLess<Record, ByName>(ByName());
+
+	TEST_TRUE(less(&second, &first));
+	TEST_FALSE(less(&first, &second));
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
@@ -0,0 +1,175 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   MappedFileTests.cpp
+//! \brief  The unit tests for the CMappedFile class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <WCL/MappedFile.hpp>
+#include <WCL/File.hpp>
+
+TEST_SET(MappedFile)
+{
+	const CPath path = CPath::TempDir() / TXT("WCL-MappedFileTests.bin");
+	const char* testValue = "unit test";
+
+TEST_CASE("a default constructed file is not open")
+{
+	CMappedFile file;
+
+	TEST_FALSE(file.IsOpen());
+	TEST_TRUE(file.Data() == nullptr);
+	TEST_TRUE(file.Size() == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("bytes written to a new file can be read back through the mapping")
+{
+	CMappedFile file;
+
+	file.Create(path);
+	file.Write(testValue, strlen(testValue));
+	file.Close();
+
+	file.Open(path, GENERIC_READ);
+
+	TEST_TRUE(file.Size() == strlen(testValue));
+	TEST_TRUE(memcmp(file.Data(), testValue, strlen(testValue)) == 0);
+
+	std::vector<char> buffer(strlen(testValue));
+
+	file.Read(&buffer[0], buffer.size());
+
+	TEST_TRUE(memcmp(&buffer[0], testValue, buffer.size()) == 0);
+	TEST_TRUE(file.IsEOF());
+
+	file.Close();
+
+	CFile::Delete(path);
+}
+TEST_CASE_END
+
+TEST_CASE("a written file is truncated to the number of bytes written when closed")
+{
+	CMappedFile file;
+
+	file.Create(path);
+	file.Write(testValue, strlen(testValue));
+	file.Close();
+
+	TEST_TRUE(CFile::Size(path) == strlen(testValue));
+
+	CFile::Delete(path);
+}
+TEST_CASE_END
+
+TEST_CASE("an empty file can be opened but has no mapped bytes")
+{
+	CMappedFile file;
+
+	file.Create(path);
+	file.Close();
+
+	file.Open(path, GENERIC_READ);
+
+	TEST_TRUE(file.Size() == 0);
+	TEST_TRUE(file.Data() == nullptr);
+	TEST_TRUE(file.IsEOF());
+
+	file.Close();
+
+	CFile::Delete(path);
+}
+TEST_CASE_END
+
+TEST_CASE("seeking moves the stream position within the file")
+{
+	CMappedFile file;
+
+	file.Create(path);
+	file.Write(testValue, strlen(testValue));
+	file.Close();
+
+	file.Open(path, GENERIC_READ);
+
+	TEST_TRUE(file.Seek(5) == 5);
+
+	char value[4] = { 0 };
+
+	file.Read(value, 4);
+
+	TEST_TRUE(memcmp(value, "test", 4) == 0);
+	TEST_TRUE(file.Seek(4, WCL::IStreamBase::END) == 5);
+	TEST_THROWS(file.Seek(100));
+
+	file.Close();
+
+	CFile::Delete(path);
+}
+TEST_CASE_END
+
+TEST_CASE("reading past the end of the file throws")
+{
+	CMappedFile file;
+
+	file.Create(path);
+	file.Write(testValue, strlen(testValue));
+	file.Close();
+
+	file.Open(path, GENERIC_READ);
+
+	std::vector<char> buffer(strlen(testValue)+1);
+
+	TEST_THROWS(file.Read(&buffer[0], buffer.size()));
+
+	file.Close();
+
+	CFile::Delete(path);
+}
+TEST_CASE_END
+
+TEST_CASE("a large file written in small chunks matches one written by CFile")
+{
+	const size_t chunkSize = 4 * 1024;
+	const size_t numChunks = (8 * 1024 * 1024) / chunkSize;
+
+	std::vector<byte> chunk(chunkSize);
+
+	for (size_t i = 0; i != chunk.size(); ++i)
+		chunk[i] = static_cast<byte>(i);
+
+	CMappedFile file;
+
+	file.Create(path);
+
+	for (size_t i = 0; i != numChunks; ++i)
+		file.Write(&chunk[0], chunk.size());
+
+	file.Close();
+
+	std::vector<byte> contents;
+
+	TEST_TRUE(CFile::ReadFile(path, contents) == (numChunks * chunkSize));
+
+	bool matches = true;
+
+	for (size_t i = 0; i != contents.size(); ++i)
+		matches = matches && (contents[i] == chunk[i % chunkSize]);
+
+	TEST_TRUE(matches);
+
+	CFile::Delete(path);
+}
+TEST_CASE_END
+
+TEST_CASE("opening a missing file throws")
+{
+	CMappedFile file;
+
+	TEST_THROWS(file.Open(CPath::TempDir() / TXT("WCL-MappedFileTests-Missing.bin"), GENERIC_READ));
+	TEST_FALSE(file.IsOpen());
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
@@ -8,6 +8,7 @@
 #include <WCL/MemStream.hpp>
 #include <WCL/Buffer.hpp>
 #include <Core/ArrayPtr.hpp>
+#include <vector>
 
 TEST_SET(MemStream)
 {
@@ -63,5 +64,105 @@ TEST_CASE("reading from a stream reads from the underlying buffer")
 }
 TEST_CASE_END
 
+TEST_CASE("a stream grows its buffer geometrically by default")
+{
+	CBuffer	   buffer;
+	CMemStream stream(buffer);
+
+	TEST_TRUE(stream.GrowthPolicy() == CMemStream::GEOMETRIC_GROWTH);
+}
+TEST_CASE_END
+
+TEST_CASE("reserving capacity extends the buffer without changing the stream size")
+{
+	const size_t capacity = 64 * 1024;
+
+	CBuffer	   buffer;
+	CMemStream stream(buffer);
+
+	stream.Create();
+	stream.Reserve(capacity);
+
+	TEST_TRUE(stream.Capacity() == capacity);
+	TEST_TRUE(buffer.Size() == capacity);
+	TEST_TRUE(stream.Size() == 0);
+
+	stream.Close();
+}
+TEST_CASE_END
+
+TEST_CASE("shrinking a stream releases the unused capacity")
+{
+	const char* testValue = "unit test";
+
+	CBuffer	   buffer;
+	CMemStream stream(buffer);
+
+	stream.Create();
+	stream.Reserve(64 * 1024);
+	stream.Write(testValue, strlen(testValue));
+	stream.ShrinkToFit();
+
+	TEST_TRUE(stream.Capacity() == strlen(testValue));
+	TEST_TRUE(memcmp(buffer.Buffer(), testValue, strlen(testValue)) == 0);
+
+	stream.Close();
+}
+TEST_CASE_END
+
+TEST_CASE("writing a large stream in small chunks only reallocates a logarithmic number of times")
+{
+	const size_t chunkSize = 4 * 1024;
+	const size_t numChunks = (256 * 1024 * 1024) / chunkSize;
+
+	std::vector<byte> chunk(chunkSize, 0xAA);
+
+	CBuffer	   buffer;
+	CMemStream stream(buffer);
+
+	size_t numReallocs = 0;
+
+	stream.Create();
+
+	for (size_t i = 0; i != numChunks; ++i)
+	{
+		size_t capacity = stream.Capacity();
+
+		stream.Write(&chunk[0], chunk.size());
+
+		if (stream.Capacity() != capacity)
+			++numReallocs;
+	}
+
+	TEST_TRUE(stream.Size() == (numChunks * chunkSize));
+	TEST_TRUE(numReallocs <= 20);
+
+	stream.Close();
+
+	TEST_TRUE(buffer.Size() == (numChunks * chunkSize));
+}
+TEST_CASE_END
+
+TEST_CASE("a fixed growth policy extends the buffer by the size of the write when larger than a page")
+{
+	const size_t chunkSize = 16 * 1024;
+
+	std::vector<byte> chunk(chunkSize);
+
+	CBuffer	   buffer;
+	CMemStream stream(buffer, CMemStream::FIXED_GROWTH);
+
+	stream.Create();
+
+	size_t capacity = stream.Capacity();
+
+	stream.Write(&chunk[0], chunk.size());
+
+	TEST_TRUE(stream.Capacity() == (capacity + chunkSize));
+
+	stream.Close();
+}
+TEST_CASE_END
+
 }
 TEST_SET_END
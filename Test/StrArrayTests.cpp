@@ -0,0 +1,112 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   StrArrayTests.cpp
+//! \brief  The unit tests for the CStrArray class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <WCL/StrArray.hpp>
+
+TEST_SET(StrArray)
+{
+
+TEST_CASE("strings are stored by value")
+{
+	CString  str(TXT("unit"));
+	CStrArray array;
+
+	array.Add(str);
+	str = TXT("test");
+
+	TEST_TRUE(array.Size() == 1);
+	TEST_TRUE(array[0] == TXT("unit"));
+}
+TEST_CASE_END
+
+TEST_CASE("copying an array copies the strings")
+{
+	CStrArray array;
+
+	array.Add(TXT("a string too long for the small string buffer"));
+
+	CStrArray copy(array);
+
+	array.Set(0, TXT("unit"));
+
+	TEST_TRUE(copy.Size() == 1);
+	TEST_TRUE(copy[0] == TXT("a string too long for the small string buffer"));
+}
+TEST_CASE_END
+
+#ifdef WCL_HAS_RVALUE_REFS
+
+TEST_CASE("moving an array moves the strings")
+{
+	CStrArray array;
+
+	array.Add(TXT("unit"));
+
+	CStrArray moved(std::move(array));
+
+	TEST_TRUE(array.Empty());
+	TEST_TRUE(moved.Size() == 1);
+	TEST_TRUE(moved.Find(TXT("unit")) == 0);
+
+	CStrArray assigned;
+
+	assigned = std::move(moved);
+
+	TEST_TRUE(moved.Empty());
+	TEST_TRUE(assigned.Find(TXT("unit")) == 0);
+}
+TEST_CASE_END
+
+#endif
+
+TEST_CASE("find returns the index of the first matching string")
+{
+	CStrArray array;
+
+	array.Add(TXT("one"));
+	array.Add(TXT("One"));
+	array.Add(TXT("one"));
+
+	TEST_TRUE(array.Find(TXT("one")) == 0);
+	TEST_TRUE(array.Find(TXT("One")) == 1);
+	TEST_TRUE(array.Find(TXT("ONE"), true) == 0);
+	TEST_TRUE(array.Find(TXT("two")) == Core::npos);
+}
+TEST_CASE_END
+
+TEST_CASE("an indexed find returns the same results as a scan")
+{
+	CStrArray array;
+
+	array.IndexFind(true);
+
+	for (size_t i = 0; i != 100; ++i)
+		array.Add(CString::Fmt(TXT("%u"), static_cast<uint>(i % 50)));
+
+	TEST_TRUE(array.Find(TXT("0")) == 0);
+	TEST_TRUE(array.Find(TXT("49")) == 49);
+	TEST_TRUE(array.Find(TXT("50")) == Core::npos);
+
+	array.Delete(0);
+
+	TEST_TRUE(array.Find(TXT("0")) == 49);
+
+	array.Insert(0, TXT("50"));
+	array.Add(TXT("51"));
+
+	TEST_TRUE(array.Find(TXT("50")) == 0);
+	TEST_TRUE(array.Find(TXT("51")) == 100);
+	TEST_TRUE(array.Find(TXT("0")) == 50);
+
+	array.DeleteAll();
+
+	TEST_TRUE(array.Find(TXT("0")) == Core::npos);
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
@@ -0,0 +1,93 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   StrTokTests.cpp
+//! \brief  The unit tests for the CStrTok class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <WCL/StrTok.hpp>
+#include <WCL/StrArray.hpp>
+
+namespace
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Compare a span with a string.
+
+bool spanEquals(const CStrTok::Span& span, const tchar* value)
+{
+	return (span.m_nLength == tstrlen(value)) && (tstrncmp(span.m_pszFirst, value, span.m_nLength) == 0);
+}
+
+}
+
+TEST_SET(StrTok)
+{
+
+TEST_CASE("a string is split into fields at each separator")
+{
+	CStrArray fields;
+
+	TEST_TRUE(CStrTok::Split(TXT("a,b,,c"), TXT(','), fields) == 4);
+	TEST_TRUE(fields[0] == TXT("a"));
+	TEST_TRUE(fields[2] == TXT(""));
+	TEST_TRUE(fields[3] == TXT("c"));
+}
+TEST_CASE_END
+
+TEST_CASE("a string can be split into views onto the string")
+{
+	const tchar* value = TXT("a,b,,c");
+
+	CStrTok::CSpans fields;
+
+	TEST_TRUE(CStrTok::Split(value, TXT(','), fields) == 4);
+	TEST_TRUE(fields[0].m_pszFirst == value);
+	TEST_TRUE(spanEquals(fields[1], TXT("b")));
+	TEST_TRUE(spanEquals(fields[2], TXT("")));
+	TEST_TRUE(spanEquals(fields[3], TXT("c")));
+}
+TEST_CASE_END
+
+TEST_CASE("splitting into views replaces the previous contents of the vector")
+{
+	CStrTok::CSpans fields;
+
+	CStrTok::Split(TXT("a,b,c"), TXT(','), fields);
+
+	TEST_TRUE(CStrTok::Split(TXT("d,e"), TXT(','), fields) == 2);
+	TEST_TRUE(spanEquals(fields[0], TXT("d")));
+}
+TEST_CASE_END
+
+TEST_CASE("consecutive separators are merged when requested")
+{
+	CStrTok::CSpans fields;
+
+	TEST_TRUE(CStrTok::Split(TXT("a,,b"), TXT(','), fields, CStrTok::MERGE_SEPS) == 2);
+	TEST_TRUE(spanEquals(fields[1], TXT("b")));
+}
+TEST_CASE_END
+
+TEST_CASE("separators are returned as tokens when requested")
+{
+	CStrTok::CSpans fields;
+
+	TEST_TRUE(CStrTok::Split(TXT("a, b"), TXT(", "), fields, CStrTok::RETURN_SEPS | CStrTok::MERGE_SEPS) == 3);
+	TEST_TRUE(spanEquals(fields[1], TXT(", ")));
+	TEST_TRUE(spanEquals(fields[2], TXT("b")));
+}
+TEST_CASE_END
+
+TEST_CASE("tokens can be read one at a time")
+{
+	CStrTok tokens(TXT("one two"), TXT(' '));
+
+	TEST_TRUE(tokens.NextToken() == TXT("one"));
+	TEST_TRUE(spanEquals(tokens.NextSpan(), TXT("two")));
+	TEST_FALSE(tokens.MoreTokens());
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
@@ -11,6 +11,7 @@
 #include <WCL/MemStream.hpp>
 #include <WCL/Buffer.hpp>
 #include <Core/AnsiWide.hpp>
+#include <utility>
 
 #ifdef ANSI_BUILD
 typedef wchar_t		otherchar_t;
@@ -112,7 +113,7 @@ TEST_CASE("a non-empty string can be inserted and extracted from a stream")
 }
 TEST_CASE_END
 
-TEST_CASE("a string is serialized to a stream based on its buffer capacity, not length")
+TEST_CASE("a string is serialized to a stream based on its length, not buffer capacity")
 {
 	CString testValue(TXT("A very very very long string"));
 	testValue = TXT("A short string");
@@ -127,7 +128,51 @@ TEST_CASE("a string is serialized to a stream based on its buffer capacity, not
 
 	stream.Close();
 
-	TEST_TRUE(buffer.Size() == (sizeof(uint32) + Core::numBytes<tchar>(testValue.Capacity())));
+	TEST_TRUE(buffer.Size() == (sizeof(uint32) + Core::numBytes<tchar>(testValue.Length()+1)));
+}
+TEST_CASE_END
+
+TEST_CASE("a small string is serialized without the unused part of its buffer")
+{
+	const CString testValue(TXT("unit"));
+
+	CBuffer	   buffer;
+	CMemStream stream(buffer);
+	stream.Create();
+
+	stream << testValue;
+
+	stream.Close();
+
+	TEST_TRUE(buffer.Size() == (sizeof(uint32) + Core::numBytes<tchar>(testValue.Length()+1)));
+}
+TEST_CASE_END
+
+TEST_CASE("the size of a serialized string does not depend on how it was built")
+{
+	CString appended;
+
+	for (size_t i = 0; i != 20; ++i)
+		appended += TXT("x");
+
+	const CString constructed(appended.c_str());
+
+	TEST_FALSE(appended.Capacity() == constructed.Capacity());
+
+	CBuffer	   appendedBuffer;
+	CMemStream appendedStream(appendedBuffer);
+	appendedStream.Create();
+	appendedStream << appended;
+	appendedStream.Close();
+
+	CBuffer	   constructedBuffer;
+	CMemStream constructedStream(constructedBuffer);
+	constructedStream.Create();
+	constructedStream << constructed;
+	constructedStream.Close();
+
+	TEST_TRUE(appendedBuffer.Size() == constructedBuffer.Size());
+	TEST_TRUE(memcmp(appendedBuffer.Buffer(), constructedBuffer.Buffer(), appendedBuffer.Size()) == 0);
 }
 TEST_CASE_END
 
@@ -143,8 +188,8 @@ TEST_CASE("a serialized string's length is in characters, not bytes")
 
 	stream.Close();
 
-	uint32 capacity = *(static_cast<const uint32*>(buffer.Buffer()));
-	TEST_TRUE(capacity == testValue.Capacity());
+	uint32 numChars = *(static_cast<const uint32*>(buffer.Buffer()));
+	TEST_TRUE(numChars == testValue.Length()+1);
 }
 TEST_CASE_END
 
@@ -178,7 +223,7 @@ TEST_CASE("a build dependent string can be written to a stream as the opposite s
 
 	stream.Close();
 
-	TEST_TRUE(buffer.Size() == (sizeof(uint32) + Core::numBytes<otherchar_t>(tcharString.Capacity())));
+	TEST_TRUE(buffer.Size() == (sizeof(uint32) + Core::numBytes<otherchar_t>(tcharString.Length()+1)));
 	TEST_TRUE(memcmp(static_cast<const byte*>(buffer.Buffer()) + sizeof(uint32), othercharString, tcharString.Length()+1) == 0);
 }
 TEST_CASE_END
@@ -235,5 +280,288 @@ TEST_CASE("a string serialized as a c-style string can be deserialized as a CStr
 }
 TEST_CASE_END
 
+TEST_CASE("an empty string is serialized with no characters")
+{
+	const CString emptyValue;
+
+	CBuffer	   buffer;
+	CMemStream stream(buffer);
+	stream.Create();
+
+	stream << emptyValue;
+
+	stream.Close();
+
+	TEST_TRUE(buffer.Size() == sizeof(uint32));
+	TEST_TRUE(*(static_cast<const uint32*>(buffer.Buffer())) == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("the length of a string is updated when characters are appended")
+{
+	CString value;
+
+	value += TXT("unit");
+	TEST_TRUE(value.Length() == 4);
+
+	value += TXT(' ');
+	TEST_TRUE(value.Length() == 5);
+
+	value += TXT("test which spills out of the small string buffer");
+	TEST_TRUE(value.Length() == tstrlen(value.c_str()));
+	TEST_TRUE(value == TXT("unit test which spills out of the small string buffer"));
+}
+TEST_CASE_END
+
+TEST_CASE("the length of a string is recalculated after writing directly to its buffer")
+{
+	CString value(TXT("unit test"));
+
+	TEST_TRUE(value.Length() == 9);
+
+	value.Buffer()[4] = TXT('\0');
+
+	TEST_TRUE(value.Length() == 4);
+	TEST_TRUE(value == TXT("unit"));
+}
+TEST_CASE_END
+
+TEST_CASE("the length of a string is updated by insertion and deletion")
+{
+	CString value(TXT("unit test"));
+
+	value.Insert(4, TXT(" [a longer string]"));
+	TEST_TRUE(value == TXT("unit [a longer string] test"));
+	TEST_TRUE(value.Length() == tstrlen(value.c_str()));
+
+	value.Delete(4, 18);
+	TEST_TRUE(value == TXT("unit test"));
+	TEST_TRUE(value.Length() == 9);
+}
+TEST_CASE_END
+
+TEST_CASE("a string can be appended to itself")
+{
+	CString value(TXT("unit"));
+
+	value += value;
+	TEST_TRUE(value == TXT("unitunit"));
+
+	value += value;
+	value += value;
+	TEST_TRUE(value == TXT("unitunitunitunitunitunitunitunit"));
+}
+TEST_CASE_END
+
+TEST_CASE("a copied string is independent of the original")
+{
+	const CString shortValue(TXT("short"));
+	const CString longValue(TXT("a string too long for the small string buffer"));
+
+	CString shortCopy(shortValue);
+	CString longCopy(longValue);
+
+	shortCopy += TXT("er");
+	longCopy.Delete(0, 2);
+
+	TEST_TRUE(shortValue == TXT("short"));
+	TEST_TRUE(shortCopy == TXT("shorter"));
+	TEST_TRUE(longValue == TXT("a string too long for the small string buffer"));
+	TEST_TRUE(longCopy == TXT("string too long for the small string buffer"));
+}
+TEST_CASE_END
+
+TEST_CASE("a string assigned an embedded null is truncated at the null")
+{
+	const tchar buffer[] = { TXT('u'), TXT('n'), TXT('i'), TXT('t'), TXT('\0'), TXT('x') };
+
+	CString value(buffer, sizeof(buffer)/sizeof(buffer[0]));
+
+	TEST_TRUE(value == TXT("unit"));
+	TEST_TRUE(value.Length() == 4);
+}
+TEST_CASE_END
+
+TEST_CASE("formatting a string longer than the initial buffer formats it in full")
+{
+	const tstring padding(1000, TXT('x'));
+
+	CString value;
+
+	value.Format(TXT("[%s]"), padding.c_str());
+
+	TEST_TRUE(value.Length() == padding.length()+2);
+	TEST_TRUE(value == (TXT("[") + padding + TXT("]")).c_str());
+}
+TEST_CASE_END
+
+TEST_CASE("a string can be formatted from its own contents")
+{
+	CString value(TXT("unit"));
+
+	value.Format(TXT("%s test"), value.c_str());
+
+	TEST_TRUE(value == TXT("unit test"));
+}
+TEST_CASE_END
+
+#ifdef WCL_HAS_VARIADIC_TEMPLATES
+
+TEST_CASE("type-safe formatting substitutes the arguments in order")
+{
+	const CString value = CString::FmtArgs(TXT("{} {} {} {} {}"), TXT("unit"), CString(TXT("test")), -42, 42u, true);
+
+	TEST_TRUE(value == TXT("unit test -42 42 true"));
+}
+TEST_CASE_END
+
+TEST_CASE("type-safe formatting treats a doubled brace as a literal brace")
+{
+	const CString value = CString::FmtArgs(TXT("{{{}}"), 1);
+
+	TEST_TRUE(value == TXT("{1}"));
+}
+TEST_CASE_END
+
+TEST_CASE("type-safe formatting formats bool arguments as true or false")
+{
+	TEST_TRUE(CString::FmtArgs(TXT("{} {}"), true, false) == TXT("true false"));
+}
+TEST_CASE_END
+
+#endif
+
+TEST_CASE("reserving space preserves the contents")
+{
+	CString value(TXT("unit"));
+
+	value.Reserve(100);
+
+	TEST_TRUE(value == TXT("unit"));
+	TEST_TRUE(value.Length() == 4);
+	TEST_TRUE(value.Capacity() == 100);
+}
+TEST_CASE_END
+
+TEST_CASE("appending a number of characters appends only those characters")
+{
+	CString value(TXT("unit"));
+
+	value.Append(TXT("test case"), 4);
+
+	TEST_TRUE(value == TXT("unittest"));
+	TEST_TRUE(value.Length() == 8);
+}
+TEST_CASE_END
+
+TEST_CASE("appending many fragments grows the buffer geometrically")
+{
+	const size_t NUM_FRAGMENTS = 1000000;
+
+	CString value;
+	size_t  reallocs = 0;
+	size_t  capacity = value.Capacity();
+
+	for (size_t i = 0; i != NUM_FRAGMENTS; ++i)
+	{
+		value += TXT("field,");
+
+		if (value.Capacity() != capacity)
+		{
+			capacity = value.Capacity();
+			++reallocs;
+		}
+	}
+
+	TEST_TRUE(value.Length() == (NUM_FRAGMENTS * 6));
+	TEST_TRUE(reallocs < 32);
+}
+TEST_CASE_END
+
+TEST_CASE("replacing a string ignores case unless requested")
+{
+	CString folded(TXT("Hello hello HELLO"));
+	CString exact(TXT("Hello hello HELLO"));
+
+	folded.Replace(TXT("hello"), TXT("bye"));
+	exact.Replace(TXT("hello"), TXT("bye"), false);
+
+	TEST_TRUE(folded == TXT("bye bye bye"));
+	TEST_TRUE(exact == TXT("Hello bye HELLO"));
+	TEST_TRUE(exact.Length() == tstrlen(exact.c_str()));
+}
+TEST_CASE_END
+
+TEST_CASE("replacing a string does not rescan the replacement")
+{
+	CString value(TXT("aaaa"));
+
+	value.Replace(TXT("aa"), TXT("a"));
+
+	TEST_TRUE(value == TXT("aa"));
+	TEST_TRUE(value.Length() == 2);
+}
+TEST_CASE_END
+
+TEST_CASE("replacing every character with nothing leaves an empty string")
+{
+	CString value(TXT("a string that spills out of the small string buffer"));
+
+	value.Replace(TXT("a string that spills out of the small string buffer"), TXT(""));
+
+	TEST_TRUE(value.Empty());
+	TEST_TRUE(value.Length() == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("a replacement table replaces all its entries in one pass")
+{
+	const CString::Replacement table[] =
+	{
+		{ TXT("ab"), TXT("1") },
+		{ TXT("a"),  TXT("2") },
+		{ TXT("b"),  TXT("3") },
+	};
+
+	CString value(TXT("abaXb"));
+
+	value.Replace(table, ARRAY_SIZE(table), false);
+
+	TEST_TRUE(value == TXT("12X3"));
+	TEST_TRUE(value.Length() == 4);
+}
+TEST_CASE_END
+
+TEST_CASE("control characters are replaced with their C escape sequences")
+{
+	CString value(TXT("one\ttwo\r\nthree"));
+
+	value.RepCtrlChars();
+
+	TEST_TRUE(value == TXT("one\\ttwo\\r\\nthree"));
+}
+TEST_CASE_END
+
+#ifdef WCL_HAS_RVALUE_REFS
+
+TEST_CASE("moving a string transfers its contents and leaves the source empty")
+{
+	CString shortValue(TXT("short"));
+	CString longValue(TXT("a string too long for the small string buffer"));
+
+	CString shortMoved(std::move(shortValue));
+	CString longMoved;
+
+	longMoved = std::move(longValue);
+
+	TEST_TRUE(shortMoved == TXT("short"));
+	TEST_TRUE(longMoved == TXT("a string too long for the small string buffer"));
+	TEST_TRUE(longValue.Empty());
+	TEST_TRUE(longValue.Length() == 0);
+}
+TEST_CASE_END
+
+#endif
+
 }
 TEST_SET_END
@@ -0,0 +1,311 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ThreadPoolTests.cpp
+//! \brief  The unit tests for the CThreadPool class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <WCL/ThreadPool.hpp>
+#include <WCL/Event.hpp>
+
+namespace
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A job that records the order in which it was run.
+
+class OrderedJob : public CThreadJob
+{
+public:
+	OrderedJob(volatile LONG& nCounter, JobPriority ePriority, DWORD dwMaxWait = INFINITE)
+		: m_nCounter(nCounter)
+		, m_nOrder(0)
+	{
+		Priority(ePriority);
+		MaxWait(dwMaxWait);
+	}
+
+	virtual void Run()
+	{
+		m_nOrder = ::InterlockedIncrement(&m_nCounter);
+	}
+
+	LONG Order() const
+	{
+		return m_nOrder;
+	}
+
+private:
+	volatile LONG&	m_nCounter;
+	LONG			m_nOrder;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! A job that blocks until it is released.
+
+class BlockingJob : public CThreadJob
+{
+public:
+	BlockingJob(CEvent& oStarted, CEvent& oRelease)
+		: m_oStarted(oStarted)
+		, m_oRelease(oRelease)
+	{
+	}
+
+	virtual void Run()
+	{
+		m_oStarted.Signal();
+		m_oRelease.Wait();
+	}
+
+private:
+	CEvent&	m_oStarted;
+	CEvent&	m_oRelease;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! A job that runs until another job has been cancelled.
+
+class WaitForCancelJob : public CThreadJob
+{
+public:
+	WaitForCancelJob(CEvent& oStarted, const ThreadJobPtr& pOther)
+		: m_oStarted(oStarted)
+		, m_pOther(pOther)
+	{
+	}
+
+	virtual void Run()
+	{
+		m_oStarted.Signal();
+
+		const DWORD dwStart = ::GetTickCount();
+
+		while ( (m_pOther->Status() != CThreadJob::CANCELLED) && ((::GetTickCount() - dwStart) < 10000) )
+			::Sleep(1);
+	}
+
+private:
+	CEvent&			m_oStarted;
+	ThreadJobPtr	m_pOther;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the order in which a job was run.
+
+LONG orderOf(const ThreadJobPtr& pJob)
+{
+	return static_cast<OrderedJob*>(pJob.get())->Order();
+}
+
+}
+
+TEST_SET(ThreadPool)
+{
+	const DWORD TIMEOUT = 10000;
+
+TEST_CASE("pending jobs are run in priority order")
+{
+	volatile LONG nCounter = 0;
+
+	CEvent oStarted(CEvent::MANUAL, CEvent::NOT_SIGNALLED);
+	CEvent oRelease(CEvent::MANUAL, CEvent::NOT_SIGNALLED);
+
+	CThreadPool oPool(1);
+
+	oPool.Start();
+
+	ThreadJobPtr pBlockingJob(new BlockingJob(oStarted, oRelease));
+	ThreadJobPtr pBackgroundJob(new OrderedJob(nCounter, CThreadJob::BACKGROUND));
+	ThreadJobPtr pNormalJob(new OrderedJob(nCounter, CThreadJob::NORMAL));
+	ThreadJobPtr pInteractiveJob(new OrderedJob(nCounter, CThreadJob::INTERACTIVE));
+
+	oPool.AddJob(pBlockingJob);
+	oStarted.Wait();
+
+	oPool.AddJob(pBackgroundJob);
+	oPool.AddJob(pNormalJob);
+	oPool.AddJob(pInteractiveJob);
+
+	TEST_TRUE(oPool.Stats(CThreadJob::BACKGROUND).m_nPending == 1);
+	TEST_TRUE(oPool.Stats(CThreadJob::INTERACTIVE).m_nPending == 1);
+
+	oRelease.Signal();
+
+	TEST_TRUE(pBackgroundJob->Wait(TIMEOUT));
+	TEST_TRUE(orderOf(pInteractiveJob) == 1);
+	TEST_TRUE(orderOf(pNormalJob) == 2);
+	TEST_TRUE(orderOf(pBackgroundJob) == 3);
+	TEST_TRUE(oPool.Stats(CThreadJob::INTERACTIVE).m_nPending == 0);
+	TEST_TRUE(oPool.Stats(CThreadJob::INTERACTIVE).m_nStarted == 1);
+	TEST_TRUE(oPool.Stats(CThreadJob::NORMAL).m_nStarted == 2);
+
+	oPool.Stop();
+	oPool.ClearCompletedJobs();
+}
+TEST_CASE_END
+
+TEST_CASE("jobs of equal priority are run in the order they were queued")
+{
+	volatile LONG nCounter = 0;
+
+	CEvent oStarted(CEvent::MANUAL, CEvent::NOT_SIGNALLED);
+	CEvent oRelease(CEvent::MANUAL, CEvent::NOT_SIGNALLED);
+
+	CThreadPool oPool(1);
+
+	oPool.Start();
+
+	ThreadJobPtr pBlockingJob(new BlockingJob(oStarted, oRelease));
+	ThreadJobPtr pFirstJob(new OrderedJob(nCounter, CThreadJob::BACKGROUND));
+	ThreadJobPtr pSecondJob(new OrderedJob(nCounter, CThreadJob::BACKGROUND));
+
+	oPool.AddJob(pBlockingJob);
+	oStarted.Wait();
+
+	oPool.AddJob(pFirstJob);
+	oPool.AddJob(pSecondJob);
+
+	oRelease.Signal();
+
+	TEST_TRUE(pSecondJob->Wait(TIMEOUT));
+	TEST_TRUE(orderOf(pFirstJob) == 1);
+	TEST_TRUE(orderOf(pSecondJob) == 2);
+
+	oPool.Stop();
+	oPool.ClearCompletedJobs();
+}
+TEST_CASE_END
+
+TEST_CASE("a job with a deadline is run ahead of higher priority jobs that are due later")
+{
+	volatile LONG nCounter = 0;
+
+	CEvent oStarted(CEvent::MANUAL, CEvent::NOT_SIGNALLED);
+	CEvent oRelease(CEvent::MANUAL, CEvent::NOT_SIGNALLED);
+
+	CThreadPool oPool(1);
+
+	oPool.Start();
+
+	ThreadJobPtr pBlockingJob(new BlockingJob(oStarted, oRelease));
+	ThreadJobPtr pNormalJob(new OrderedJob(nCounter, CThreadJob::NORMAL));
+	ThreadJobPtr pDeadlineJob(new OrderedJob(nCounter, CThreadJob::BACKGROUND, 0));
+
+	oPool.AddJob(pBlockingJob);
+	oStarted.Wait();
+
+	oPool.AddJob(pNormalJob);
+	oPool.AddJob(pDeadlineJob);
+
+	oRelease.Signal();
+
+	TEST_TRUE(pNormalJob->Wait(TIMEOUT));
+	TEST_TRUE(orderOf(pDeadlineJob) == 1);
+	TEST_TRUE(orderOf(pNormalJob) == 2);
+
+	oPool.Stop();
+	oPool.ClearCompletedJobs();
+}
+TEST_CASE_END
+
+TEST_CASE("with no aging interval jobs are run in the order they were queued")
+{
+	volatile LONG nCounter = 0;
+
+	CEvent oStarted(CEvent::MANUAL, CEvent::NOT_SIGNALLED);
+	CEvent oRelease(CEvent::MANUAL, CEvent::NOT_SIGNALLED);
+
+	CThreadPool oPool(1);
+
+	oPool.AgingInterval(0);
+	oPool.Start();
+
+	ThreadJobPtr pBlockingJob(new BlockingJob(oStarted, oRelease));
+	ThreadJobPtr pBackgroundJob(new OrderedJob(nCounter, CThreadJob::BACKGROUND));
+	ThreadJobPtr pNormalJob(new OrderedJob(nCounter, CThreadJob::NORMAL));
+
+	oPool.AddJob(pBlockingJob);
+	oStarted.Wait();
+
+	::Sleep(50);
+	oPool.AddJob(pBackgroundJob);
+	::Sleep(50);
+	oPool.AddJob(pNormalJob);
+
+	oRelease.Signal();
+
+	TEST_TRUE(pNormalJob->Wait(TIMEOUT));
+	TEST_TRUE(orderOf(pBackgroundJob) == 1);
+	TEST_TRUE(orderOf(pNormalJob) == 2);
+
+	oPool.Stop();
+	oPool.ClearCompletedJobs();
+}
+TEST_CASE_END
+
+TEST_CASE("stopping the pool cancels the pending jobs and releases their futures")
+{
+	volatile LONG nCounter = 0;
+
+	CEvent oStarted(CEvent::MANUAL, CEvent::NOT_SIGNALLED);
+
+	CThreadPool oPool(1);
+
+	oPool.Start();
+
+	ThreadJobPtr pPendingJob(new OrderedJob(nCounter, CThreadJob::NORMAL));
+	ThreadJobPtr pRunningJob(new WaitForCancelJob(oStarted, pPendingJob));
+
+	oPool.AddJob(pRunningJob);
+	oStarted.Wait();
+
+	WCL::JobFuture oFuture = oPool.AddJob(pPendingJob);
+
+	oPool.Stop();
+
+	TEST_TRUE(oFuture.wait(TIMEOUT));
+	TEST_TRUE(oFuture.isCancelled());
+	TEST_TRUE(pRunningJob->Status() == CThreadJob::COMPLETED);
+
+	oPool.ClearCompletedJobs();
+}
+TEST_CASE_END
+
+TEST_CASE("the wait time of each started job is recorded in the histogram")
+{
+	volatile LONG nCounter = 0;
+
+	CThreadPool oPool(1);
+
+	oPool.Start();
+
+	ThreadJobPtr pJob(new OrderedJob(nCounter, CThreadJob::INTERACTIVE));
+
+	oPool.AddJob(pJob);
+
+	TEST_TRUE(pJob->Wait(TIMEOUT));
+
+	CThreadPool::PriorityStats oStats = oPool.Stats(CThreadJob::INTERACTIVE);
+
+	size_t nWaits = 0;
+
+	for (size_t i = 0; i != CThreadPool::NUM_WAIT_BUCKETS; ++i)
+		nWaits += oStats.m_anWaits[i];
+
+	TEST_TRUE(oStats.m_nStarted == 1);
+	TEST_TRUE(nWaits == 1);
+	TEST_TRUE(oStats.m_nMissedDeadlines == 0);
+	TEST_TRUE(CThreadPool::WaitBucketLimit(CThreadPool::NUM_WAIT_BUCKETS-1) == INFINITE);
+
+	oPool.ResetStats();
+
+	TEST_TRUE(oPool.Stats(CThreadJob::INTERACTIVE).m_nStarted == 0);
+
+	oPool.Stop();
+	oPool.ClearCompletedJobs();
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
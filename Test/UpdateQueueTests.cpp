@@ -0,0 +1,175 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   UpdateQueueTests.cpp
+//! \brief  The unit tests for the UpdateQueue class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <WCL/UpdateQueue.hpp>
+#include <vector>
+
+namespace
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A handler which records the updates applied.
+
+class RecordingHandler : public WCL::UpdateQueue::IHandler
+{
+public:
+	//! The details of an applied update.
+	struct Update
+	{
+		WCL::UpdateQueue::Key	m_key;
+		WPARAM					m_wParam;
+		LPARAM					m_lParam;
+	};
+
+	//! Apply the latest update for a key.
+	virtual void applyUpdate(WCL::UpdateQueue::Key key, WPARAM wParam, LPARAM lParam)
+	{
+		Update update = { key, wParam, lParam };
+
+		m_updates.push_back(update);
+	}
+
+	//! The updates applied, in order.
+	std::vector<Update> m_updates;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! A handler which posts more updates and drains the queue again whilst
+//! applying the first one, as a handler that pumps messages might.
+
+class ReentrantHandler : public RecordingHandler
+{
+public:
+	//! Constructor.
+	explicit ReentrantHandler(WCL::UpdateQueue& queue)
+		: m_queue(queue)
+	{
+	}
+
+	//! Apply the latest update for a key.
+	virtual void applyUpdate(WCL::UpdateQueue::Key key, WPARAM wParam, LPARAM lParam)
+	{
+		RecordingHandler::applyUpdate(key, wParam, lParam);
+
+		if (m_updates.size() == 1)
+		{
+			for (WCL::UpdateQueue::Key next = 10; next != 20; ++next)
+				m_queue.post(next);
+
+			m_queue.drain();
+		}
+	}
+
+	//! The queue being drained.
+	WCL::UpdateQueue& m_queue;
+};
+
+}
+
+TEST_SET(UpdateQueue)
+{
+
+TEST_CASE("a new queue is empty")
+{
+	WCL::UpdateQueue queue;
+
+	TEST_TRUE(queue.isEmpty());
+	TEST_TRUE(queue.drain() == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("posting the first update signals the event")
+{
+	WCL::UpdateQueue queue;
+
+	TEST_TRUE(::WaitForSingleObject(queue.event(), 0) == WAIT_TIMEOUT);
+
+	queue.post(1);
+
+	TEST_FALSE(queue.isEmpty());
+	TEST_TRUE(::WaitForSingleObject(queue.event(), 0) == WAIT_OBJECT_0);
+
+	queue.post(2);
+
+	TEST_TRUE(::WaitForSingleObject(queue.event(), 0) == WAIT_TIMEOUT);
+}
+TEST_CASE_END
+
+TEST_CASE("draining the queue applies the updates in the order posted")
+{
+	WCL::UpdateQueue queue;
+	RecordingHandler handler;
+
+	queue.setHandler(&handler);
+	queue.post(1, 10, 100);
+	queue.post(2, 20, 200);
+
+	TEST_TRUE(queue.drain() == 2);
+	TEST_TRUE(queue.isEmpty());
+	TEST_TRUE(handler.m_updates.size() == 2);
+	TEST_TRUE(handler.m_updates[0].m_key == 1);
+	TEST_TRUE(handler.m_updates[0].m_wParam == 10);
+	TEST_TRUE(handler.m_updates[0].m_lParam == 100);
+	TEST_TRUE(handler.m_updates[1].m_key == 2);
+}
+TEST_CASE_END
+
+TEST_CASE("only the latest update for each key is applied")
+{
+	WCL::UpdateQueue queue;
+	RecordingHandler handler;
+
+	queue.setHandler(&handler);
+	queue.post(1, 10);
+	queue.post(2, 20);
+	queue.post(1, 11);
+	queue.post(1, 12);
+
+	TEST_TRUE(queue.drain() == 2);
+	TEST_TRUE(handler.m_updates.size() == 2);
+	TEST_TRUE(handler.m_updates[0].m_key == 2);
+	TEST_TRUE(handler.m_updates[1].m_key == 1);
+	TEST_TRUE(handler.m_updates[1].m_wParam == 12);
+}
+TEST_CASE_END
+
+TEST_CASE("updates posted after draining are applied by the next drain")
+{
+	WCL::UpdateQueue queue;
+	RecordingHandler handler;
+
+	queue.setHandler(&handler);
+	queue.post(1, 10);
+	queue.drain();
+	queue.post(1, 11);
+
+	TEST_TRUE(::WaitForSingleObject(queue.event(), 0) == WAIT_OBJECT_0);
+	TEST_TRUE(queue.drain() == 1);
+	TEST_TRUE(handler.m_updates.size() == 2);
+	TEST_TRUE(handler.m_updates[1].m_wParam == 11);
+}
+TEST_CASE_END
+
+TEST_CASE("a handler can drain the queue whilst an earlier drain is applying updates")
+{
+	WCL::UpdateQueue queue;
+	ReentrantHandler handler(queue);
+
+	queue.setHandler(&handler);
+	queue.post(1);
+	queue.post(2);
+
+	TEST_TRUE(queue.drain() == 2);
+	TEST_TRUE(handler.m_updates.size() == 12);
+	TEST_TRUE(handler.m_updates[1].m_key == 10);
+	TEST_TRUE(handler.m_updates[11].m_key == 2);
+	TEST_TRUE(queue.isEmpty());
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
@@ -0,0 +1,176 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   WndMapTests.cpp
+//! \brief  The unit tests for the CWndMap class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <WCL/WndMap.hpp>
+#include <WCL/Wnd.hpp>
+#include <map>
+
+namespace
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Create a fake window handle from an integer value.
+
+HWND makeHandle(size_t value)
+{
+	return reinterpret_cast<HWND>(value * 4);
+}
+
+}
+
+TEST_SET(WndMap)
+{
+
+TEST_CASE("a window added to the map can be found by its handle")
+{
+	CWnd    wnd(makeHandle(1));
+	CWndMap map;
+
+	map.Add(wnd);
+
+	TEST_TRUE(map.Size() == 1);
+	TEST_TRUE(map.Find(wnd.Handle()) == &wnd);
+
+	map.Remove(wnd);
+}
+TEST_CASE_END
+
+TEST_CASE("finding a handle that is not in the map returns null")
+{
+	CWnd    wnd(makeHandle(1));
+	CWndMap map;
+
+	TEST_TRUE(map.Find(wnd.Handle()) == nullptr);
+
+	map.Add(wnd);
+
+	TEST_TRUE(map.Find(makeHandle(2)) == nullptr);
+
+	map.Remove(wnd);
+}
+TEST_CASE_END
+
+TEST_CASE("a window removed from the map can no longer be found")
+{
+	CWnd    wnd(makeHandle(1));
+	CWndMap map;
+
+	map.Add(wnd);
+	TEST_TRUE(map.Find(wnd.Handle()) == &wnd);
+
+	map.Remove(wnd);
+
+	TEST_TRUE(map.Size() == 0);
+	TEST_TRUE(map.Find(wnd.Handle()) == nullptr);
+}
+TEST_CASE_END
+
+TEST_CASE("adding the same handle twice keeps the original window")
+{
+	CWnd    first(makeHandle(1));
+	CWnd    second(makeHandle(1));
+	CWndMap map;
+
+	map.Add(first);
+	map.Add(second);
+
+	TEST_TRUE(map.Size() == 1);
+	TEST_TRUE(map.Find(first.Handle()) == &first);
+
+	map.Remove(first);
+}
+TEST_CASE_END
+
+TEST_CASE("thousands of windows can be added, found and removed in any order")
+{
+	const size_t numWnds = 5000;
+
+	std::vector<CWnd> wnds;
+	CWndMap           map;
+
+	for (size_t i = 0; i != numWnds; ++i)
+		wnds.push_back(CWnd(makeHandle(i+1)));
+
+	for (size_t i = 0; i != numWnds; ++i)
+		map.Add(wnds[i]);
+
+	TEST_TRUE(map.Size() == numWnds);
+
+	bool allFound = true;
+
+	for (size_t i = 0; i != numWnds; ++i)
+		allFound = allFound && (map.Find(wnds[i].Handle()) == &wnds[i]);
+
+	TEST_TRUE(allFound);
+
+	// Remove every other window.
+	for (size_t i = 0; i < numWnds; i += 2)
+		map.Remove(wnds[i]);
+
+	bool allCorrect = true;
+
+	for (size_t i = 0; i != numWnds; ++i)
+	{
+		CWnd* expected = ((i % 2) == 0) ? nullptr : &wnds[i];
+
+		allCorrect = allCorrect && (map.Find(wnds[i].Handle()) == expected);
+	}
+
+	TEST_TRUE(allCorrect);
+	TEST_TRUE(map.Size() == numWnds/2);
+
+	for (size_t i = 1; i < numWnds; i += 2)
+		map.Remove(wnds[i]);
+
+	TEST_TRUE(map.Size() == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("a replayed sequence of lookups returns the same windows as a std::map")
+{
+	const size_t numWnds = 1000;
+	const size_t numLookups = 100000;
+
+	std::vector<CWnd>     wnds;
+	std::map<HWND, CWnd*> expected;
+	CWndMap               map;
+
+	for (size_t i = 0; i != numWnds; ++i)
+		wnds.push_back(CWnd(makeHandle(i+1)));
+
+	for (size_t i = 0; i != numWnds; ++i)
+	{
+		map.Add(wnds[i]);
+		expected[wnds[i].Handle()] = &wnds[i];
+	}
+
+	bool allMatch = true;
+	size_t value = 1;
+
+	// Bursts of messages for the same window, with some for unknown windows.
+	for (size_t i = 0; i != numLookups; ++i)
+	{
+		if ((i % 4) == 0)
+			value = (value * 1103515245 + 12345) % (numWnds + numWnds/10);
+
+		HWND hWnd = makeHandle(value+1);
+
+		std::map<HWND, CWnd*>::const_iterator it = expected.find(hWnd);
+		CWnd* wnd = (it != expected.end()) ? it->second : nullptr;
+
+		allMatch = allMatch && (map.Find(hWnd) == wnd);
+	}
+
+	TEST_TRUE(allMatch);
+
+	for (size_t i = 0; i != numWnds; ++i)
+		map.Remove(wnds[i]);
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
@@ -0,0 +1,263 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   WorkStealingThreadPoolTests.cpp
+//! \brief  The unit tests for the CWorkStealingThreadPool class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <WCL/WorkStealingThreadPool.hpp>
+#include <WCL/ThreadPool.hpp>
+#include <WCL/Event.hpp>
+
+namespace
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A job that counts the number of times it has been run.
+
+class CountingJob : public CThreadJob
+{
+public:
+	CountingJob(volatile LONG& nCount)
+		: m_nCount(nCount)
+	{
+	}
+
+	virtual void Run()
+	{
+		::InterlockedIncrement(&m_nCount);
+	}
+
+private:
+	volatile LONG&	m_nCount;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! A job that blocks until it is released.
+
+class BlockingJob : public CThreadJob
+{
+public:
+	BlockingJob(CEvent& oStarted, CEvent& oRelease)
+		: m_oStarted(oStarted)
+		, m_oRelease(oRelease)
+	{
+	}
+
+	virtual void Run()
+	{
+		m_oStarted.Signal();
+		m_oRelease.Wait();
+	}
+
+private:
+	CEvent&	m_oStarted;
+	CEvent&	m_oRelease;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! A job that adds more jobs to the pool it is running in.
+
+class SpawningJob : public CThreadJob
+{
+public:
+	SpawningJob(CWorkStealingThreadPool& oPool, volatile LONG& nCount, size_t nChildren)
+		: m_oPool(oPool)
+		, m_nCount(nCount)
+		, m_nChildren(nChildren)
+	{
+	}
+
+	virtual void Run()
+	{
+		for (size_t i = 0; i != m_nChildren; ++i)
+		{
+			ThreadJobPtr pJob(new CountingJob(m_nCount));
+
+			m_oPool.AddJob(pJob);
+		}
+	}
+
+private:
+	CWorkStealingThreadPool&	m_oPool;
+	volatile LONG&				m_nCount;
+	size_t						m_nChildren;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Wait for the pool to complete the expected number of jobs.
+
+template<typename PoolT>
+bool waitForCompletedJobs(const PoolT& oPool, size_t nJobs)
+{
+	const DWORD dwTimeout = 10000;
+	const DWORD dwStart = ::GetTickCount();
+
+	while (oPool.CompletedJobCount() != nJobs)
+	{
+		if ((::GetTickCount() - dwStart) > dwTimeout)
+			return false;
+
+		::Sleep(1);
+	}
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Run a batch of short jobs through the pool.
+
+template<typename PoolT>
+bool runCountingJobs(PoolT& oPool, size_t nJobs)
+{
+	volatile LONG nCount = 0;
+
+	oPool.Start();
+
+	for (size_t i = 0; i != nJobs; ++i)
+	{
+		ThreadJobPtr pJob(new CountingJob(nCount));
+
+		oPool.AddJob(pJob);
+	}
+
+	bool bCompleted = waitForCompletedJobs(oPool, nJobs);
+
+	oPool.Stop();
+	oPool.ClearCompletedJobs();
+
+	return bCompleted && (static_cast<size_t>(nCount) == nJobs);
+}
+
+}
+
+TEST_SET(WorkStealingThreadPool)
+{
+	const size_t NUM_THREADS = 4;
+	const size_t NUM_JOBS = 10000;
+
+TEST_CASE("all jobs added to the pool are run and then moved to the completed queue")
+{
+	CWorkStealingThreadPool oPool(NUM_THREADS);
+
+	TEST_TRUE(runCountingJobs(oPool, NUM_JOBS));
+	TEST_TRUE(oPool.PendingJobCount() == 0);
+	TEST_TRUE(oPool.RunningJobCount() == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("the pool runs the same workload as the shared queue thread pool")
+{
+	CWorkStealingThreadPool oStealingPool(NUM_THREADS);
+	CThreadPool             oSharedPool(NUM_THREADS);
+
+	TEST_TRUE(runCountingJobs(oStealingPool, NUM_JOBS));
+	TEST_TRUE(runCountingJobs(oSharedPool, NUM_JOBS));
+}
+TEST_CASE_END
+
+TEST_CASE("jobs added by a running job are run by the pool")
+{
+	const size_t NUM_CHILDREN = 100;
+
+	volatile LONG nCount = 0;
+
+	CWorkStealingThreadPool oPool(NUM_THREADS);
+
+	oPool.Start();
+
+	ThreadJobPtr pJob(new SpawningJob(oPool, nCount, NUM_CHILDREN));
+
+	oPool.AddJob(pJob);
+
+	TEST_TRUE(waitForCompletedJobs(oPool, NUM_CHILDREN+1));
+	TEST_TRUE(static_cast<size_t>(nCount) == NUM_CHILDREN);
+
+	oPool.Stop();
+	oPool.ClearCompletedJobs();
+}
+TEST_CASE_END
+
+TEST_CASE("cancelling pending jobs moves them to the completed queue without running them")
+{
+	volatile LONG nCount = 0;
+
+	CEvent oStarted(CEvent::MANUAL, CEvent::NOT_SIGNALLED);
+	CEvent oRelease(CEvent::MANUAL, CEvent::NOT_SIGNALLED);
+
+	CWorkStealingThreadPool oPool(1);
+
+	oPool.Start();
+
+	ThreadJobPtr pBlockingJob(new BlockingJob(oStarted, oRelease));
+	ThreadJobPtr pFirstJob(new CountingJob(nCount));
+	ThreadJobPtr pSecondJob(new CountingJob(nCount));
+
+	oPool.AddJob(pBlockingJob);
+	oStarted.Wait();
+
+	oPool.AddJob(pFirstJob);
+	oPool.AddJob(pSecondJob);
+
+	TEST_TRUE(oPool.PendingJobCount() == 2);
+	TEST_TRUE(oPool.RunningJobCount() == 1);
+
+	oPool.CancelJob(pFirstJob);
+
+	TEST_TRUE(pFirstJob->Status() == CThreadJob::CANCELLED);
+	TEST_TRUE(oPool.PendingJobCount() == 1);
+	TEST_TRUE(oPool.CompletedJobCount() == 1);
+
+	oPool.CancelAllJobs();
+
+	TEST_TRUE(pSecondJob->Status() == CThreadJob::CANCELLED);
+	TEST_TRUE(oPool.PendingJobCount() == 0);
+	TEST_TRUE(oPool.CompletedJobCount() == 2);
+
+	oRelease.Signal();
+
+	TEST_TRUE(waitForCompletedJobs(oPool, 3));
+	TEST_TRUE(pBlockingJob->Status() == CThreadJob::COMPLETED);
+	TEST_TRUE(nCount == 0);
+
+	oPool.Stop();
+	oPool.ClearCompletedJobs();
+}
+TEST_CASE_END
+
+TEST_CASE("a job cancelled directly whilst queued is moved to the completed queue when dequeued")
+{
+	volatile LONG nCount = 0;
+
+	CEvent oStarted(CEvent::MANUAL, CEvent::NOT_SIGNALLED);
+	CEvent oRelease(CEvent::MANUAL, CEvent::NOT_SIGNALLED);
+
+	CWorkStealingThreadPool oPool(1);
+
+	oPool.Start();
+
+	ThreadJobPtr pBlockingJob(new BlockingJob(oStarted, oRelease));
+	ThreadJobPtr pJob(new CountingJob(nCount));
+
+	oPool.AddJob(pBlockingJob);
+	oStarted.Wait();
+
+	oPool.AddJob(pJob);
+
+	TEST_TRUE(pJob->Cancel());
+	TEST_TRUE(pJob->Wait(0));
+
+	oRelease.Signal();
+
+	TEST_TRUE(waitForCompletedJobs(oPool, 2));
+	TEST_TRUE(oPool.PendingJobCount() == 0);
+	TEST_TRUE(pJob->Status() == CThreadJob::CANCELLED);
+	TEST_TRUE(nCount == 0);
+
+	oPool.Stop();
+	oPool.ClearCompletedJobs();
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
@@ -10,6 +10,9 @@
 
 #include "Common.hpp"
 #include "ThreadJob.hpp"
+#include "ThreadPool.hpp"
+#include "MsgThread.hpp"
+#include "AutoThreadLock.hpp"
 
 /******************************************************************************
 ** Method:		Constructor.
@@ -25,6 +28,12 @@
 
 CThreadJob::CThreadJob()
 	: m_eStatus(PENDING)
+	, m_ePriority(NORMAL)
+	, m_dwMaxWait(INFINITE)
+	, m_oLock()
+	, m_bFinished(false)
+	, m_hFinished(NULL)
+	, m_oContinuations()
 {
 }
 
@@ -42,4 +51,204 @@ CThreadJob::CThreadJob()
 
 CThreadJob::~CThreadJob()
 {
+	if (m_hFinished != NULL)
+		::CloseHandle(m_hFinished);
+}
+
+/******************************************************************************
+** Method:		Cancel()
+**
+** Description:	Cancel the job, if it has not started running. This can be
+**				used on a job that is queued on a pool or thread or is still
+**				waiting for the job it continues from. The runners skip any
+**				job that is no longer pending.
+**
+** Parameters:	None.
+**
+** Returns:		true if the job was cancelled.
+**
+*******************************************************************************
+*/
+
+bool CThreadJob::Cancel()
+{
+	if (!ChangeStatus(PENDING, CANCELLED))
+		return false;
+
+	OnFinished();
+
+	return true;
+}
+
+/******************************************************************************
+** Method:		Wait()
+**
+** Description:	Wait for the job to complete or be cancelled.
+**
+** Parameters:	dwTimeout	The maximum time to wait in ms.
+**
+** Returns:		true if the job finished, false if the wait timed out.
+**
+*******************************************************************************
+*/
+
+bool CThreadJob::Wait(DWORD dwTimeout)
+{
+	HANDLE hFinished = NULL;
+
+	{
+		CAutoThreadLock oAutoLock(m_oLock);
+
+		if (m_bFinished)
+			return true;
+
+		// Create the event on first use.
+		if (m_hFinished == NULL)
+			m_hFinished = ::CreateEvent(NULL, TRUE, FALSE, NULL);
+
+		ASSERT(m_hFinished != NULL);
+
+		hFinished = m_hFinished;
+	}
+
+	return (::WaitForSingleObject(hFinished, dwTimeout) == WAIT_OBJECT_0);
+}
+
+/******************************************************************************
+** Method:		ContinueWith()
+**
+** Description:	Queue another job on a thread pool once this one has finished.
+**				If this job is cancelled, the next one is cancelled too.
+**
+** Parameters:	pNext	The job to queue.
+**				oPool	The pool to queue it on.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CThreadJob::ContinueWith(ThreadJobPtr& pNext, CThreadPool& oPool)
+{
+	ASSERT(pNext.get() != nullptr);
+
+	Continuation oContinuation = { pNext, &oPool, nullptr };
+
+	AddContinuation(oContinuation);
+}
+
+/******************************************************************************
+** Method:		ContinueWith()
+**
+** Description:	Queue another job on a message thread once this one has
+**				finished. The job is run by the thread's message loop, e.g.
+**				to update the UI with the result of this job. If this job is
+**				cancelled, the next one is cancelled too.
+**
+** Parameters:	pNext		The job to queue.
+**				oThread		The thread to queue it on.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CThreadJob::ContinueWith(ThreadJobPtr& pNext, CMsgThread& oThread)
+{
+	ASSERT(pNext.get() != nullptr);
+
+	Continuation oContinuation = { pNext, nullptr, &oThread };
+
+	AddContinuation(oContinuation);
+}
+
+/******************************************************************************
+** Method:		OnFinished()
+**
+** Description:	Signal that the job has completed or been cancelled. This
+**				releases any waiters and queues the continuations. It is
+**				called by whatever ran or cancelled the job.
+**
+** Parameters:	None.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CThreadJob::OnFinished()
+{
+	ASSERT(IsFinished());
+
+	CContinuations oContinuations;
+
+	{
+		CAutoThreadLock oAutoLock(m_oLock);
+
+		ASSERT(!m_bFinished);
+
+		m_bFinished = true;
+
+		if (m_hFinished != NULL)
+			::SetEvent(m_hFinished);
+
+		oContinuations.swap(m_oContinuations);
+	}
+
+	// Queue them outside the lock.
+	for (CContinuations::iterator oIter = oContinuations.begin(); oIter != oContinuations.end(); ++oIter)
+		QueueContinuation(*oIter);
+}
+
+/******************************************************************************
+** Method:		AddContinuation()
+**
+** Description:	Add a job to queue once this one has finished. If this job has
+**				already finished the job is queued immediately.
+**
+** Parameters:	oContinuation	The job and where to queue it.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CThreadJob::AddContinuation(const Continuation& oContinuation)
+{
+	{
+		CAutoThreadLock oAutoLock(m_oLock);
+
+		if (!m_bFinished)
+		{
+			m_oContinuations.push_back(oContinuation);
+			return;
+		}
+	}
+
+	Continuation oCopy = oContinuation;
+
+	QueueContinuation(oCopy);
+}
+
+/******************************************************************************
+** Method:		QueueContinuation()
+**
+** Description:	Queue a job on its pool or thread, or cancel it if this job
+**				was cancelled.
+**
+** Parameters:	oContinuation	The job and where to queue it.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CThreadJob::QueueContinuation(Continuation& oContinuation)
+{
+	if (Status() == CANCELLED)
+		oContinuation.m_pJob->Cancel();
+	else if (oContinuation.m_pThread != nullptr)
+		oContinuation.m_pThread->PostJob(oContinuation.m_pJob);
+	else
+		oContinuation.m_pPool->AddJob(oContinuation.m_pJob);
 }
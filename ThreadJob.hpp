@@ -16,6 +16,17 @@
 #pragma once
 #endif
 
+#include "CriticalSection.hpp"
+#include <vector>
+
+// Forward declarations.
+class CThreadJob;
+class CThreadPool;
+class CMsgThread;
+
+//! The CThreadJob smart-pointer type.
+typedef Core::SharedPtr<CThreadJob> ThreadJobPtr;
+
 /******************************************************************************
 ** 
 ** A job that runs on a worker thread in a thread pool.
@@ -41,26 +52,90 @@ public:
 		CANCELLED,
 	};
 
+	// Job priority.
+	enum JobPriority
+	{
+		INTERACTIVE,		// Latency sensitive, e.g. a UI refresh.
+		NORMAL,				// The default.
+		BACKGROUND,			// Bulk work.
+
+		NUM_PRIORITIES
+	};
+
 	//
 	// Accessors.
 	//
 	JobStatus Status() const;
 	void      Status(JobStatus eStatus);
 
+	//! Atomically change the status, if it currently has the expected value.
+	bool      ChangeStatus(JobStatus eExpected, JobStatus eStatus);
+
+	JobPriority Priority() const;
+	void        Priority(JobPriority ePriority);
+
+	//! Get the maximum time the job should wait to be run, if any.
+	DWORD MaxWait() const;
+	//! Set the maximum time the job should wait to be run.
+	void  MaxWait(DWORD dwMaxWait);
+
+	//! Query if the job has completed or been cancelled.
+	bool IsFinished() const;
+
 	//
 	// Methods.
 	//
 	virtual void Run() = 0;
 
+	//! Cancel the job, if it has not started running.
+	bool Cancel();
+
+	//! Wait for the job to complete or be cancelled.
+	bool Wait(DWORD dwTimeout = INFINITE);
+
+	//! Queue another job on a thread pool once this one has finished.
+	void ContinueWith(ThreadJobPtr& pNext, CThreadPool& oPool);
+
+	//! Queue another job on a message thread once this one has finished.
+	void ContinueWith(ThreadJobPtr& pNext, CMsgThread& oThread);
+
+	//! Signal that the job has completed or been cancelled.
+	void OnFinished();
+
 protected:
+	// A job to queue once this one has finished.
+	struct Continuation
+	{
+		ThreadJobPtr	m_pJob;			// The job to queue.
+		CThreadPool*	m_pPool;		// The pool to queue it on, or
+		CMsgThread*		m_pThread;		// the thread to queue it on.
+	};
+
+	// Template shorthands.
+	typedef std::vector<Continuation> CContinuations;
+
 	//
 	// Members.
 	//
-	JobStatus	m_eStatus;
-};
+	volatile LONG		m_eStatus;			// The JobStatus, stored for atomic access.
+	JobPriority			m_ePriority;		// The scheduling priority.
+	DWORD				m_dwMaxWait;		// The deadline in ms from being queued.
+	CCriticalSection	m_oLock;			// The lock for the completion state.
+	bool				m_bFinished;		// Has OnFinished() been called?
+	HANDLE				m_hFinished;		// Signalled when finished, created on demand.
+	CContinuations		m_oContinuations;	// The jobs to queue once finished.
 
-//! The CThreadJob smart-pointer type.
-typedef Core::SharedPtr<CThreadJob> ThreadJobPtr;
+	//
+	// Internal methods.
+	//
+	void AddContinuation(const Continuation& oContinuation);
+	void QueueContinuation(Continuation& oContinuation);
+
+private:
+	// NotCopyable.
+	CThreadJob(const CThreadJob&);
+	CThreadJob& operator=(const CThreadJob&);
+};
 
 /******************************************************************************
 **
@@ -71,12 +146,54 @@ typedef Core::SharedPtr<CThreadJob> ThreadJobPtr;
 
 inline CThreadJob::JobStatus CThreadJob::Status() const
 {
-	return m_eStatus;
+	return static_cast<JobStatus>(m_eStatus);
 }
 
 inline void CThreadJob::Status(JobStatus eStatus)
 {
-	m_eStatus = eStatus;
+	::InterlockedExchange(&m_eStatus, eStatus);
+}
+
+inline bool CThreadJob::ChangeStatus(JobStatus eExpected, JobStatus eStatus)
+{
+	return (::InterlockedCompareExchange(&m_eStatus, eStatus, eExpected) == eExpected);
+}
+
+inline CThreadJob::JobPriority CThreadJob::Priority() const
+{
+	return m_ePriority;
+}
+
+inline void CThreadJob::Priority(JobPriority ePriority)
+{
+	ASSERT(ePriority < NUM_PRIORITIES);
+
+	m_ePriority = ePriority;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the maximum time the job should wait to be run, or INFINITE if it has
+//! no deadline.
+
+inline DWORD CThreadJob::MaxWait() const
+{
+	return m_dwMaxWait;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Set the maximum time the job should wait, from being queued, to be run. A
+//! pool runs it ahead of any job of any priority that is due later.
+
+inline void CThreadJob::MaxWait(DWORD dwMaxWait)
+{
+	m_dwMaxWait = dwMaxWait;
+}
+
+inline bool CThreadJob::IsFinished() const
+{
+	JobStatus eStatus = Status();
+
+	return ( (eStatus == COMPLETED) || (eStatus == CANCELLED) );
 }
 
 #endif // THREADJOB_HPP
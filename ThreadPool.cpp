@@ -15,6 +15,12 @@
 #include <algorithm>
 #include "AutoThreadLock.hpp"
 
+// The upper bound of each wait time histogram bucket in ms.
+static const DWORD s_adwWaitLimits[CThreadPool::NUM_WAIT_BUCKETS] =
+{
+	10, 50, 100, 500, 1000, 5000, INFINITE
+};
+
 /******************************************************************************
 ** Method:		Constructor.
 **
@@ -35,8 +41,12 @@ CThreadPool::CThreadPool(size_t nThreads)
 	, m_oRunningQ()
 	, m_oCompletedQ()
 	, m_oLock()
+	, m_dwAgingInterval(DEFAULT_AGING_INTERVAL)
+	, m_nSequence(0)
 {
 	ASSERT(m_nThreads > 0);
+
+	memset(m_aoStats, 0, sizeof(m_aoStats));
 }
 
 /******************************************************************************
@@ -93,7 +103,9 @@ void CThreadPool::Start()
 /******************************************************************************
 ** Method:		Stop()
 **
-** Description:	Stop the thread pool running.
+** Description:	Stop the thread pool running. Any jobs still pending are
+**				cancelled, so that anyone waiting on them is released, and
+**				any jobs already running are left to complete.
 **
 ** Parameters:	None.
 **
@@ -107,6 +119,9 @@ void CThreadPool::Stop()
 	ASSERT(!m_oPool.empty());
 	ASSERT(m_eStatus == RUNNING);
 
+	// Cancel first, so no more are scheduled as the running jobs complete.
+	CancelAllJobs();
+
 	// Stop the pool threads.
 	for (size_t i = 0; i < m_nThreads; ++i)
 		m_oPool[i]->Stop();
@@ -117,16 +132,21 @@ void CThreadPool::Stop()
 /******************************************************************************
 ** Method:		AddJob()
 **
-** Description:	Add a new job to be run in the pool.
+** Description:	Add a new job to be run in the pool. The job is given a due
+**				time from its priority and deadline, and the pending jobs are
+**				run in order of due time. A lower priority job is due one
+**				aging interval per priority later than a higher one queued at
+**				the same time, so it is eventually run ahead of newer higher
+**				priority jobs rather than starving.
 **
 ** Parameters:	pJob	The job to add.
 **
-** Returns:		Nothing.
+** Returns:		A future used to wait for, cancel or continue from the job.
 **
 *******************************************************************************
 */
 
-void CThreadPool::AddJob(ThreadJobPtr& pJob)
+WCL::JobFuture CThreadPool::AddJob(ThreadJobPtr& pJob)
 {
 	ASSERT(pJob.get() != nullptr);
 	ASSERT(m_eStatus == RUNNING);
@@ -134,11 +154,27 @@ void CThreadPool::AddJob(ThreadJobPtr& pJob)
 	// Lock queues.
 	CAutoThreadLock oAutoLock(m_oLock);
 
+	const CThreadJob::JobPriority ePriority = pJob->Priority();
+	const DWORD                   dwNow     = ::GetTickCount();
+
+	// Allow for its priority, unless it has an earlier deadline.
+	DWORD dwDelay = static_cast<DWORD>(ePriority) * m_dwAgingInterval;
+
+	if (pJob->MaxWait() < dwDelay)
+		dwDelay = pJob->MaxWait();
+
+	PendingJob oPending = { pJob, ePriority, dwNow, dwNow + dwDelay, m_nSequence++ };
+
 	// Add to the pending queue.
-	m_oPendingQ.push_back(pJob);
+	m_oPendingQ.push_back(oPending);
+	std::push_heap(m_oPendingQ.begin(), m_oPendingQ.end(), IsDueLater);
+
+	++m_aoStats[ePriority].m_nPending;
 
 	// Try and run it.
 	ScheduleJob();
+
+	return WCL::JobFuture(pJob, this);
 }
 
 /******************************************************************************
@@ -159,23 +195,27 @@ void CThreadPool::CancelJob(ThreadJobPtr& pJob)
 	ASSERT(m_eStatus == RUNNING);
 
 	// Template shorthands.
-	typedef CJobQueue::iterator CIter;
+	typedef CPendingQueue::iterator CIter;
 
 	// Lock queues.
 	CAutoThreadLock oAutoLock(m_oLock);
 
 	// If pending, move to completed queue.
 	// NB: If running, leave it to complete.
-	CIter oIter = std::find(m_oPendingQ.begin(), m_oPendingQ.end(), pJob);
-
-	if (oIter != m_oPendingQ.end())
+	for (CIter oIter = m_oPendingQ.begin(); oIter != m_oPendingQ.end(); ++oIter)
 	{
-		ASSERT(pJob->Status() == CThreadJob::PENDING);
+		if (oIter->m_pJob == pJob)
+		{
+			--m_aoStats[oIter->m_ePriority].m_nPending;
+
+			m_oPendingQ.erase(oIter);
+			std::make_heap(m_oPendingQ.begin(), m_oPendingQ.end(), IsDueLater);
 
-		pJob->Status(CThreadJob::CANCELLED);
+			pJob->Cancel();
 
-		m_oCompletedQ.push_back(pJob);
-		m_oPendingQ.erase(oIter);
+			m_oCompletedQ.push_back(pJob);
+			break;
+		}
 	}
 }
 
@@ -196,23 +236,27 @@ void CThreadPool::CancelAllJobs()
 	ASSERT(m_eStatus == RUNNING);
 
 	// Template shorthands.
-	typedef CJobQueue::const_iterator CIter;
+	typedef CPendingQueue::const_iterator CIter;
 
 	// Lock queues.
 	CAutoThreadLock oAutoLock(m_oLock);
 
+	CPendingQueue oPendingQ;
+
+	oPendingQ.swap(m_oPendingQ);
+
 	// Move all pending jobs to completed queue.
 	// NB: Leave all running jobs to complete.
-	for (CIter oIter = m_oPendingQ.begin(); oIter != m_oPendingQ.end(); ++oIter)
+	for (CIter oIter = oPendingQ.begin(); oIter != oPendingQ.end(); ++oIter)
 	{
-		ThreadJobPtr pJob = *oIter;
+		ThreadJobPtr pJob = oIter->m_pJob;
+
+		--m_aoStats[oIter->m_ePriority].m_nPending;
 
-		pJob->Status(CThreadJob::CANCELLED);
+		pJob->Cancel();
 
 		m_oCompletedQ.push_back(pJob);
 	}
-
-	m_oPendingQ.clear();
 }
 
 /******************************************************************************
@@ -265,9 +309,6 @@ void CThreadPool::ScheduleJob()
 {
 	ASSERT(m_eStatus == RUNNING);
 
-	// Template shorthands.
-	typedef CJobQueue::iterator CIter;
-
 	// Lock queues.
 	CAutoThreadLock oAutoLock(m_oLock);
 
@@ -283,16 +324,36 @@ void CThreadPool::ScheduleJob()
 		// Found one?
 		if (pThread->Status() == ThreadPoolThread::IDLE)
 		{
-			// Get next job.
-			CIter        oIter = m_oPendingQ.begin();
-			ThreadJobPtr pJob  = *oIter;
+			const DWORD dwNow = ::GetTickCount();
 
-			// Assign to thread.
-			pThread->RunJob(pJob);
+			while (!m_oPendingQ.empty())
+			{
+				// Get the job that is due first.
+				std::pop_heap(m_oPendingQ.begin(), m_oPendingQ.end(), IsDueLater);
 
-			// Move from pending to running queue.
-			m_oPendingQ.erase(oIter);
-			m_oRunningQ.push_back(pJob);
+				PendingJob   oPending = m_oPendingQ.back();
+				ThreadJobPtr pJob     = oPending.m_pJob;
+
+				m_oPendingQ.pop_back();
+
+				--m_aoStats[oPending.m_ePriority].m_nPending;
+
+				// Cancelled while pending?
+				if (!pJob->ChangeStatus(CThreadJob::PENDING, CThreadJob::RUNNING))
+				{
+					m_oCompletedQ.push_back(pJob);
+					continue;
+				}
+
+				OnJobStarted(oPending, dwNow);
+
+				// Assign to thread.
+				pThread->RunJob(pJob);
+
+				// Move to running queue.
+				m_oRunningQ.push_back(pJob);
+				break;
+			}
 			break;
 		}
 	}
@@ -333,3 +394,155 @@ void CThreadPool::OnJobCompleted(ThreadJobPtr& pJob)
 	// Try and run another.
 	ScheduleJob();
 }
+
+/******************************************************************************
+** Method:		AgingInterval()
+**
+** Description:	Set how long a job waits before it is due ahead of a job one
+**				priority higher that was queued at the same time. This only
+**				affects jobs queued afterwards. An interval of 0 runs the jobs
+**				in the order they were queued, bar any deadlines.
+**
+** Parameters:	dwInterval	The interval in ms.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CThreadPool::AgingInterval(DWORD dwInterval)
+{
+	CAutoThreadLock oAutoLock(m_oLock);
+
+	m_dwAgingInterval = dwInterval;
+}
+
+/******************************************************************************
+** Method:		Stats()
+**
+** Description:	Get the scheduling metrics for a priority.
+**
+** Parameters:	ePriority	The priority.
+**
+** Returns:		The metrics.
+**
+*******************************************************************************
+*/
+
+CThreadPool::PriorityStats CThreadPool::Stats(CThreadJob::JobPriority ePriority) const
+{
+	ASSERT(ePriority < CThreadJob::NUM_PRIORITIES);
+
+	CAutoThreadLock oAutoLock(m_oLock);
+
+	return m_aoStats[ePriority];
+}
+
+/******************************************************************************
+** Method:		ResetStats()
+**
+** Description:	Reset the scheduling metrics. The pending job counts are left
+**				as they reflect the current queue depth.
+**
+** Parameters:	None.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CThreadPool::ResetStats()
+{
+	CAutoThreadLock oAutoLock(m_oLock);
+
+	for (size_t i = 0; i < CThreadJob::NUM_PRIORITIES; ++i)
+	{
+		const size_t nPending = m_aoStats[i].m_nPending;
+
+		memset(&m_aoStats[i], 0, sizeof(m_aoStats[i]));
+
+		m_aoStats[i].m_nPending = nPending;
+	}
+}
+
+/******************************************************************************
+** Method:		WaitBucketLimit()
+**
+** Description:	Get the upper bound of a wait time histogram bucket. A wait
+**				is counted in the first bucket whose limit exceeds it.
+**
+** Parameters:	nBucket		The bucket index.
+**
+** Returns:		The limit in ms, or INFINITE for the last bucket.
+**
+*******************************************************************************
+*/
+
+DWORD CThreadPool::WaitBucketLimit(size_t nBucket)
+{
+	ASSERT(nBucket < NUM_WAIT_BUCKETS);
+
+	return s_adwWaitLimits[nBucket];
+}
+
+/******************************************************************************
+** Method:		OnJobStarted()
+**
+** Description:	Update the metrics for a job that is about to be run.
+**
+** Parameters:	oPending	The pending job details.
+**				dwNow		The current tick count.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CThreadPool::OnJobStarted(const PendingJob& oPending, DWORD dwNow)
+{
+	PriorityStats& oStats = m_aoStats[oPending.m_ePriority];
+	const DWORD    dwWait = dwNow - oPending.m_dwQueued;
+
+	size_t nBucket = 0;
+
+	while ( (nBucket < NUM_WAIT_BUCKETS-1) && (dwWait >= s_adwWaitLimits[nBucket]) )
+		++nBucket;
+
+	++oStats.m_nStarted;
+	++oStats.m_anWaits[nBucket];
+
+	if (dwWait > oStats.m_dwLongestWait)
+		oStats.m_dwLongestWait = dwWait;
+
+	if (dwWait > oPending.m_pJob->MaxWait())
+		++oStats.m_nMissedDeadlines;
+}
+
+/******************************************************************************
+** Method:		IsDueLater()
+**
+** Description:	The heap ordering for the pending jobs. Jobs are ordered by
+**				due time, then priority, then the order they were queued in.
+**				The due times are compared so that the tick count wrapping
+**				around is handled.
+**
+** Parameters:	oLHS	The first job.
+**				oRHS	The second job.
+**
+** Returns:		true if the first job should run after the second.
+**
+*******************************************************************************
+*/
+
+bool CThreadPool::IsDueLater(const PendingJob& oLHS, const PendingJob& oRHS)
+{
+	const LONG nDiff = static_cast<LONG>(oLHS.m_dwDue - oRHS.m_dwDue);
+
+	if (nDiff != 0)
+		return (nDiff > 0);
+
+	if (oLHS.m_ePriority != oRHS.m_ePriority)
+		return (oLHS.m_ePriority > oRHS.m_ePriority);
+
+	return (oLHS.m_nSequence > oRHS.m_nSequence);
+}
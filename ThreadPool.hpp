@@ -18,6 +18,7 @@
 
 #include "CriticalSection.hpp"
 #include "ThreadJob.hpp"
+#include "JobFuture.hpp"
 #include <vector>
 
 // Forward declarations.
@@ -39,6 +40,22 @@ public:
 	CThreadPool(size_t nThreads);
 	~CThreadPool();
 
+	//! The number of buckets in the wait time histogram.
+	static const size_t NUM_WAIT_BUCKETS = 7;
+
+	//! The default time a job waits before being promoted a priority.
+	static const DWORD DEFAULT_AGING_INTERVAL = 1000;
+
+	// The scheduling metrics for a priority.
+	struct PriorityStats
+	{
+		size_t	m_nPending;						// The number of jobs queued.
+		size_t	m_nStarted;						// The number of jobs started.
+		size_t	m_nMissedDeadlines;				// The number of jobs started late.
+		DWORD	m_dwLongestWait;				// The longest wait in ms.
+		size_t	m_anWaits[NUM_WAIT_BUCKETS];	// The wait time histogram.
+	};
+
 	//
 	// Control Methods.
 	//
@@ -48,13 +65,24 @@ public:
 	//
 	// Job Methods.
 	//
-	void AddJob(ThreadJobPtr& pJob);
+	WCL::JobFuture AddJob(ThreadJobPtr& pJob);
 	void CancelJob(ThreadJobPtr& pJob);
 	void CancelAllJobs();
 
 	void ClearCompletedJobs();
 	void DeleteCompletedJobs();
 
+	//
+	// Scheduling.
+	//
+	DWORD AgingInterval() const;
+	void  AgingInterval(DWORD dwInterval);
+
+	PriorityStats Stats(CThreadJob::JobPriority ePriority) const;
+	void          ResetStats();
+
+	static DWORD WaitBucketLimit(size_t nBucket);
+
 	//
 	// Queue accessors.
 	//
@@ -68,6 +96,19 @@ protected:
 	typedef std::vector<ThreadPoolThreadPtr> CThreads;
 	typedef std::vector<ThreadJobPtr> CJobQueue;
 
+	// A job waiting to be run.
+	struct PendingJob
+	{
+		ThreadJobPtr	m_pJob;			// The job.
+		CThreadJob::JobPriority m_ePriority;	// The priority it was queued with.
+		DWORD			m_dwQueued;		// When it was queued.
+		DWORD			m_dwDue;		// When it should be run by.
+		size_t			m_nSequence;	// The order it was queued in.
+	};
+
+	// The heap of pending jobs, ordered by due time.
+	typedef std::vector<PendingJob> CPendingQueue;
+
 	// Thread pool status.
 	enum Status
 	{
@@ -81,16 +122,22 @@ protected:
 	size_t				m_nThreads;
 	Status				m_eStatus;
 	CThreads			m_oPool;
-	CJobQueue			m_oPendingQ;
+	CPendingQueue		m_oPendingQ;
 	CJobQueue			m_oRunningQ;
 	CJobQueue			m_oCompletedQ;
-	CCriticalSection	m_oLock;
+	mutable CCriticalSection m_oLock;
+	DWORD				m_dwAgingInterval;					// The wait per priority promotion.
+	size_t				m_nSequence;						// The next job sequence number.
+	PriorityStats		m_aoStats[CThreadJob::NUM_PRIORITIES];	// The metrics per priority.
 
 	//
 	// Internal methods.
 	//
 	void ScheduleJob();
 	void OnJobCompleted(ThreadJobPtr& pJob);
+	void OnJobStarted(const PendingJob& oPending, DWORD dwNow);
+
+	static bool IsDueLater(const PendingJob& oLHS, const PendingJob& oRHS);
 
 	// Friends.
 	friend class ThreadPoolThread;
@@ -118,4 +165,9 @@ inline size_t CThreadPool::CompletedJobCount() const
 	return m_oCompletedQ.size();
 }
 
+inline DWORD CThreadPool::AgingInterval() const
+{
+	return m_dwAgingInterval;
+}
+
 #endif // THREADPOOL_HPP
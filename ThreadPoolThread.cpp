@@ -148,7 +148,8 @@ void ThreadPoolThread::Start()
 /******************************************************************************
 ** Method:		Stop()
 **
-** Description:	Stop the underlying thread.
+** Description:	Stop the underlying thread. Any job it is running is completed
+**				first.
 **
 ** Parameters:	None.
 **
@@ -159,8 +160,6 @@ void ThreadPoolThread::Start()
 
 void ThreadPoolThread::Stop()
 {
-	ASSERT(m_eStatus == IDLE);
-
 	// Signal to terminate itself.
 	PostMessage(STOP_THREAD);
 
@@ -184,13 +183,10 @@ void ThreadPoolThread::Stop()
 void ThreadPoolThread::RunJob(ThreadJobPtr& pJob)
 {
 	ASSERT(pJob.get() != nullptr);
-	ASSERT(pJob->Status() == CThreadJob::PENDING);
+	ASSERT(pJob->Status() == CThreadJob::RUNNING);
 	ASSERT(m_eStatus == IDLE);
 	ASSERT(m_pJob.get() == nullptr);
 
-	// Update job state.
-	pJob->Status(CThreadJob::RUNNING);
-
 	// Update thread state.
 	m_eStatus = RUNNING;
 	m_pJob    = pJob;
@@ -291,6 +287,9 @@ void ThreadPoolThread::OnRunJob()
 
 	// Notify thread pool.
 	m_oPool.OnJobCompleted(pJob);
+
+	// Release waiters and queue continuations.
+	pJob->OnFinished();
 }
 
 #if (__GNUC__ >= 8) // GCC 8+
@@ -6,8 +6,11 @@
 #include "Common.hpp"
 #include "TraceLogger.hpp"
 #include "Path.hpp"
+#include "AutoThreadLock.hpp"
 #include <stdio.h>
+#include <stdlib.h>
 #include <tchar.h>
+#include <crtdbg.h>
 
 #if (__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 2)) // GCC 4.2+
 // missing initializer for member 'X'
@@ -29,6 +32,39 @@ bool TraceLogger::g_bNewLine = true;
 //! Disable ASSERT dialogs?
 bool TraceLogger::g_bConsume = false;
 
+//! The size at which to rotate the log.
+size_t TraceLogger::g_nMaxFileSize = 0;
+
+//! Are messages being buffered?
+volatile bool TraceLogger::g_bBuffered = false;
+
+//! The messages waiting to be written.
+std::string TraceLogger::g_strBuffer;
+
+//! The lock for the message buffer.
+CCriticalSection TraceLogger::g_oBufferLock;
+
+//! The lock for the open log file.
+CCriticalSection TraceLogger::g_oFileLock;
+
+//! The log file, whilst buffering.
+FILE* TraceLogger::g_fLogFile = nullptr;
+
+//! Signals the writer thread.
+HANDLE TraceLogger::g_hWakeEvent = NULL;
+
+//! The writer thread.
+HANDLE TraceLogger::g_hWriter = NULL;
+
+//! How often the writer thread writes the buffered messages.
+static const DWORD WRITE_INTERVAL = 250;
+
+//! The buffer size at which the writer thread is woken early.
+static const size_t WAKE_THRESHOLD = 32*1024;
+
+//! The buffer size at which the caller writes the messages itself.
+static const size_t MAX_BUFFER_SIZE = 1024*1024;
+
 ////////////////////////////////////////////////////////////////////////////////
 //! Install the logger.
 
@@ -58,10 +94,229 @@ void TraceLogger::EnableDialogs(bool bEnable)
 	g_bConsume = !bEnable;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+//! Set whether to buffer messages and write them on a background thread. Any
+//! buffered messages are also written when the process exits.
+
+void TraceLogger::EnableBuffering(bool bEnable)
+{
+	if (!bEnable)
+	{
+		Shutdown();
+		return;
+	}
+
+	if (g_bBuffered)
+		return;
+
+	static bool bAtExitRegistered = false;
+
+	if (!bAtExitRegistered)
+	{
+		atexit(Shutdown);
+		bAtExitRegistered = true;
+	}
+
+	HANDLE hProcess = ::GetCurrentProcess();
+	HANDLE hThreadEvent = NULL;
+
+	// The writer thread gets its own handle to the event as it may outlive
+	// the call to Shutdown().
+	g_hWakeEvent = ::CreateEvent(nullptr, FALSE, FALSE, nullptr);
+
+	if ( (g_hWakeEvent != NULL)
+	  && ::DuplicateHandle(hProcess, g_hWakeEvent, hProcess, &hThreadEvent, 0, FALSE, DUPLICATE_SAME_ACCESS) )
+	{
+		g_bBuffered = true;
+		g_hWriter = ::CreateThread(nullptr, 0, WriterThread, hThreadEvent, 0, nullptr);
+	}
+
+	// Failed to start the writer? Carry on writing each message directly.
+	if (g_hWriter == NULL)
+	{
+		g_bBuffered = false;
+
+		if (hThreadEvent != NULL)
+			::CloseHandle(hThreadEvent);
+
+		if (g_hWakeEvent != NULL)
+			::CloseHandle(g_hWakeEvent);
+
+		g_hWakeEvent = NULL;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Set the size at which the log file is rotated. When the next message would
+//! take the file over the limit it is renamed with a ".1" suffix, replacing any
+//! previous one, and a new file started. A size of 0 disables rotation.
+
+void TraceLogger::SetMaxFileSize(size_t nMaxBytes)
+{
+	g_nMaxFileSize = nMaxBytes;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Write any buffered messages to the log file.
+
+void TraceLogger::Flush()
+{
+	CAutoThreadLock oFileLock(g_oFileLock);
+
+	std::string strMessages;
+
+	// Take the pending messages.
+	{
+		CAutoThreadLock oBufferLock(g_oBufferLock);
+
+		strMessages.swap(g_strBuffer);
+	}
+
+	if (!strMessages.empty())
+		WriteLogFile(g_fLogFile, strMessages);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Stop buffering, writing any buffered messages to the log file. The writer
+//! thread is told to exit but not waited on as this may be called whilst the
+//! loader lock is held.
+
+void TraceLogger::Shutdown()
+{
+	if (!g_bBuffered)
+		return;
+
+	// Send new messages directly to the file.
+	{
+		CAutoThreadLock oBufferLock(g_oBufferLock);
+
+		g_bBuffered = false;
+	}
+
+	::SetEvent(g_hWakeEvent);
+
+	Flush();
+
+	CAutoThreadLock oFileLock(g_oFileLock);
+
+	if (g_fLogFile != nullptr)
+	{
+		fclose(g_fLogFile);
+		g_fLogFile = nullptr;
+	}
+
+	::CloseHandle(g_hWakeEvent);
+	::CloseHandle(g_hWriter);
+
+	g_hWakeEvent = NULL;
+	g_hWriter = NULL;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //! The CRT hook function to write all TRACE and ASSERTs to a file.
 
-int TraceLogger::ReportHook(int /*nType*/, char* pszMessage, int* piRetVal)
+int TraceLogger::ReportHook(int nType, char* pszMessage, int* piRetVal)
+{
+	std::string strMessage;
+
+	// Start of new message?
+	if (g_bNewLine)
+		FormatTimestamp(strMessage);
+
+	strMessage += pszMessage;
+
+	// Message ended with CRLF?
+	for (const char* psz = pszMessage; *psz != '\0'; ++psz)
+		g_bNewLine = ((*psz == '\r') || (*psz == '\n'));
+
+	bool   bQueued = false;
+	size_t nBuffered = 0;
+
+	// Queue the message for the writer thread?
+	if (g_bBuffered)
+	{
+		CAutoThreadLock oBufferLock(g_oBufferLock);
+
+		if (g_bBuffered)
+		{
+			g_strBuffer += strMessage;
+			nBuffered = g_strBuffer.size();
+			bQueued = true;
+
+			if (nBuffered >= WAKE_THRESHOLD)
+				::SetEvent(g_hWakeEvent);
+		}
+	}
+
+	if (bQueued)
+	{
+		// Make sure an ASSERT or error is on disk before any dialog or break.
+		if ( (nType != _CRT_WARN) || (nBuffered >= MAX_BUFFER_SIZE) )
+			Flush();
+	}
+	else
+	{
+		FILE* fLogFile = nullptr;
+
+		WriteLogFile(fLogFile, strMessage);
+
+		if (fLogFile != nullptr)
+			fclose(fLogFile);
+	}
+
+	// Don't force a debug break.
+	*piRetVal = FALSE;
+
+	// Chain to _CrtDbgReport.
+	return g_bConsume;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Format the timestamp written at the start of each message. The format is
+//! "[DD/MM/YYYY HH:MM:SS.mmm] " in UTC.
+
+void TraceLogger::FormatTimestamp(std::string& strBuffer)
+{
+	SYSTEMTIME st = {0};
+
+	::GetSystemTime(&st);
+
+	const struct { uint nValue; uint nDigits; char cSuffix; } aoFields[] =
+	{
+		{ st.wDay,          2, '/' },
+		{ st.wMonth,        2, '/' },
+		{ st.wYear,         4, ' ' },
+		{ st.wHour,         2, ':' },
+		{ st.wMinute,       2, ':' },
+		{ st.wSecond,       2, '.' },
+		{ st.wMilliseconds, 3, ']' },
+	};
+
+	strBuffer += '[';
+
+	for (size_t i = 0; i != ARRAY_SIZE(aoFields); ++i)
+	{
+		char szDigits[4];
+		uint nValue = aoFields[i].nValue;
+
+		for (uint nDigit = aoFields[i].nDigits; nDigit != 0; --nDigit)
+		{
+			szDigits[nDigit-1] = static_cast<char>('0' + (nValue % 10));
+			nValue /= 10;
+		}
+
+		strBuffer.append(szDigits, aoFields[i].nDigits);
+		strBuffer += aoFields[i].cSuffix;
+	}
+
+	strBuffer += ' ';
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Open the log file for appending. The default log file is created in the
+//! application folder if none has been set.
+
+FILE* TraceLogger::OpenLogFile()
 {
 	// Create default logfile path.
 	if (g_szTraceLog[0] == TXT('\0'))
@@ -69,36 +324,71 @@ int TraceLogger::ReportHook(int /*nType*/, char* pszMessage, int* piRetVal)
 
 	FILE* fLogFile = _tfopen(g_szTraceLog, TXT("a"));
 
-	// Opened log file okay?
 	if (fLogFile != nullptr)
+		fseek(fLogFile, 0, SEEK_END);
+
+	return fLogFile;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Append the messages to the log file, opening it if required. If the
+//! messages would take the file over the maximum size it is rotated first.
+//! Nothing in here can use TRACE or ASSERT as that would re-enter the hook.
+
+void TraceLogger::WriteLogFile(FILE*& fLogFile, const std::string& strMessages)
+{
+	if (fLogFile == nullptr)
+		fLogFile = OpenLogFile();
+
+	// Opened log file okay?
+	if (fLogFile == nullptr)
+		return;
+
+	if (g_nMaxFileSize != 0)
 	{
-		// Start of new message?
-		if (g_bNewLine)
+		long lSize = ftell(fLogFile);
+
+		if ( (lSize > 0) && ((static_cast<size_t>(lSize) + strMessages.size()) > g_nMaxFileSize) )
 		{
-			SYSTEMTIME st = {0};
+			tstring strOldLog = tstring(g_szTraceLog) + TXT(".1");
+
+			fclose(fLogFile);
 
-			::GetSystemTime(&st);
+			_tremove(strOldLog.c_str());
+			_trename(g_szTraceLog, strOldLog.c_str());
 
-			// Write the date and time.
-			fprintf(fLogFile, "[%02d/%02d/%04d %02d:%02d:%02d.%03d] ",
-						st.wDay,  st.wMonth,  st.wYear,
-						st.wHour, st.wMinute, st.wSecond, st.wMilliseconds);
+			fLogFile = OpenLogFile();
+
+			if (fLogFile == nullptr)
+				return;
 		}
+	}
 
-		// Write the message and close.
-		fputs(pszMessage, fLogFile);
-		fclose(fLogFile);
+	fputs(strMessages.c_str(), fLogFile);
+	fflush(fLogFile);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! The writer thread function. It periodically writes the buffered messages to
+//! the log file until buffering is stopped.
 
-		// Message ended with CRLF?
-		for (const char* psz = pszMessage; *psz != '\0'; ++psz)
-			g_bNewLine = ((*psz == '\r') || (*psz == '\n'));
+DWORD WINAPI TraceLogger::WriterThread(LPVOID lpParam)
+{
+	HANDLE hWakeEvent = static_cast<HANDLE>(lpParam);
+
+	while (g_bBuffered)
+	{
+		::WaitForSingleObject(hWakeEvent, WRITE_INTERVAL);
+
+		if (!g_bBuffered)
+			break;
+
+		Flush();
 	}
 
-	// Don't force a debug break.
-	*piRetVal = FALSE;
+	::CloseHandle(hWakeEvent);
 
-	// Chain to _CrtDbgReport.
-	return g_bConsume;
+	return 0;
 }
 
 //namespace WCL
@@ -11,6 +11,10 @@
 #pragma once
 #endif
 
+#include "CriticalSection.hpp"
+#include <stdio.h>
+#include <string>
+
 namespace WCL
 {
 
@@ -18,6 +22,11 @@ namespace WCL
 //! The logger used to write CRT output message to a file. This class consists
 //! entirely of static members and functions as once installed, it can never be
 //! uninstalled.
+//!
+//! By default each message is appended to the file as it is reported. When
+//! buffering is enabled the messages are queued in memory and written by a
+//! background thread to a file that is kept open. The buffer is written
+//! immediately when an ASSERT or error is reported and on shutdown.
 
 class TraceLogger
 {
@@ -31,6 +40,18 @@ public:
 	//! Set whether to display ASSERTs.
 	static void EnableDialogs(bool bEnable);
 
+	//! Set whether to buffer messages and write them on a background thread.
+	static void EnableBuffering(bool bEnable);
+
+	//! Set the size at which the log file is rotated.
+	static void SetMaxFileSize(size_t nMaxBytes);
+
+	//! Write any buffered messages to the log file.
+	static void Flush();
+
+	//! Stop buffering, writing any buffered messages to the log file.
+	static void Shutdown();
+
 private:
 	//
 	// Class members.
@@ -39,8 +60,29 @@ private:
 	static bool  g_bNewLine;				//!< Did last message include CRLF?
 	static bool  g_bConsume;				//!< Disable ASSERT dialogs?
 
+	static size_t			g_nMaxFileSize;	//!< The size at which to rotate the log.
+	static volatile bool	g_bBuffered;	//!< Are messages being buffered?
+	static std::string		g_strBuffer;	//!< The messages waiting to be written.
+	static CCriticalSection	g_oBufferLock;	//!< The lock for the message buffer.
+	static CCriticalSection	g_oFileLock;	//!< The lock for the open log file.
+	static FILE*			g_fLogFile;		//!< The log file, whilst buffering.
+	static HANDLE			g_hWakeEvent;	//!< Signals the writer thread.
+	static HANDLE			g_hWriter;		//!< The writer thread.
+
 	//! The CRT callback.function.
-	static int ReportHook(int /*nType*/, char* pszMessage, int* piRetVal);
+	static int ReportHook(int nType, char* pszMessage, int* piRetVal);
+
+	//! Format the timestamp written at the start of each message.
+	static void FormatTimestamp(std::string& strBuffer);
+
+	//! Open the log file for appending, rotating it if it's too big.
+	static FILE* OpenLogFile();
+
+	//! Append the messages to the open log file.
+	static void WriteLogFile(FILE*& fLogFile, const std::string& strMessages);
+
+	//! The writer thread function.
+	static DWORD WINAPI WriterThread(LPVOID lpParam);
 };
 
 //namespace WCL
@@ -0,0 +1,173 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   UpdateQueue.cpp
+//! \brief  The UpdateQueue class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "UpdateQueue.hpp"
+
+namespace WCL
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor.
+
+UpdateQueue::UpdateQueue()
+	: m_head(nullptr)
+	, m_event(CEvent::AUTO_RESET, CEvent::NOT_SIGNALLED)
+	, m_handler(nullptr)
+	, m_batch()
+	, m_latest()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor. Any waiting updates are discarded.
+
+UpdateQueue::~UpdateQueue()
+{
+	deleteList(m_head);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Set the handler used to apply the updates. If there is no handler the
+//! updates are discarded when drained.
+
+void UpdateQueue::setHandler(IHandler* handler)
+{
+	m_handler = handler;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the event signalled when the queue becomes non-empty.
+
+HANDLE UpdateQueue::event() const
+{
+	return m_event.Handle();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if there are any updates waiting.
+
+bool UpdateQueue::isEmpty() const
+{
+	return (m_head == nullptr);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Post an update. The update is pushed onto the queue without taking a lock
+//! and the owning thread is only signalled if the queue was empty.
+
+void UpdateQueue::post(Key key, WPARAM wParam, LPARAM lParam)
+{
+	Node* node = new Node;
+
+	node->m_key    = key;
+	node->m_wParam = wParam;
+	node->m_lParam = lParam;
+
+	Node* head = nullptr;
+
+	do
+	{
+		head = m_head;
+		node->m_next = head;
+	}
+	while (::InterlockedCompareExchangePointer(reinterpret_cast<PVOID volatile*>(&m_head), node, head) != head);
+
+	if (head == nullptr)
+		m_event.Signal();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Apply the waiting updates. All the waiting updates are taken in one go
+//! and, for each key, only the latest update is applied. The keys are applied
+//! in the order their latest updates were posted. Returns the number of
+//! updates applied.
+//!
+//! A handler may pump messages and so drain the queue again. The batch is
+//! therefore taken into locals, so that a nested drain works on its own one.
+
+size_t UpdateQueue::drain()
+{
+	if (m_head == nullptr)
+		return 0;
+
+	Batch  batch;
+	Latest latest;
+
+	// Reuse the containers from the last batch.
+	batch.swap(m_batch);
+	latest.swap(m_latest);
+
+	Node* node = static_cast<Node*>(::InterlockedExchangePointer(reinterpret_cast<PVOID volatile*>(&m_head), nullptr));
+
+	// The list is newest first.
+	for (; node != nullptr; node = node->m_next)
+	{
+		batch.push_back(node);
+		latest.insert(std::make_pair(node->m_key, node));
+	}
+
+	size_t applied = 0;
+
+	try
+	{
+		for (Batch::const_reverse_iterator it = batch.rbegin(); it != batch.rend(); ++it)
+		{
+			Node* update = *it;
+
+			if (latest[update->m_key] != update)
+				continue;
+
+			if (m_handler != nullptr)
+				m_handler->applyUpdate(update->m_key, update->m_wParam, update->m_lParam);
+
+			++applied;
+		}
+	}
+	catch (...)
+	{
+		deleteBatch(batch);
+		throw;
+	}
+
+	deleteBatch(batch);
+
+	latest.clear();
+
+	// Keep the containers for the next batch.
+	m_batch.swap(batch);
+	m_latest.swap(latest);
+
+	return applied;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Delete the nodes in a list.
+
+void UpdateQueue::deleteList(Node* node)
+{
+	while (node != nullptr)
+	{
+		Node* next = node->m_next;
+
+		delete node;
+		node = next;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Delete the nodes in a batch. The container is cleared but keeps its
+//! storage.
+
+void UpdateQueue::deleteBatch(Batch& batch)
+{
+	for (Batch::const_iterator it = batch.begin(); it != batch.end(); ++it)
+		delete *it;
+
+	batch.clear();
+}
+
+//namespace WCL
+}
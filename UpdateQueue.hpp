@@ -0,0 +1,121 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   UpdateQueue.hpp
+//! \brief  The UpdateQueue class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef WCL_UPDATEQUEUE_HPP
+#define WCL_UPDATEQUEUE_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "Event.hpp"
+#include <vector>
+#include <map>
+
+namespace WCL
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A queue used by worker threads to send state updates to a message thread.
+//! Each update has a key and a pair of message-style parameters. Posting never
+//! blocks, and the thread that owns the queue applies the updates in batches.
+//! Within a batch only the latest update for each key is applied, so a burst
+//! of progress updates from a busy producer results in a single repaint.
+//!
+//! The owning thread is woken by an event that is signalled when the queue
+//! goes from empty to non-empty, so no more than one wake-up is outstanding
+//! however many updates are posted. Superseded updates are discarded, so the
+//! parameters should be values rather than pointers to owned resources.
+
+class UpdateQueue /*: private NotCopyable*/
+{
+public:
+	//! The type used to identify what is being updated.
+	typedef uint Key;
+
+	//! The interface used to apply the updates.
+	class IHandler
+	{
+	public:
+		//! Destructor.
+		virtual ~IHandler() {};
+
+		//! Apply the latest update for a key.
+		virtual void applyUpdate(Key key, WPARAM wParam, LPARAM lParam) = 0;
+	};
+
+	//! Default constructor.
+	UpdateQueue();
+
+	//! Destructor.
+	~UpdateQueue();
+
+	//
+	// Properties.
+	//
+
+	//! Set the handler used to apply the updates.
+	void setHandler(IHandler* handler);
+
+	//! Get the event signalled when the queue becomes non-empty.
+	HANDLE event() const;
+
+	//! Query if there are any updates waiting.
+	bool isEmpty() const;
+
+	//
+	// Methods.
+	//
+
+	//! Post an update. This can be called from any thread.
+	void post(Key key, WPARAM wParam = 0, LPARAM lParam = 0);
+
+	//! Apply the waiting updates. This is called on the owning thread.
+	size_t drain();
+
+private:
+	//! A single queued update.
+	struct Node
+	{
+		Node*	m_next;		//!< The next (older) update.
+		Key		m_key;		//!< The update key.
+		WPARAM	m_wParam;	//!< The first parameter.
+		LPARAM	m_lParam;	//!< The second parameter.
+	};
+
+	//! A batch of updates, oldest first.
+	typedef std::vector<Node*> Batch;
+	//! The map of key to latest update.
+	typedef std::map<Key, Node*> Latest;
+
+	//
+	// Members.
+	//
+	Node* volatile	m_head;		//!< The most recent update.
+	CEvent			m_event;	//!< Signalled when the queue becomes non-empty.
+	IHandler*		m_handler;	//!< The handler for the updates.
+	Batch			m_batch;	//!< The storage reused for each batch.
+	Latest			m_latest;	//!< The storage reused for the latest updates.
+
+	//
+	// Internal methods.
+	//
+
+	//! Delete the nodes in a list.
+	static void deleteList(Node* node);
+
+	//! Delete the nodes in a batch.
+	static void deleteBatch(Batch& batch);
+
+	// NotCopyable.
+	UpdateQueue(const UpdateQueue&);
+	UpdateQueue& operator=(const UpdateQueue&);
+};
+
+//namespace WCL
+}
+
+#endif // WCL_UPDATEQUEUE_HPP
@@ -105,6 +105,16 @@ const Seconds SECS_PER_DAY  = 60 * 60 * 24;
 //! Helper for specifying a clipboard format.
 #define CF_NONE		0
 
+#if (__cplusplus >= 201103L) || (_MSC_VER >= 1600)
+//! Defined when the compiler supports rvalue references and move semantics.
+#define WCL_HAS_RVALUE_REFS
+#endif
+
+#if (__cplusplus >= 201103L) || (_MSC_VER >= 1800)
+//! Defined when the compiler supports variadic templates.
+#define WCL_HAS_VARIADIC_TEMPLATES
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 // Text handling types and definitions.
 
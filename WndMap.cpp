@@ -12,6 +12,9 @@
 #include "WndMap.hpp"
 #include "Wnd.hpp"
 
+//! The initial number of slots in the table. This must be a power of 2.
+const size_t INITIAL_SLOTS = 64;
+
 /******************************************************************************
 ** Method:		Constructor.
 **
@@ -25,7 +28,9 @@
 */
 
 CWndMap::CWndMap()
-	: m_oMap()
+	: m_vSlots(INITIAL_SLOTS)
+	, m_nCount(0)
+	, m_nLastSlot(0)
 {
 }
 
@@ -43,7 +48,7 @@ CWndMap::CWndMap()
 
 CWndMap::~CWndMap()
 {
-	ASSERT(m_oMap.empty());
+	ASSERT(m_nCount == 0);
 }
 
 /******************************************************************************
@@ -62,7 +67,20 @@ void CWndMap::Add(CWnd& rWnd)
 {
 	ASSERT(rWnd.Handle() != NULL);
 
-	m_oMap.insert(std::make_pair(rWnd.Handle(), &rWnd));
+	size_t nSlot = FindSlot(rWnd.Handle());
+
+	// Already mapped?
+	if (m_vSlots[nSlot].m_hWnd != NULL)
+		return;
+
+	m_vSlots[nSlot].m_hWnd = rWnd.Handle();
+	m_vSlots[nSlot].m_pWnd = &rWnd;
+
+	++m_nCount;
+
+	// Keep the load factor at or below 50%.
+	if ((m_nCount * 2) > m_vSlots.size())
+		Grow();
 }
 
 /******************************************************************************
@@ -80,9 +98,36 @@ void CWndMap::Add(CWnd& rWnd)
 void CWndMap::Remove(CWnd& rWnd)
 {
 	ASSERT(rWnd.Handle() != NULL);
-	ASSERT(m_oMap.find(rWnd.Handle()) != m_oMap.end());
 
-	m_oMap.erase(m_oMap.find(rWnd.Handle()));
+	const size_t nMask = m_vSlots.size() - 1;
+	size_t       nHole = FindSlot(rWnd.Handle());
+
+	ASSERT(m_vSlots[nHole].m_hWnd == rWnd.Handle());
+
+	if (m_vSlots[nHole].m_hWnd == NULL)
+		return;
+
+	// Shift back any following entries that would no longer be reachable
+	// from their home slot, rather than leaving a tombstone.
+	for (size_t nNext = (nHole + 1) & nMask; m_vSlots[nNext].m_hWnd != NULL; nNext = (nNext + 1) & nMask)
+	{
+		size_t nHome = Hash(m_vSlots[nNext].m_hWnd) & nMask;
+
+		// Is the home slot cyclically within (hole, next]?
+		bool bReachable = (nHole <= nNext) ? ((nHole < nHome) && (nHome <= nNext))
+		                                   : ((nHole < nHome) || (nHome <= nNext));
+
+		if (!bReachable)
+		{
+			m_vSlots[nHole] = m_vSlots[nNext];
+			nHole = nNext;
+		}
+	}
+
+	m_vSlots[nHole].m_hWnd = NULL;
+	m_vSlots[nHole].m_pWnd = nullptr;
+
+	--m_nCount;
 }
 
 /******************************************************************************
@@ -101,7 +146,95 @@ CWnd* CWndMap::Find(HWND hWnd) const
 {
 	ASSERT(hWnd != NULL);
 
-	Map::const_iterator it = m_oMap.find(hWnd);
+	size_t nSlot = m_nLastSlot;
+
+	// Same window as last time?
+	if (m_vSlots[nSlot].m_hWnd == hWnd)
+		return m_vSlots[nSlot].m_pWnd;
+
+	nSlot = FindSlot(hWnd);
+
+	if (m_vSlots[nSlot].m_hWnd == NULL)
+		return nullptr;
+
+	m_nLastSlot = nSlot;
+
+	return m_vSlots[nSlot].m_pWnd;
+}
+
+/******************************************************************************
+** Method:		FindSlot()
+**
+** Description:	Finds the slot which contains the window or, if the window is
+**				not in the table, the empty slot where it would be added.
+**
+** Parameters:	hWnd	The window to find.
+**
+** Returns:		The slot index.
+**
+*******************************************************************************
+*/
+
+size_t CWndMap::FindSlot(HWND hWnd) const
+{
+	const size_t nMask = m_vSlots.size() - 1;
+	size_t       nSlot = Hash(hWnd) & nMask;
+
+	// The table is never full, so an empty slot will always be found.
+	while ( (m_vSlots[nSlot].m_hWnd != hWnd) && (m_vSlots[nSlot].m_hWnd != NULL) )
+		nSlot = (nSlot + 1) & nMask;
+
+	return nSlot;
+}
+
+/******************************************************************************
+** Method:		Grow()
+**
+** Description:	Doubles the size of the table and re-adds all the windows.
+**
+** Parameters:	None.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CWndMap::Grow()
+{
+	Slots vOldSlots(m_vSlots.size() * 2);
+
+	vOldSlots.swap(m_vSlots);
+
+	for (Slots::const_iterator it = vOldSlots.begin(); it != vOldSlots.end(); ++it)
+	{
+		if (it->m_hWnd != NULL)
+			m_vSlots[FindSlot(it->m_hWnd)] = *it;
+	}
+
+	m_nLastSlot = 0;
+}
+
+/******************************************************************************
+** Method:		Hash()
+**
+** Description:	Calculates the hash value for a window handle. Handle values
+**				are not evenly distributed in their low bits so they are mixed
+**				before being used as a slot index.
+**
+** Parameters:	hWnd	The window handle.
+**
+** Returns:		The hash value.
+**
+*******************************************************************************
+*/
+
+size_t CWndMap::Hash(HWND hWnd)
+{
+	size_t nValue = reinterpret_cast<size_t>(hWnd);
+
+	nValue ^= (nValue >> 16);
+	nValue *= 0x45D9F3B;
+	nValue ^= (nValue >> 16);
 
-	return (it != m_oMap.end()) ? it->second : nullptr;
+	return nValue;
 }
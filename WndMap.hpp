@@ -16,7 +16,7 @@
 #pragma once
 #endif
 
-#include <map>
+#include <vector>
 
 // Forward declarations.
 class CWnd;
@@ -26,6 +26,12 @@ class CWnd;
 ** This is the map used to link window handles to their objects.
 ** NB: This used to be based on the WCL HandleMap class.
 **
+** It is an open-addressed hash table, using linear probing, as it is searched
+** for nearly every message dispatched. The slot of the last window found is
+** also cached as consecutive messages are often for the same window. Only the
+** index is cached, and checked before use, so that concurrent searches from
+** different UI threads remain safe.
+**
 *******************************************************************************
 */
 
@@ -41,18 +47,36 @@ public:
 	//
 	// Methods.
 	//
-	void  Add(CWnd& rWnd);
-	void  Remove(CWnd& rWnd);
-	CWnd* Find(HWND hWnd) const;
+	void   Add(CWnd& rWnd);
+	void   Remove(CWnd& rWnd);
+	CWnd*  Find(HWND hWnd) const;
+	size_t Size() const;
 
 private:
+	//! A slot in the hash table.
+	struct Slot
+	{
+		HWND	m_hWnd;		//!< The window handle or NULL, if empty.
+		CWnd*	m_pWnd;		//!< The window object.
+	};
+
 	// Type shorthands.
-	typedef std::map<HWND, CWnd*> Map;
+	typedef std::vector<Slot> Slots;
 
 	//
 	// Members.
 	//
-	Map	m_oMap;		//!< The underlying container.
+	Slots			m_vSlots;		//!< The hash table.
+	size_t			m_nCount;		//!< The number of windows in the table.
+	mutable size_t	m_nLastSlot;	//!< The slot of the last window found.
+
+	//
+	// Internal methods.
+	//
+	size_t FindSlot(HWND hWnd) const;
+	void   Grow();
+
+	static size_t Hash(HWND hWnd);
 };
 
 /******************************************************************************
@@ -62,4 +86,9 @@ private:
 *******************************************************************************
 */
 
+inline size_t CWndMap::Size() const
+{
+	return m_nCount;
+}
+
 #endif //WNDMAP_HPP
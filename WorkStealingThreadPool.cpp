@@ -0,0 +1,636 @@
+/******************************************************************************
+** (C) Chris Oldwood
+**
+** MODULE:		WORKSTEALINGTHREADPOOL.CPP
+** COMPONENT:	Windows C++ Library
+** DESCRIPTION:	CWorkStealingThreadPool class definition.
+**
+*******************************************************************************
+*/
+
+#include "Common.hpp"
+#include "WorkStealingThreadPool.hpp"
+#include "AutoThreadLock.hpp"
+#include "SeTranslator.hpp"
+#include "Exception.hpp"
+#include <deque>
+
+/******************************************************************************
+**
+** A worker thread and its queue of jobs. The owning thread takes the newest
+** job from the back of the queue, other threads steal the oldest job from the
+** front.
+**
+*******************************************************************************
+*/
+
+struct CWorkStealingThreadPool::Worker
+{
+	//! Constructor.
+	Worker(CWorkStealingThreadPool& oPool)
+		: m_oPool(oPool)
+		, m_hThread(NULL)
+		, m_dwID(0)
+		, m_oLock()
+		, m_oQueue()
+	{
+	}
+
+	//! Destructor.
+	~Worker()
+	{
+		if (m_hThread != NULL)
+			::CloseHandle(m_hThread);
+	}
+
+	//
+	// Members.
+	//
+	CWorkStealingThreadPool&	m_oPool;	// The owning thread pool.
+	HANDLE						m_hThread;	// The thread handle.
+	DWORD						m_dwID;		// The thread ID.
+	CCriticalSection			m_oLock;	// The lock for the job queue.
+	std::deque<ThreadJobPtr>	m_oQueue;	// The queued jobs.
+
+private:
+	// NotCopyable.
+	Worker(const Worker&);
+	Worker& operator=(const Worker&);
+};
+
+/******************************************************************************
+** Method:		Constructor.
+**
+** Description:	.
+**
+** Parameters:	nThreads	The number of threads in the pool.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+CWorkStealingThreadPool::CWorkStealingThreadPool(size_t nThreads)
+	: m_nThreads(nThreads)
+	, m_eStatus(STOPPED)
+	, m_oWorkers()
+	, m_hJobsQueued(NULL)
+	, m_dwTlsIndex(TLS_OUT_OF_INDEXES)
+	, m_nNextWorker(0)
+	, m_nPending(0)
+	, m_nRunning(0)
+	, m_bStopping(FALSE)
+	, m_oCompletedQ()
+	, m_oCompletedLock()
+{
+	ASSERT(m_nThreads > 0);
+}
+
+/******************************************************************************
+** Method:		Destructor.
+**
+** Description:	.
+**
+** Parameters:	None.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+CWorkStealingThreadPool::~CWorkStealingThreadPool()
+{
+	ASSERT(m_eStatus == STOPPED);
+	ASSERT(m_nPending == 0);
+	ASSERT(m_nRunning == 0);
+	ASSERT(m_oCompletedQ.empty());
+
+	// Free thread pool.
+	m_oWorkers.clear();
+}
+
+/******************************************************************************
+** Method:		Start()
+**
+** Description:	Start the thread pool running.
+**
+** Parameters:	None.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CWorkStealingThreadPool::Start()
+{
+	ASSERT(m_oWorkers.empty());
+	ASSERT(m_eStatus == STOPPED);
+
+	m_hJobsQueued = ::CreateSemaphore(NULL, 0, MAXLONG, NULL);
+	m_dwTlsIndex  = ::TlsAlloc();
+	m_bStopping   = FALSE;
+
+	ASSERT(m_hJobsQueued != NULL);
+	ASSERT(m_dwTlsIndex != TLS_OUT_OF_INDEXES);
+
+	// Create the thread pool.
+	for (size_t i = 0; i < m_nThreads; ++i)
+		m_oWorkers.push_back(WorkerPtr(new Worker(*this)));
+
+	// Start the pool threads.
+	for (size_t i = 0; i < m_nThreads; ++i)
+	{
+		Worker& oWorker = *m_oWorkers[i];
+
+		oWorker.m_hThread = ::CreateThread(NULL, 0, ThreadFunction, &oWorker, 0, &oWorker.m_dwID);
+
+		ASSERT(oWorker.m_hThread != NULL);
+	}
+
+	m_eStatus = RUNNING;
+}
+
+/******************************************************************************
+** Method:		Stop()
+**
+** Description:	Stop the thread pool running. Any jobs already running are
+**				left to complete and any jobs still queued are cancelled and
+**				moved to the completed queue.
+**
+** Parameters:	None.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CWorkStealingThreadPool::Stop()
+{
+	ASSERT(!m_oWorkers.empty());
+	ASSERT(m_eStatus == RUNNING);
+
+	// Signal the pool threads to terminate.
+	::InterlockedExchange(&m_bStopping, TRUE);
+	::ReleaseSemaphore(m_hJobsQueued, static_cast<LONG>(m_nThreads), NULL);
+
+	// Wait until they have stopped.
+	for (size_t i = 0; i < m_nThreads; ++i)
+		::WaitForSingleObject(m_oWorkers[i]->m_hThread, INFINITE);
+
+	// Template shorthands.
+	typedef std::deque<ThreadJobPtr>::iterator CIter;
+
+	// Cancel any jobs left in the queues.
+	for (size_t i = 0; i < m_nThreads; ++i)
+	{
+		std::deque<ThreadJobPtr>& oQueue = m_oWorkers[i]->m_oQueue;
+
+		for (CIter oIter = oQueue.begin(); oIter != oQueue.end(); ++oIter)
+		{
+			ThreadJobPtr& pJob = *oIter;
+
+			// Already cancelled through the pool?
+			if (pJob.get() == nullptr)
+				continue;
+
+			if (pJob->ChangeStatus(CThreadJob::PENDING, CThreadJob::CANCELLED))
+			{
+				OnJobCancelled(pJob);
+				pJob->OnFinished();
+			}
+			else
+			{
+				// Cancelled directly on the job.
+				OnJobCancelled(pJob);
+			}
+		}
+
+		oQueue.clear();
+	}
+
+	::InterlockedExchange(&m_nPending, 0);
+
+	::CloseHandle(m_hJobsQueued);
+	::TlsFree(m_dwTlsIndex);
+
+	m_hJobsQueued = NULL;
+	m_dwTlsIndex  = TLS_OUT_OF_INDEXES;
+	m_eStatus     = STOPPED;
+}
+
+/******************************************************************************
+** Method:		AddJob()
+**
+** Description:	Add a new job to be run in the pool. A job added by one of the
+**				pool threads is queued on that thread, otherwise the jobs are
+**				distributed across the threads in turn.
+**
+** Parameters:	pJob	The job to add.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CWorkStealingThreadPool::AddJob(ThreadJobPtr& pJob)
+{
+	ASSERT(pJob.get() != nullptr);
+	ASSERT(pJob->Status() == CThreadJob::PENDING);
+	ASSERT(m_eStatus == RUNNING);
+
+	Worker* pWorker = static_cast<Worker*>(::TlsGetValue(m_dwTlsIndex));
+
+	// Not called from a pool thread?
+	if (pWorker == nullptr)
+	{
+		ulong nNext = static_cast<ulong>(::InterlockedIncrement(&m_nNextWorker));
+
+		pWorker = m_oWorkers[nNext % m_nThreads].get();
+	}
+
+	::InterlockedIncrement(&m_nPending);
+
+	// Add to the worker's queue.
+	{
+		CAutoThreadLock oAutoLock(pWorker->m_oLock);
+
+		pWorker->m_oQueue.push_back(pJob);
+	}
+
+	// Wake a thread to run it.
+	::ReleaseSemaphore(m_hJobsQueued, 1, NULL);
+}
+
+/******************************************************************************
+** Method:		CancelJob()
+**
+** Description:	Cancel the specified job, if it is still queued. A running job
+**				is left to complete. This searches each worker's queue, so it
+**				is linear in the number of queued jobs.
+**
+** Parameters:	pJob	The job to cancel.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CWorkStealingThreadPool::CancelJob(ThreadJobPtr& pJob)
+{
+	ASSERT(pJob.get() != nullptr);
+	ASSERT(m_eStatus == RUNNING);
+
+	// Template shorthands.
+	typedef std::deque<ThreadJobPtr>::iterator CIter;
+
+	for (size_t i = 0; i < m_nThreads; ++i)
+	{
+		Worker& oWorker = *m_oWorkers[i];
+
+		CAutoThreadLock oAutoLock(oWorker.m_oLock);
+
+		for (CIter oIter = oWorker.m_oQueue.begin(); oIter != oWorker.m_oQueue.end(); ++oIter)
+		{
+			if (oIter->get() == pJob.get())
+			{
+				CancelQueuedJob(*oIter);
+				return;
+			}
+		}
+	}
+}
+
+/******************************************************************************
+** Method:		CancelAllJobs()
+**
+** Description:	Cancel all jobs assigned to the pool.
+**
+** Parameters:	None.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CWorkStealingThreadPool::CancelAllJobs()
+{
+	ASSERT(m_eStatus == RUNNING);
+
+	// Template shorthands.
+	typedef std::deque<ThreadJobPtr>::iterator CIter;
+
+	for (size_t i = 0; i < m_nThreads; ++i)
+	{
+		Worker& oWorker = *m_oWorkers[i];
+
+		CAutoThreadLock oAutoLock(oWorker.m_oLock);
+
+		// Cancel all pending jobs in this queue.
+		for (CIter oIter = oWorker.m_oQueue.begin(); oIter != oWorker.m_oQueue.end(); ++oIter)
+		{
+			if (oIter->get() != nullptr)
+				CancelQueuedJob(*oIter);
+		}
+	}
+}
+
+/******************************************************************************
+** Method:		ClearCompletedJobs()
+**
+** Description:	Remove all jobs from the completed job queue.
+**
+** Parameters:	None.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CWorkStealingThreadPool::ClearCompletedJobs()
+{
+	CAutoThreadLock oAutoLock(m_oCompletedLock);
+
+	m_oCompletedQ.clear();
+}
+
+/******************************************************************************
+** Method:		DeleteCompletedJobs()
+**
+** Description:	Delete all jobs in the completed job queue.
+**
+** Parameters:	None.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CWorkStealingThreadPool::DeleteCompletedJobs()
+{
+	CAutoThreadLock oAutoLock(m_oCompletedLock);
+
+	m_oCompletedQ.clear();
+}
+
+/******************************************************************************
+** Method:		TakeJob()
+**
+** Description:	Remove the next job from the worker's own queue or, if that is
+**				empty, steal one from another worker. The caller must have
+**				already acquired a count on the semaphore, which guarantees
+**				that a job is queued somewhere.
+**
+** Parameters:	oWorker		The worker taking the job.
+**				pJob		The returned job.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CWorkStealingThreadPool::TakeJob(Worker& oWorker, ThreadJobPtr& pJob)
+{
+	for (;;)
+	{
+		// Try our own queue, newest first.
+		{
+			CAutoThreadLock oAutoLock(oWorker.m_oLock);
+
+			if (!oWorker.m_oQueue.empty())
+			{
+				pJob = oWorker.m_oQueue.back();
+				oWorker.m_oQueue.pop_back();
+				return;
+			}
+		}
+
+		// Steal from the other queues, oldest first.
+		for (size_t i = 0; i < m_nThreads; ++i)
+		{
+			Worker& oVictim = *m_oWorkers[i];
+
+			if (&oVictim == &oWorker)
+				continue;
+
+			CAutoThreadLock oAutoLock(oVictim.m_oLock);
+
+			if (!oVictim.m_oQueue.empty())
+			{
+				pJob = oVictim.m_oQueue.front();
+				oVictim.m_oQueue.pop_front();
+				return;
+			}
+		}
+
+		// Lost a race with a concurrent steal, let it finish.
+		::SwitchToThread();
+	}
+}
+
+#if (__GNUC__ >= 8) // GCC 8+
+// error: format '%hs' expects argument of type 'short int*', but argument 3 has type 'const char*' [-Werror=format=]
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat"
+#endif
+
+/******************************************************************************
+** Method:		RunJob()
+**
+** Description:	Run a job on the current thread.
+**
+** Parameters:	pJob	The job to run.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CWorkStealingThreadPool::RunJob(ThreadJobPtr& pJob)
+{
+	ASSERT(pJob->Status() == CThreadJob::RUNNING);
+
+	try
+	{
+		// Run it.
+		pJob->Run();
+	}
+	catch (const Core::Exception& e)
+	{
+		WCL::ReportUnhandledException(TXT("Unexpected exception caught in CWorkStealingThreadPool::RunJob()\n\n%s"), e.twhat());
+	}
+	catch (const std::exception& e)
+	{
+		WCL::ReportUnhandledException(TXT("Unexpected exception caught in CWorkStealingThreadPool::RunJob()\n\n%hs"), e.what());
+	}
+	catch (...)
+	{
+		WCL::ReportUnhandledException(TXT("Unexpected unknown exception caught in CWorkStealingThreadPool::RunJob()"));
+	}
+
+	// Update job state.
+	pJob->Status(CThreadJob::COMPLETED);
+
+	OnJobCompleted(pJob);
+
+	// Release waiters and queue continuations.
+	pJob->OnFinished();
+}
+
+#if (__GNUC__ >= 8) // GCC 8+
+#pragma GCC diagnostic pop
+#endif
+
+/******************************************************************************
+** Method:		OnJobCompleted()
+**
+** Description:	Move a job that has finished running to the completed queue.
+**
+** Parameters:	pJob	The job completed.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CWorkStealingThreadPool::OnJobCompleted(ThreadJobPtr& pJob)
+{
+	ASSERT(pJob->Status() == CThreadJob::COMPLETED);
+
+	::InterlockedDecrement(&m_nRunning);
+
+	CAutoThreadLock oAutoLock(m_oCompletedLock);
+
+	m_oCompletedQ.push_back(pJob);
+}
+
+/******************************************************************************
+** Method:		CancelQueuedJob()
+**
+** Description:	Cancel a job that is still in a worker's queue, if it is still
+**				pending. The job is removed from its slot, which is left empty
+**				for the thread that dequeues it to skip. The caller must hold
+**				the lock for the queue.
+**
+** Parameters:	pQueued		The queue slot holding the job.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CWorkStealingThreadPool::CancelQueuedJob(ThreadJobPtr& pQueued)
+{
+	ThreadJobPtr pJob = pQueued;
+
+	if (pJob->ChangeStatus(CThreadJob::PENDING, CThreadJob::CANCELLED))
+	{
+		pQueued.reset();
+
+		OnJobCancelled(pJob);
+		pJob->OnFinished();
+	}
+}
+
+/******************************************************************************
+** Method:		OnJobCancelled()
+**
+** Description:	Move a job that was cancelled whilst queued to the completed
+**				queue.
+**
+** Parameters:	pJob	The job cancelled.
+**
+** Returns:		Nothing.
+**
+*******************************************************************************
+*/
+
+void CWorkStealingThreadPool::OnJobCancelled(ThreadJobPtr& pJob)
+{
+	ASSERT(pJob->Status() == CThreadJob::CANCELLED);
+
+	::InterlockedDecrement(&m_nPending);
+
+	CAutoThreadLock oAutoLock(m_oCompletedLock);
+
+	m_oCompletedQ.push_back(pJob);
+}
+
+#if (__GNUC__ >= 8) // GCC 8+
+// error: format '%hs' expects argument of type 'short int*', but argument 3 has type 'const char*' [-Werror=format=]
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat"
+#endif
+
+/******************************************************************************
+** Method:		ThreadFunction()
+**
+** Description:	The main function for the worker threads.
+**
+** Parameters:	lpParam		The Worker object.
+**
+** Returns:		0.
+**
+*******************************************************************************
+*/
+
+DWORD WINAPI CWorkStealingThreadPool::ThreadFunction(LPVOID lpParam)
+{
+	// Translate structured exceptions.
+	WCL::SeTranslator::Install();
+
+	Worker&                  oWorker = *static_cast<Worker*>(lpParam);
+	CWorkStealingThreadPool& oPool   = oWorker.m_oPool;
+
+	::TlsSetValue(oPool.m_dwTlsIndex, &oWorker);
+
+	try
+	{
+		for (;;)
+		{
+			// Wait for a job to be queued.
+			::WaitForSingleObject(oPool.m_hJobsQueued, INFINITE);
+
+			if (oPool.m_bStopping)
+				break;
+
+			ThreadJobPtr pJob;
+
+			oPool.TakeJob(oWorker, pJob);
+
+			// Cancelled through the pool whilst queued?
+			if (pJob.get() == nullptr)
+				continue;
+
+			if (pJob->ChangeStatus(CThreadJob::PENDING, CThreadJob::RUNNING))
+			{
+				::InterlockedIncrement(&oPool.m_nRunning);
+				::InterlockedDecrement(&oPool.m_nPending);
+
+				oPool.RunJob(pJob);
+			}
+			else
+			{
+				// Cancelled directly on the job whilst queued.
+				oPool.OnJobCancelled(pJob);
+			}
+		}
+	}
+	catch (const Core::Exception& e)
+	{
+		WCL::ReportUnhandledException(TXT("Unexpected exception caught in CWorkStealingThreadPool::ThreadFunction()\n\n%s"), e.twhat());
+	}
+	catch (const std::exception& e)
+	{
+		WCL::ReportUnhandledException(TXT("Unexpected exception caught in CWorkStealingThreadPool::ThreadFunction()\n\n%hs"), e.what());
+	}
+	catch (...)
+	{
+		WCL::ReportUnhandledException(TXT("Unexpected unknown exception caught in CWorkStealingThreadPool::ThreadFunction()"));
+	}
+
+	return 0;
+}
+
+#if (__GNUC__ >= 8) // GCC 8+
+#pragma GCC diagnostic pop
+#endif
@@ -0,0 +1,136 @@
+/******************************************************************************
+** (C) Chris Oldwood
+**
+** MODULE:		WORKSTEALINGTHREADPOOL.HPP
+** COMPONENT:	Windows C++ Library
+** DESCRIPTION:	The CWorkStealingThreadPool class declaration.
+**
+*******************************************************************************
+*/
+
+// Check for previous inclusion
+#ifndef WORKSTEALINGTHREADPOOL_HPP
+#define WORKSTEALINGTHREADPOOL_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "CriticalSection.hpp"
+#include "ThreadJob.hpp"
+#include <vector>
+
+/******************************************************************************
+**
+** A pool of worker threads which run thread jobs. Unlike CThreadPool each
+** worker has its own job queue, so there is no single lock shared by all
+** threads. Jobs added by a worker go on its own queue and idle workers steal
+** the oldest jobs from the other queues.
+**
+*******************************************************************************
+*/
+
+class CWorkStealingThreadPool
+{
+public:
+	//
+	// Constructors/Destructor.
+	//
+	CWorkStealingThreadPool(size_t nThreads);
+	~CWorkStealingThreadPool();
+
+	//
+	// Control Methods.
+	//
+	void Start();
+	void Stop();
+
+	//
+	// Job Methods.
+	//
+	void AddJob(ThreadJobPtr& pJob);
+	void CancelJob(ThreadJobPtr& pJob);
+	void CancelAllJobs();
+
+	void ClearCompletedJobs();
+	void DeleteCompletedJobs();
+
+	//
+	// Queue accessors.
+	//
+	size_t PendingJobCount() const;
+	size_t RunningJobCount() const;
+	size_t CompletedJobCount() const;
+
+protected:
+	// Forward declarations.
+	struct Worker;
+
+	// Template shorthands.
+	typedef Core::SharedPtr<Worker> WorkerPtr;
+	typedef std::vector<WorkerPtr> CWorkers;
+	typedef std::vector<ThreadJobPtr> CJobQueue;
+
+	// Thread pool status.
+	enum Status
+	{
+		STOPPED,
+		RUNNING,
+	};
+
+	//
+	// Members.
+	//
+	size_t				m_nThreads;			// The number of worker threads.
+	Status				m_eStatus;			// The pool status.
+	CWorkers			m_oWorkers;			// The worker threads and their queues.
+	HANDLE				m_hJobsQueued;		// Semaphore counting the queued jobs.
+	DWORD				m_dwTlsIndex;		// TLS slot holding the current Worker.
+	volatile LONG		m_nNextWorker;		// Round-robin counter for external jobs.
+	volatile LONG		m_nPending;			// The number of pending jobs.
+	volatile LONG		m_nRunning;			// The number of running jobs.
+	volatile LONG		m_bStopping;		// Signals the workers to exit.
+	CJobQueue			m_oCompletedQ;		// The completed and cancelled jobs.
+	CCriticalSection	m_oCompletedLock;	// The lock for the completed queue.
+
+	//
+	// Internal methods.
+	//
+	void TakeJob(Worker& oWorker, ThreadJobPtr& pJob);
+	void RunJob(ThreadJobPtr& pJob);
+	void OnJobCompleted(ThreadJobPtr& pJob);
+	void CancelQueuedJob(ThreadJobPtr& pQueued);
+	void OnJobCancelled(ThreadJobPtr& pJob);
+
+	// The worker thread function.
+	static DWORD WINAPI ThreadFunction(LPVOID lpParam);
+
+private:
+	// NotCopyable.
+	CWorkStealingThreadPool(const CWorkStealingThreadPool&);
+	CWorkStealingThreadPool& operator=(const CWorkStealingThreadPool&);
+};
+
+/******************************************************************************
+**
+** Implementation of inline functions.
+**
+*******************************************************************************
+*/
+
+inline size_t CWorkStealingThreadPool::PendingJobCount() const
+{
+	return m_nPending;
+}
+
+inline size_t CWorkStealingThreadPool::RunningJobCount() const
+{
+	return m_nRunning;
+}
+
+inline size_t CWorkStealingThreadPool::CompletedJobCount() const
+{
+	return m_oCompletedQ.size();
+}
+
+#endif // WORKSTEALINGTHREADPOOL_HPP